@@ -1,1418 +1,6715 @@
-#include "pokemon.h"
-#include <ctype.h>
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-
-# define INT_BUFFER 128
-
-// ================================================
-// Basic struct definitions from ex6.h assumed:
-//   PokemonData { int id; char *name; PokemonType TYPE; int hp; int attack; EvolutionStatus CAN_EVOLVE; }
-//   PokemonNode { PokemonData* data; PokemonNode* left, *right; }
-//   OwnerNode   { char* ownerName; PokemonNode* pokedexRoot; OwnerNode *next, *prev; }
-//   OwnerNode* ownerHead;
-//   const PokemonData pokedex[];
-// ================================================
-
-// --------------------------------------------------------------
-// 1) Safe integer reading & String Manipulation
-//    Helper functions to ensure robust user input and memory safety.
-// --------------------------------------------------------------
-
-/**
- * Removes leading and trailing whitespace characters from a string.
- * Modifies the string in-place.
- */
-void trimWhitespace(char *str)
-{
-    // Remove leading spaces/tabs/\r
-    int start = 0;
-    while (str[start] == ' ' || str[start] == '\t' || str[start] == '\r')
-        start++;
-
-    if (start > 0)
-    {
-        int idx = 0;
-        while (str[start])
-            str[idx++] = str[start++];
-        str[idx] = '\0';
-    }
-
-    // Remove trailing spaces/tabs/\r
-    int len = (int)strlen(str);
-    while (len > 0 && (str[len - 1] == ' ' || str[len - 1] == '\t' || str[len - 1] == '\r'))
-    {
-        str[--len] = '\0';
-    }
-}
-
-/**
- * Custom implementation of strdup to ensure cross-platform compatibility
- * and safe memory allocation checks.
- */
-char *myStrdup(const char *src)
-{
-    if (!src)
-        return NULL;
-    size_t len = strlen(src);
-    char *dest = (char *)malloc(len + 1);
-    if (!dest)
-    {
-        printf("Memory allocation failed in mymyStrdup.\n");
-        return NULL;
-    }
-    strcpy(dest, src);
-    return dest;
-}
-
-/**
- * Reads an integer from stdin safely, preventing buffer overflows and handling invalid inputs.
- * Uses a buffer to read the line and strtol for conversion.
- */
-int readIntSafe(const char *prompt)
-{
-    char buffer[INT_BUFFER];
-    int value;
-    int success = 0;
-
-    while (!success)
-    {
-        printf("%s", prompt);
-
-        // If we fail to read, treat it as invalid
-        if (!fgets(buffer, sizeof(buffer), stdin))
-        {
-            printf("Invalid input.\n");
-            clearerr(stdin);
-            continue;
-        }
-
-        // 1) Strip any trailing \r or \n
-        //    so "123\r\n" becomes "123"
-        size_t len = strlen(buffer);
-        if (len > 0 && (buffer[len - 1] == '\n' || buffer[len - 1] == '\r'))
-            buffer[--len] = '\0';
-        if (len > 0 && (buffer[len - 1] == '\r' || buffer[len - 1] == '\n'))
-            buffer[--len] = '\0';
-
-        // 2) Check if empty after stripping
-        if (len == 0)
-        {
-            printf("Invalid input.\n");
-            continue;
-        }
-
-        // 3) Attempt to parse integer with strtol
-        char *endptr;
-        value = (int)strtol(buffer, &endptr, 10);
-
-        // If endptr didn't point to the end => leftover chars => invalid
-        // or if buffer was something non-numeric
-        if (*endptr != '\0')
-        {
-            printf("Invalid input.\n");
-        }
-        else
-        {
-            // We got a valid integer
-            success = 1;
-        }
-    }
-    return value;
-}
-
-// --------------------------------------------------------------
-// 2) Utility: Get type name from enum
-// --------------------------------------------------------------
-const char *getTypeName(PokemonType type)
-{
-    switch (type)
-    {
-    case GRASS:
-        return "GRASS";
-    case FIRE:
-        return "FIRE";
-    case WATER:
-        return "WATER";
-    case BUG:
-        return "BUG";
-    case NORMAL:
-        return "NORMAL";
-    case POISON:
-        return "POISON";
-    case ELECTRIC:
-        return "ELECTRIC";
-    case GROUND:
-        return "GROUND";
-    case FAIRY:
-        return "FAIRY";
-    case FIGHTING:
-        return "FIGHTING";
-    case PSYCHIC:
-        return "PSYCHIC";
-    case ROCK:
-        return "ROCK";
-    case GHOST:
-        return "GHOST";
-    case DRAGON:
-        return "DRAGON";
-    case ICE:
-        return "ICE";
-    default:
-        return "UNKNOWN";
-    }
-}
-
-// --------------------------------------------------------------
-// Utility: getDynamicInput (for reading a line into malloc'd memory)
-// Dynamically reallocates memory as needed to handle inputs of any length.
-// --------------------------------------------------------------
-char *getDynamicInput()
-{
-    char *input = NULL;
-    size_t size = 0, capacity = 1;
-    input = (char *)malloc(capacity);
-    if (!input)
-    {
-        printf("Memory allocation failed.\n");
-        return NULL;
-    }
-
-    int c;
-    while ((c = getchar()) != '\n' && c != EOF)
-    {
-        if (size + 1 >= capacity)
-        {
-            capacity *= 2;
-            char *temp = (char *)realloc(input, capacity);
-            if (!temp)
-            {
-                printf("Memory reallocation failed.\n");
-                free(input);
-                return NULL;
-            }
-            input = temp;
-        }
-        input[size++] = (char)c;
-    }
-    input[size] = '\0';
-
-    // Trim any leading/trailing whitespace or carriage returns
-    trimWhitespace(input);
-
-    return input;
-}
-
-// Function to print a single Pokemon node
-void printPokemonNode(PokemonNode *node)
-{
-    if (!node)
-        return;
-    printf("ID: %d, Name: %s, Type: %s, HP: %d, Attack: %d, Can Evolve: %s\n",
-           node->data->id,
-           node->data->name,
-           getTypeName(node->data->TYPE),
-           node->data->hp,
-           node->data->attack,
-           (node->data->CAN_EVOLVE == CAN_EVOLVE) ? "Yes" : "No");
-}
-
-// --------------------------------------------------------------
-// Display Menu & Tree Traversals
-// Implements various tree traversal algorithms (BFS, DFS variations).
-// --------------------------------------------------------------
-void displayMenu(OwnerNode *owner)
-{
-    if (!owner->pokedexRoot)
-    {
-        printf("Pokedex is empty.\n");
-        return;
-    }
-
-    printf("Display:\n");
-    printf("1. BFS (Level-Order)\n");
-    printf("2. Pre-Order\n");
-    printf("3. In-Order\n");
-    printf("4. Post-Order\n");
-    printf("5. Alphabetical (by name)\n");
-
-    int choice = readIntSafe("Your choice: ");
-
-    switch (choice)
-    {
-    case 1:
-        displayBFS(owner->pokedexRoot);
-        break;
-    case 2:
-    if(owner->pokedexRoot== NULL)
-    {
-         printf("Pokedex is empty.\n");
-    }
-    else
-    {
-        preOrderTraversal(owner->pokedexRoot);
-    }
-        break;
-    case 3:
-    if(owner->pokedexRoot== NULL)
-    {
-         printf("Pokedex is empty.\n");
-    }
-    else
-    {
-        inOrderTraversal(owner->pokedexRoot);
-    }
-        break;
-    case 4:
-    if(owner->pokedexRoot== NULL)
-    {
-         printf("Pokedex is empty.\n");
-    }
-    else
-    {
-        postOrderTraversal(owner->pokedexRoot);
-    }
-        break;
-    case 5:
-    if(owner->pokedexRoot== NULL)
-    {
-         printf("Pokedex is empty.\n");
-    }
-    else
-    {
-        displayAlphabetical(owner->pokedexRoot);
-    }
-        break;
-    default:
-        printf("Invalid choice.\n");
-    }
-}
-
-
-/**
- * BFS Search Implementation.
- * Uses a manually allocated queue to traverse the BST level by level
- * to find a Pokemon by ID.
- * @param root The root of the BST.
- * @param id The ID to search for.
- * @return Pointer to the found PokemonNode or NULL.
- */
-PokemonNode *searchPokemonBFS(PokemonNode *root, int id)
-{
-    
-    if (root == NULL)
-    {
-        return NULL;
-    }
-
-    // Create a queue for BFS
-    PokemonNode **queue = (PokemonNode **)malloc(sizeof(PokemonNode *) * 151); // Adjust size as needed
-    if (queue == NULL)
-    {
-        fprintf(stderr, "Memory allocation failed for BFS queue.\n");
-        exit(EXIT_FAILURE);
-    }
-
-    int front = 0, rear = 0;
-
-    // Enqueue the root node
-    queue[rear++] = root;
-
-    while (front < rear)
-    {
-        // Dequeue a node
-        PokemonNode *current = queue[front++];
-
-        // Check if the current node's ID matches the target ID
-        if (current->data->id == id)
-        {
-            free(queue); // Free allocated memory before returning
-            return current;
-        }
-
-        // Enqueue left child if it exists
-        if (current->left != NULL)
-        {
-            queue[rear++] = current->left;
-        }
-
-        // Enqueue right child if it exists
-        if (current->right != NULL)
-        {
-            queue[rear++] = current->right;
-        }
-    }
-
-    // Free allocated memory
-    free(queue);
-
-    // If we reach here, the ID was not found
-    return NULL;
-
-}
-
-/**
- * Standard Breadth-First Search traversal to display nodes.
- */
-void displayBFS(PokemonNode* root)
-{
-    if (root == NULL) 
-    {
-        printf("Pokedex is empty.\n");
-        return;
-    }
-    PokemonNode **queue = (PokemonNode **)malloc(sizeof(PokemonNode *) * 1000); // Adjust size as needed
-    if (queue == NULL)
-    {
-        fprintf(stderr, "Memory allocation failed for BFS queue.\n");
-        exit(EXIT_FAILURE);
-    }
-
-    int front = 0, rear = 0;
-
-    // Enqueue the root node
-    queue[rear++] = root;
-
-    while (front < rear)
-    {
-        // Dequeue a node
-        PokemonNode *current = queue[front++];
-
-        // Print the current node
-        printPokemonNode(current);
-
-        // Enqueue left child if it exists
-        if (current->left != NULL)
-        {
-            queue[rear++] = current->left;
-        }
-
-        // Enqueue right child if it exists
-        if (current->right != NULL)
-        {
-            queue[rear++] = current->right;
-        }
-    }
-
-    // Free allocated memory
-    free(queue);
-    
-}
-
-// Recursive Pre-Order Traversal (Root -> Left -> Right)
-void preOrderTraversal(PokemonNode* root) 
-{
-     if (root == NULL)
-    {
-        return;
-    }
-
-    // Print the current node
-    printPokemonNode(root);
-
-    // Recursively traverse the left subtree
-    preOrderTraversal(root->left);
-
-    // Recursively traverse the right subtree
-    preOrderTraversal(root->right);
-}
-
-// Recursive In-Order Traversal (Left -> Root -> Right)
-void inOrderTraversal(PokemonNode* root) 
-{
-    if (root == NULL)
-    {
-        return;
-    }
-
-    // Recursively traverse the left subtree
-    inOrderTraversal(root->left);
-
-    // Print the current node
-    printPokemonNode(root);
-
-    // Recursively traverse the right subtree
-    inOrderTraversal(root->right);
-}
-
-// Recursive Post-Order Traversal (Left -> Right -> Root)
-void postOrderTraversal(PokemonNode* root) 
-{
-     if (root == NULL)
-    {
-        return;
-    }
-    // Recursively traverse the left subtree
-    postOrderTraversal(root->left);
-
-    // Recursively traverse the right subtree
-    postOrderTraversal(root->right);
-
-    // Print the current node
-    printPokemonNode(root);
-}
-
-/**
- * Displays Pokemon sorted alphabetically.
- * Strategy: Collects all nodes into an array using BFS, then uses QuickSort (qsort).
- */
-void displayAlphabetical(PokemonNode *root)
-{
-    if (root == NULL)
-    {
-        return;
-    }
-
-    // Create a queue for BFS
-    PokemonNode **queue = (PokemonNode **)malloc(sizeof(PokemonNode *) * 1000);
-    if (queue == NULL)
-    {
-        fprintf(stderr, "Memory allocation failed for BFS queue.\n");
-        exit(EXIT_FAILURE);
-    }
-
-    // Create an array to store the nodes for sorting
-    PokemonNode **nodes = (PokemonNode **)malloc(sizeof(PokemonNode *) * 1000);
-    if (nodes == NULL)
-    {
-        fprintf(stderr, "Memory allocation failed for nodes array.\n");
-        free(queue);
-        exit(EXIT_FAILURE);
-    }
-
-    int front = 0, rear = 0, count = 0;
-
-    // Enqueue the root node
-    queue[rear++] = root;
-
-    while (front < rear)
-    {
-        // Dequeue a node
-        PokemonNode *current = queue[front++];
-
-        // Add the current node to the array for sorting
-        nodes[count++] = current;
-
-        // Enqueue left child if it exists
-        if (current->left != NULL)
-        {
-            queue[rear++] = current->left;
-        }
-
-        // Enqueue right child if it exists
-        if (current->right != NULL)
-        {
-            queue[rear++] = current->right;
-        }
-    }
-
-    // Sort the nodes alphabetically by name
-    qsort(nodes, count, sizeof(PokemonNode *), compareByNameNode);
-
-    // Display the sorted nodes
-    for (int i = 0; i < count; i++)
-    {
-        printPokemonNode(nodes[i]);
-    }
-
-    // Free allocated memory
-    free(queue);
-    free(nodes);
-}
-
-// Comparator for sorting Pokémon by their names
-int compareByNameNode(const void *a, const void *b)
-{
-    PokemonNode *nodeA = *(PokemonNode **)a;
-    PokemonNode *nodeB = *(PokemonNode **)b;
-    return strcmp(nodeA->data->name, nodeB->data->name);
-}
-
-
-// --------------------------------------------------------------
-// Sub-menu for existing Pokedex
-// Handles operations for a specific owner in the circular list.
-// --------------------------------------------------------------
-void enterExistingPokedexMenu()
-{
-    if(ownerHead == NULL)
-    {
-        printf("No existing Pokedexes.\n");
-        return;
-    }
-
-    OwnerNode* cur = ownerHead; // Initialize cur to the start of the circular list
-    int i = 1;
-
-    // list owners
-    printf("\nExisting Pokedexes:\n");
-
-    // Traverse through the circular linked list
-    do {
-        printf("%d. %s\n", i, cur->ownerName);
-        i++;
-        cur = cur->next; // Move to the next owner
-    } while(cur != ownerHead);
-    // you need to implement a few things here :)
-    int choosingowner;
-    printf("Choose a Pokedex by number: ");
-    scanf("%d",&choosingowner);
-    getchar();
-    for(int i =1; i<choosingowner;i++)
-    {
-        cur = cur->next;
-    }
-    printf("\nEntering %s's Pokedex...\n", cur->ownerName);
-
-
-    int subChoice;
-    do
-    {
-        printf("\n-- %s's Pokedex Menu --\n", cur->ownerName);
-        printf("1. Add Pokemon\n");
-        printf("2. Display Pokedex\n");
-        printf("3. Release Pokemon (by ID)\n");
-        printf("4. Pokemon Fight!\n");
-        printf("5. Evolve Pokemon\n");
-        printf("6. Back to Main\n");
-
-        subChoice = readIntSafe("Your choice: ");
-
-        switch (subChoice)
-        {
-        case 1:
-            addPokemon(cur);
-            break;
-        case 2:
-            displayMenu(cur);
-            break;
-        case 3:
-            freePokemon(cur);
-            break;
-        case 4:
-            pokemonFight(cur);
-            break;
-        case 5:
-            evolvePokemon(cur);
-            break;
-        case 6:
-            printf("Back to Main Menu.\n");
-            break;
-        default:
-            printf("Invalid choice.\n");
-        }
-    } while (subChoice != 6);
-}
-
-/**
- * Adds a Pokemon to the BST.
- * Implements standard BST insertion logic:
- * - Smaller IDs go left
- * - Larger IDs go right
- * - No duplicates allowed
- */
-void addPokemon(OwnerNode* owner)
-{
-    if (owner == NULL) 
-    {
-        printf("Invalid owner.\n");
-        return;
-    }
-
-    int idofnewpokemon = readIntSafe("Enter ID to add: ");
-
-    // Check if the entered ID is valid
-    if (idofnewpokemon <= 0 || idofnewpokemon > 151) 
-    {
-        printf("Invalid Pokémon ID. Please enter a valid ID.\n");
-        return;
-    }
-
-    // Create a new Pokémon node
-    PokemonNode *newPokemonNode = createPokemonNode(&pokedex[idofnewpokemon - 1]);
-
-    // If the Pokedex root is NULL, set the new node as the root
-    if (owner->pokedexRoot == NULL) 
-    {
-        owner->pokedexRoot = newPokemonNode;
-        printf("Pokemon %s (ID %d) added.\n", newPokemonNode->data->name, idofnewpokemon);
-        return;
-    }
-
-    // Traverse the binary search tree to find the correct position for the new node
-    PokemonNode *cur = owner->pokedexRoot;
-    while (1) 
-    {
-        if (idofnewpokemon == cur->data->id) 
-        {
-            // If the Pokémon ID already exists, do not add it again
-            printf("Pokemon with ID %d is already in the Pokedex. No changes made.\n", idofnewpokemon);
-            free(newPokemonNode); // Free the unused new node
-            return;
-        } 
-        else if (idofnewpokemon < cur->data->id) 
-        {
-            if (cur->left == NULL) 
-            {
-                // Insert the new Pokémon node here if left is NULL
-                cur->left = newPokemonNode;
-                printf("Pokemon %s (ID %d) added.\n", newPokemonNode->data->name, idofnewpokemon);
-                return;
-            }
-            cur = cur->left;
-        } 
-        else 
-        {
-            if (cur->right == NULL) 
-            {
-                // Insert the new Pokémon node here if right is NULL
-                cur->right = newPokemonNode;
-                printf("Pokemon %s (ID %d) added.\n", newPokemonNode->data->name, idofnewpokemon);
-                return;
-            }
-            cur = cur->right;
-        }
-    }
-}
-
-
-void freePokemon(OwnerNode* owner) 
-{
-    if (owner->pokedexRoot == NULL) 
-    {
-        printf("No Pokemon to release.\n");
-        return;
-    }
-
-    int chosenid = readIntSafe("Enter Pokemon ID to release: ");
-
-    // Use BFS to search for the Pokémon
-    PokemonNode* foundPokemon = searchPokemonBFS(owner->pokedexRoot, chosenid);
-
-    if (foundPokemon == NULL) 
-    {
-        printf("Pokemon with ID %d not found in the Pokedex.\n", chosenid);
-        return;
-    }
-
-    // Delete the Pokémon node
-    owner->pokedexRoot = deletePokemonNode(owner->pokedexRoot, chosenid);
-    printf("Removing Pokemon %s (ID %d).\n", pokedex[chosenid - 1].name, chosenid);
-}
-
-// Helper: Finds the minimum value node in a BST (leftmost child)
-PokemonNode* findMin(PokemonNode* node) 
-{
-    while (node->left != NULL) 
-    {
-        node = node->left;
-    }
-    return node;
-}
-
-/**
- * Deletes a node from the BST while maintaining BST properties.
- * Handles 3 cases:
- * 1. Node is leaf (no children).
- * 2. Node has one child.
- * 3. Node has two children (replaces with successor and deletes successor).
- */
-PokemonNode* deletePokemonNode(PokemonNode* root, int id)
-{
-    if (root == NULL)
-    {
-        return root;
-    }
-
-    if (id < root->data->id)
-    {
-        root->left = deletePokemonNode(root->left, id);
-    }
-    else if (id > root->data->id)
-    {
-        root->right = deletePokemonNode(root->right, id);
-    }
-    else
-    {
-        // Node with the ID found
-        if (root->left == NULL && root->right == NULL) // No children
-        {
-            freePokemonNode(root);
-            return NULL;
-        }
-        else if (root->left == NULL) // One child (right)
-        {
-            PokemonNode* temp = root->right;
-            freePokemonNode(root);
-            return temp;
-        }
-        else if (root->right == NULL) // One child (left)
-        {
-            PokemonNode* temp = root->left;
-            freePokemonNode(root);
-            return temp;
-        }
-        else // Two children
-        {
-            PokemonNode* temp = findMin(root->right);
-            // Deep copy the data
-            PokemonData* newData = (PokemonData*)malloc(sizeof(PokemonData));
-            if (!newData)
-            {
-                fprintf(stderr, "Memory allocation failed for PokemonData.\n");
-                exit(EXIT_FAILURE);
-            }
-            newData->id = temp->data->id;
-            char* tempName = myStrdup(temp->data->name);
-            if(tempName == NULL)
-            {
-                printf("Memory allocation error\n");
-                free(newData);
-                exit(1);
-            }
-            newData->name = tempName;
-            freePokemonNode(root); // Free old node
-            root->data = newData;
-            root->right = deletePokemonNode(root->right, temp->data->id);
-        }
-    }
-    return root;
-}  // this is the code
-
-
-void pokemonFight(OwnerNode* owner) 
-{
-    if (owner->pokedexRoot == NULL) 
-    {
-        printf("Pokedex is empty.\n");
-        return;
-    }
-
-    int id1 = readIntSafe("Enter ID of the first Pokemon: ");
-    int id2 = readIntSafe("Enter ID of the second Pokemon: ");
-
-    // Search for the Pokémon using the provided BFS search function
-    PokemonNode* pokemon1 = searchPokemonBFS(owner->pokedexRoot, id1);
-    PokemonNode* pokemon2 = searchPokemonBFS(owner->pokedexRoot, id2);
-
-    if (pokemon1 == NULL || pokemon2 == NULL) 
-    {
-        printf("One or both Pokemon IDs not found.\n");
-        return;
-    }
-
-    // Calculate scores based on the formula: attack * 1.5 + hp * 1.2
-    double score1 = pokemon1->data->attack * 1.5 + pokemon1->data->hp * 1.2;
-    double score2 = pokemon2->data->attack * 1.5 + pokemon2->data->hp * 1.2;
-
-    // Print details of the Pokémon
-    printf("Pokemon 1: %s (Score = %.2f)\n", pokemon1->data->name, score1);
-    printf("Pokemon 2: %s (Score = %.2f)\n", pokemon2->data->name, score2);
-
-    // Determine the winner
-    if (score1 > score2) {
-        printf("%s wins!\n", pokemon1->data->name);
-    } else if (score1 < score2) {
-        printf("%s wins!\n", pokemon2->data->name);
-    } else {
-        printf("It's a tie!\n");
-    }
-}
-
-
-void evolvePokemon(OwnerNode* owner) 
-{
-    if (owner->pokedexRoot == NULL) 
-    {
-        printf("Cannot evolve. Pokedex empty.\n");
-        return;
-    }
-
-    int oldID = readIntSafe("Enter ID of Pokemon to evolve: ");
-    PokemonNode* pokemonToEvolve = searchPokemonBFS(owner->pokedexRoot, oldID);
-
-    // Check if the Pokémon exists in the Pokedex
-    if (pokemonToEvolve == NULL) {
-        printf("No Pokemon with ID %d found.\n", oldID);
-        return;
-    }
-
-    // Check if the Pokémon can evolve
-    if (pokemonToEvolve->data->CAN_EVOLVE == 0) 
-    {
-        printf("%s (ID %d) cannot evolve.\n", pokemonToEvolve->data->name, oldID);
-        return;
-    }
-
-    int newID = oldID + 1;  // ID of the evolved form
-    PokemonNode* evolvedPokemon = searchPokemonBFS(owner->pokedexRoot, newID);
-
-    // If the evolved form already exists in the Pokedex
-    if (evolvedPokemon != NULL) {
-        printf("Evolution ID %d (%s) already in the Pokedex. Releasing %s (ID %d).\n",
-               newID, evolvedPokemon->data->name, pokemonToEvolve->data->name, oldID);
-
-        // Release the original Pokémon
-        owner->pokedexRoot = deletePokemonNode(owner->pokedexRoot, oldID);
-        return;
-    }
-
-    // Proceed to evolve the Pokémon
-    printf("Pokemon evolved from %s (ID %d) to %s (ID %d).\n",
-        pokemonToEvolve->data->name, oldID, pokedex[newID-1].name, newID);
-
-        evolvedPokemon = createPokemonNode(&pokedex[newID-1]);
-        pokemonToEvolve->right = evolvedPokemon;
-        owner->pokedexRoot = deletePokemonNode(owner->pokedexRoot, oldID);
-        
-        
-}
-
-// --------------------------------------------------------------
-// Main Menu
-// --------------------------------------------------------------
-void mainMenu()
-{
-    int choice;
-    do
-    {
-        printf("\n=== Main Menu ===\n");
-        printf("1. New Pokedex\n");
-        printf("2. Existing Pokedex\n");
-        printf("3. Delete a Pokedex\n");
-        printf("4. Merge Pokedexes\n");
-        printf("5. Sort Owners by Name\n");
-        printf("6. Print Owners in a direction X times\n");
-        printf("7. Exit\n");
-        choice = readIntSafe("Your choice: ");
-
-        switch (choice)
-        {
-        case 1:
-            openPokedexMenu();
-            break;
-        case 2:
-            enterExistingPokedexMenu();
-            break;
-        case 3:
-            deletePokedex();
-            break;
-        case 4:
-            mergePokedexMenu();
-            break;
-        case 5:
-            sortOwners();
-            break;
-        case 6:
-            printOwnersCircular();
-            break;
-        case 7:
-            printf("Goodbye!\n");
-            break;
-        default:
-            printf("Invalid.\n");
-        }
-    } while (choice != 7);
-}
-
-int main()
-{
-    mainMenu();
-    freeAllOwners();
-    return 0;
-}
-
-
-/**
- * Creates a new Pokedex (and a new Owner) in the circular linked list.
- * Includes conflict checks for existing names.
- */
-void openPokedexMenu() 
-{
-    printf("Your name: ");
-    char *newownername = getDynamicInput();
-    OwnerNode* i = ownerHead;
-
-    if(ownerHead != NULL)
-    {
-        do
-    {
-
-        if(strcmp(newownername,i->ownerName)==0)
-        {
-            printf("Owner '%s' already exists. Not creating a new Pokedex.\n", newownername);
-            free(newownername);
-            return;
-        }
-        i = i->next;
-    }while (i!= ownerHead);
-    }
-    
-    
-    
-    printf("\nCOOSE YOUR STARTER:\n1. Bulbasaur\n2. Charmander\n3. Squirtle\n");
-    int starterchoise = readIntSafe("your choice: ");
-
-    if(starterchoise == 2)
-    {
-        starterchoise = 4;
-    }
-    else if(starterchoise==3)
-    {
-        starterchoise = 7;
-    }
-    else
-    {
-        if(starterchoise != 1)
-        {
-            printf("Invalid choice.\n");
-            return;
-        }
-        
-    }
-    
-
-    PokemonNode *starterNode = createPokemonNode(&pokedex[starterchoise - 1]);
-    OwnerNode *newOwner = createOwner(newownername, starterNode);
-    linkOwnerInCircularList(newOwner);
-    printf("New Pokedex created for %s with starter %s.\n\n", newownername, pokedex[starterchoise-1].name);
-    free(newownername);
-    
-}
-
-
-
-void deletePokedex() 
-{
-    // Check if there are any owners in the list
-    if (ownerHead == NULL) 
-    {
-        printf("No existing Pokedexes to delete.\n");
-        return;
-    }
-
-    printf("\n=== Delete a Pokedex ===\n");
-
-    // Display the list of owners
-    OwnerNode *current = ownerHead;
-    int count = 0;
-
-    do 
-    {
-        printf("%d. %s\n", ++count, current->ownerName);
-        current = current->next;
-    } while (current != ownerHead);
-
-    // Prompt the user to select an owner by number
-    int choice = readIntSafe("Choose a Pokedex to delete by number: ");
-
-    // Validate the choice
-    if (choice < 1 || choice > count) 
-    {
-        printf("Invalid choice.\n");
-        return;
-    }
-
-    // Locate the chosen owner
-    current = ownerHead;
-    for (int i = 1; i < choice; i++) 
-    {
-        current = current->next;
-    }
-
-    // Delete the selected owner's Pokedex
-    printf("Deleting %s's entire Pokedex...\n", current->ownerName);
-
-    // Handle the case where the owner to delete is the head
-    if (current == ownerHead) 
-    {
-        if (ownerHead->next == ownerHead) // Only one owner in the list
-        {
-            freeOwnerNode(ownerHead);
-            ownerHead = NULL;
-        } 
-        else 
-        {
-            OwnerNode *prev = ownerHead->prev;
-            ownerHead = ownerHead->next;
-            prev->next = ownerHead;
-            ownerHead->prev = prev;
-            freeOwnerNode(current);
-        }
-    } 
-    else // For non-head owners
-    {
-        current->prev->next = current->next;
-        current->next->prev = current->prev;
-        freeOwnerNode(current);
-    }
-
-    printf("Pokedex deleted.\n");
-}
-
-
-
-PokemonNode *insertPokemonNode(PokemonNode *root, PokemonNode *newNode) 
-{
-    if (root == NULL) 
-    {
-        // If the tree is empty, the new node becomes the root
-        return newNode;
-    }
-
-    if (newNode->data->id < root->data->id) 
-    {
-        // Insert in the left subtree
-        root->left = insertPokemonNode(root->left, newNode);
-    } else if (newNode->data->id > root->data->id) 
-    {
-        // Insert in the right subtree
-        root->right = insertPokemonNode(root->right, newNode);
-    }
-
-    // Return the unchanged root
-    return root;
-}
-
-void deleteOwnerFromList(OwnerNode *target) 
-{
-    if(ownerHead == NULL || target == NULL)
-    {
-            return;
-    }
-    if(ownerHead == target && ownerHead->next == ownerHead)
-    {
-        freeOwnerNode(ownerHead);
-        ownerHead = NULL;
-    } else {
-        OwnerNode* temp1 = target->next;
-        OwnerNode* temp2 = target->prev;
-        temp2->next = temp1;
-        temp1->prev = temp2;
-        if(target == ownerHead)
-        {
-            ownerHead = temp1;
-        }
-        freeOwnerNode(target);
-    }
-}
-
-OwnerNode *findOwnerByName(const char *name) 
-{
-    OwnerNode *current = ownerHead;
-
-    // Traverse the linked list to find the owner
-    while (current != NULL) 
-    {
-        if (strcmp(current->ownerName, name) == 0) 
-        {
-            // Found the owner
-            return current;
-        }
-        current = current->next;
-    }
-
-    // Owner not found
-    return NULL;
-}
-
-
-void mergePokedexMenu() 
-{
-
-    if (ownerHead == NULL || ownerHead->next == ownerHead) 
-    {
-        printf("Not enough owners to merge.\n");
-        return;
-    }
-    char *firstOwnerName = NULL, *secondOwnerName = NULL;
-    printf("\n=== Merge Pokedexes ===\n");
-
-    printf("Enter name of first owner: ");
-    firstOwnerName = getDynamicInput();
-
-    printf("Enter name of second owner: ");
-    secondOwnerName = getDynamicInput();
-
-    OwnerNode *firstOwner = findOwnerByName(firstOwnerName);
-    OwnerNode *secondOwner = findOwnerByName(secondOwnerName);
-
-    if (firstOwner == NULL || secondOwner == NULL) 
-    {
-        printf("One or both owners not found.\n");
-        free(firstOwnerName);
-        free(secondOwnerName);
-        return;
-    }
-
-    printf("Merging %s and %s...\n", firstOwner->ownerName, secondOwner->ownerName);
-
-    // Perform BFS on the second owner's Pokedex and add each node to the first owner's Pokedex
-    PokemonNode **queue = (PokemonNode **)malloc(sizeof(PokemonNode *) * 1000); // Adjust size as needed
-    if (!queue) 
-    {
-        printf("Memory allocation failed.\n");
-        free(firstOwnerName);
-        free(secondOwnerName);
-        return;
-    }
-
-    int front = 0, rear = 0;
-    queue[rear++] = secondOwner->pokedexRoot;
-
-    while (front < rear) 
-    {
-        PokemonNode *current = queue[front++];
-
-        if (current != NULL) 
-        {
-            // Create a new node for insertion
-            PokemonNode *newNode = (PokemonNode *)malloc(sizeof(PokemonNode));
-            if (!newNode) 
-            {
-                printf("Memory allocation failed for new node.\n");
-                free(queue);
-                free(firstOwnerName);
-                free(secondOwnerName);
-                return;
-            }
-            newNode->data = current->data; // Point to the same data
-            newNode->left = NULL;
-            newNode->right = NULL;
-
-            firstOwner->pokedexRoot = insertPokemonNode(firstOwner->pokedexRoot, newNode);
-
-            // Enqueue children
-            queue[rear++] = current->left;
-            queue[rear++] = current->right;
-        }
-    }
-
-    free(queue);
-
-    // Remove the second owner
-    deleteOwnerFromList(secondOwner);
-
-    printf("Merge completed.\n");
-    printf("Owner '%s' has been removed after merging.\n", secondOwnerName);
-
-    free(firstOwnerName);
-    free(secondOwnerName);
-}
-
-
-void sortOwners() {
-    if (ownerHead == NULL || ownerHead->next == ownerHead) {
-        printf("0 or 1 owners only => no need to sort.\n");
-        return;
-    }
-
-    OwnerNode *current = ownerHead;
-    OwnerNode *index = NULL;
-    char tempName[100];
-
-    // Perform a bubble sort on the circular doubly linked list
-    do {
-        index = current->next;
-        while (index != ownerHead) {
-            // Compare the names of two owners
-            if (strcmp(current->ownerName, index->ownerName) > 0) {
-                // Swap the owner names
-                strcpy(tempName, current->ownerName);
-                strcpy(current->ownerName, index->ownerName);
-                strcpy(index->ownerName, tempName);
-            }
-            index = index->next;
-        }
-        current = current->next;
-    } while (current != ownerHead);  // Continue until we return to the head
-    printf("Owners sorted by name.\n");
-}
-
-
-/**
- * Links a new OwnerNode into the circular doubly linked list.
- * Updates pointers for the new node, the previous tail, and the head.
- */
-void linkOwnerInCircularList(OwnerNode *newOwner)
-{
-    if(ownerHead == NULL)
-    {
-        ownerHead = newOwner;
-        newOwner->next = newOwner;
-        newOwner->prev = newOwner;
-        return;
-    }
-    OwnerNode* lastowner = ownerHead->prev;;
-    lastowner->next = newOwner;
-    newOwner->prev = lastowner;
-
-    newOwner->next = ownerHead;
-    ownerHead->prev = newOwner;
-    
-}
-
-
-
-PokemonNode *createPokemonNode(const PokemonData *data)
-{
-    PokemonNode *newpokemonnode = malloc(sizeof(PokemonNode));
-    if (!newpokemonnode)
-    {
-        printf("Memory allocation failed for PokemonNode.\n");
-        return NULL;
-    }
-
-    newpokemonnode->data = (PokemonData *)data;
-    newpokemonnode->left = NULL;
-    newpokemonnode->right = NULL;
-    return newpokemonnode;
-}
-
-
-
-
-OwnerNode *createOwner(char *ownerName, PokemonNode *starter)
-{
-    OwnerNode *newOwner = (OwnerNode *)malloc(sizeof(OwnerNode));
-    if (newOwner == NULL) 
-    {
-        printf("Memory allocation failed for OwnerNode.\n");
-        free(newOwner);
-        return NULL;
-    }
-
-    // Allocate memory for the ownerName and copy the provided name into it
-    newOwner->ownerName = (char *)malloc(strlen(ownerName) + 1);
-    if (newOwner->ownerName == NULL) 
-    {
-        printf("Memory allocation failed for ownerName.\n");
-        free(newOwner);
-        return NULL;
-    }
-    strcpy(newOwner->ownerName, ownerName);
-
-    newOwner->pokedexRoot = starter;
-
-    // Initialize the next pointer to NULL (assuming the list is being built)
-    newOwner->pokedexRoot->right = NULL;
-    newOwner->pokedexRoot->left = NULL;
-
-    return newOwner;
-
-}
-
-
-void printOwnersCircular() 
-{
-    if (ownerHead == NULL) 
-    {
-        printf("No owners.\n");
-        return;
-    }
-
-    char choice = 'a';
-    while (choice != 'f' && choice != 'F' && choice != 'b' && choice != 'B') 
-    {
-        printf("Enter direction (F or B): ");
-        scanf(" %c", &choice);
-        if (choice == 'f' || choice == 'F') 
-        {
-            getchar();
-            int numprints = readIntSafe("How many prints? ");
-            OwnerNode *current = ownerHead;
-            for (int i = 0; i < numprints; i++) 
-            {
-                printf("[%d] %s\n", i + 1, current->ownerName);
-                current = current->next;  // Move to the next owner in the circular list
-            }
-            return;
-        } 
-        else if (choice == 'b' || choice == 'B') 
-        {
-            getchar();
-            int numprints = readIntSafe("How many prints? ");
-            OwnerNode *current = ownerHead;
-            // Move to the last node to print in reverse order
-            for (int i = 0; i < numprints; i++) 
-            {
-                printf("[%d] %s\n", i + 1, current->ownerName);
-                current = current->prev;  // Move to the previous owner in the circular list
-            }
-            return;
-        } 
-        else 
-        {
-            printf("Invalid direction, must be F or B.\n");
-        }
-    }
-}
-
-
-//========================================
-// Memory Management & Freeing
-// Ensures no memory leaks by recursively freeing trees and lists.
-//========================================
-
-void freePokemonNode(PokemonNode* node)
-{
-    if (node == NULL)
-    {
-        return;
-    }
-    if (node->data != NULL && node->data >= pokedex && node->data < pokedex + 151)
-    {
-        // Don't free if data points to the static pokedex array
-        node->data = NULL;
-    }
-    else
-    {
-        free(node->data); // Only free dynamically allocated data
-    }
-    free(node);
-}
-
-void freePokemonTree(PokemonNode *root)
-{
-    if (root == NULL)
-    {
-        return;
-    }
-    freePokemonTree(root->left);
-    freePokemonTree(root->right);
-    freePokemonNode(root);
-}
-
-void freeOwnerNode(OwnerNode *owner)
-{
-    if (owner == NULL)
-    {
-        return;
-    }
-    freePokemonTree(owner->pokedexRoot);
-    free(owner->ownerName);
-    free(owner);
-}
-
-void freeAllOwners() 
-{
-    if (ownerHead == NULL) 
-    {
-        return;
-    }
-
-    OwnerNode *current = ownerHead;
-    OwnerNode *nextNode;
-
-    // Traverse the circular linked list and free each node
-    do 
-    {
-        nextNode = current->next;
-        freeOwnerNode(current);
-        current = nextNode;
-    } 
-    while (current != ownerHead);
-    // Reset the head pointer to NULL as the list is now empty
-    ownerHead = NULL;
-}
\ No newline at end of file
+// accept4() and SOCK_NONBLOCK for the session server
+#define _GNU_SOURCE
+#include "pokemon.h"
+#include "pokemon_species_hash.h" // Generated by pokemon_hashgen.c
+#include <ctype.h>
+#include <errno.h>
+#include <limits.h>
+#include <malloc.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+
+// Global head pointer for the circular list of owners (guarded by ownerRingLock)
+OwnerNode *ownerHead = NULL;
+
+// Serializes ring writers: ownerHead and every next/prev link.
+// Readers never take it; they walk the published ownerRingView instead.
+// Lock order: ownerRingLock first, then owner dexLocks (lower address first).
+pthread_mutex_t ownerRingLock = PTHREAD_MUTEX_INITIALIZER;
+
+// Immutable ring-order copy of the owner list for lock-free readers.
+// Replaced wholesale by writers; old views are freed through the epochs.
+static _Atomic(OwnerRingView *) ownerRingView = NULL;
+
+// Array of Pokemon data
+const PokemonData pokedex[POKEDEX_SIZE] = {
+    {1, "Bulbasaur", GRASS, 45, 49, CAN_EVOLVE},
+    {2, "Ivysaur", GRASS, 60, 62, CAN_EVOLVE},
+    {3, "Venusaur", GRASS, 80, 82, CANNOT_EVOLVE},
+    {4, "Charmander", FIRE, 39, 52, CAN_EVOLVE},
+    {5, "Charmeleon", FIRE, 58, 64, CAN_EVOLVE},
+    {6, "Charizard", FIRE, 78, 84, CANNOT_EVOLVE},
+    {7, "Squirtle", WATER, 44, 48, CAN_EVOLVE},
+    {8, "Wartortle", WATER, 59, 63, CAN_EVOLVE},
+    {9, "Blastoise", WATER, 79, 83, CANNOT_EVOLVE},
+    {10, "Caterpie", BUG, 45, 30, CAN_EVOLVE},
+    {11, "Metapod", BUG, 50, 20, CAN_EVOLVE},
+    {12, "Butterfree", BUG, 60, 45, CANNOT_EVOLVE},
+    {13, "Weedle", BUG, 40, 35, CAN_EVOLVE},
+    {14, "Kakuna", BUG, 45, 25, CAN_EVOLVE},
+    {15, "Beedrill", BUG, 65, 90, CANNOT_EVOLVE},
+    {16, "Pidgey", NORMAL, 40, 45, CAN_EVOLVE},
+    {17, "Pidgeotto", NORMAL, 63, 60, CAN_EVOLVE},
+    {18, "Pidgeot", NORMAL, 83, 80, CANNOT_EVOLVE},
+    {19, "Rattata", NORMAL, 30, 56, CAN_EVOLVE},
+    {20, "Raticate", NORMAL, 55, 81, CANNOT_EVOLVE},
+    {21, "Spearow", NORMAL, 40, 60, CAN_EVOLVE},
+    {22, "Fearow", NORMAL, 65, 90, CANNOT_EVOLVE},
+    {23, "Ekans", POISON, 35, 60, CAN_EVOLVE},
+    {24, "Arbok", POISON, 60, 85, CANNOT_EVOLVE},
+    {25, "Pikachu", ELECTRIC, 35, 55, CAN_EVOLVE},
+    {26, "Raichu", ELECTRIC, 60, 90, CANNOT_EVOLVE},
+    {27, "Sandshrew", GROUND, 50, 75, CAN_EVOLVE},
+    {28, "Sandslash", GROUND, 75, 100, CANNOT_EVOLVE},
+    {29, "NidoranF", POISON, 55, 47, CAN_EVOLVE},
+    {30, "Nidorina", POISON, 70, 62, CAN_EVOLVE},
+    {31, "Nidoqueen", POISON, 90, 92, CANNOT_EVOLVE},
+    {32, "NidoranM", POISON, 46, 57, CAN_EVOLVE},
+    {33, "Nidorino", POISON, 61, 72, CAN_EVOLVE},
+    {34, "Nidoking", POISON, 81, 102, CANNOT_EVOLVE},
+    {35, "Clefairy", FAIRY, 70, 45, CAN_EVOLVE},
+    {36, "Clefable", FAIRY, 95, 70, CANNOT_EVOLVE},
+    {37, "Vulpix", FIRE, 38, 41, CAN_EVOLVE},
+    {38, "Ninetales", FIRE, 73, 76, CANNOT_EVOLVE},
+    {39, "Jigglypuff", NORMAL, 115, 45, CAN_EVOLVE},
+    {40, "Wigglytuff", NORMAL, 140, 70, CANNOT_EVOLVE},
+    {41, "Zubat", POISON, 40, 45, CAN_EVOLVE},
+    {42, "Golbat", POISON, 75, 80, CAN_EVOLVE},
+    {43, "Oddish", GRASS, 45, 50, CAN_EVOLVE},
+    {44, "Gloom", GRASS, 60, 65, CAN_EVOLVE},
+    {45, "Vileplume", GRASS, 75, 80, CANNOT_EVOLVE},
+    {46, "Paras", BUG, 35, 70, CAN_EVOLVE},
+    {47, "Parasect", BUG, 60, 95, CANNOT_EVOLVE},
+    {48, "Venonat", BUG, 60, 55, CAN_EVOLVE},
+    {49, "Venomoth", BUG, 70, 65, CANNOT_EVOLVE},
+    {50, "Diglett", GROUND, 10, 55, CAN_EVOLVE},
+    {51, "Dugtrio", GROUND, 35, 80, CANNOT_EVOLVE},
+    {52, "Meowth", NORMAL, 40, 45, CAN_EVOLVE},
+    {53, "Persian", NORMAL, 65, 70, CANNOT_EVOLVE},
+    {54, "Psyduck", WATER, 50, 52, CAN_EVOLVE},
+    {55, "Golduck", WATER, 80, 82, CANNOT_EVOLVE},
+    {56, "Mankey", FIGHTING, 40, 80, CAN_EVOLVE},
+    {57, "Primeape", FIGHTING, 65, 105, CANNOT_EVOLVE},
+    {58, "Growlithe", FIRE, 55, 70, CAN_EVOLVE},
+    {59, "Arcanine", FIRE, 90, 110, CANNOT_EVOLVE},
+    {60, "Poliwag", WATER, 40, 50, CAN_EVOLVE},
+    {61, "Poliwhirl", WATER, 65, 65, CAN_EVOLVE},
+    {62, "Poliwrath", WATER, 90, 95, CANNOT_EVOLVE},
+    {63, "Abra", PSYCHIC, 25, 20, CAN_EVOLVE},
+    {64, "Kadabra", PSYCHIC, 40, 35, CAN_EVOLVE},
+    {65, "Alakazam", PSYCHIC, 55, 50, CANNOT_EVOLVE},
+    {66, "Machop", FIGHTING, 70, 80, CAN_EVOLVE},
+    {67, "Machoke", FIGHTING, 80, 100, CAN_EVOLVE},
+    {68, "Machamp", FIGHTING, 90, 130, CANNOT_EVOLVE},
+    {69, "Bellsprout", GRASS, 50, 75, CAN_EVOLVE},
+    {70, "Weepinbell", GRASS, 65, 90, CAN_EVOLVE},
+    {71, "Victreebel", GRASS, 80, 105, CANNOT_EVOLVE},
+    {72, "Tentacool", WATER, 40, 40, CAN_EVOLVE},
+    {73, "Tentacruel", WATER, 80, 70, CANNOT_EVOLVE},
+    {74, "Geodude", ROCK, 40, 80, CAN_EVOLVE},
+    {75, "Graveler", ROCK, 55, 95, CAN_EVOLVE},
+    {76, "Golem", ROCK, 80, 120, CANNOT_EVOLVE},
+    {77, "Ponyta", FIRE, 50, 85, CAN_EVOLVE},
+    {78, "Rapidash", FIRE, 65, 100, CANNOT_EVOLVE},
+    {79, "Slowpoke", WATER, 90, 65, CAN_EVOLVE},
+    {80, "Slowbro", WATER, 95, 75, CANNOT_EVOLVE},
+    {81, "Magnemite", ELECTRIC, 25, 35, CAN_EVOLVE},
+    {82, "Magneton", ELECTRIC, 50, 60, CANNOT_EVOLVE},
+    {83, "Farfetch'd", NORMAL, 52, 65, CANNOT_EVOLVE},
+    {84, "Doduo", NORMAL, 35, 85, CAN_EVOLVE},
+    {85, "Dodrio", NORMAL, 60, 110, CANNOT_EVOLVE},
+    {86, "Seel", WATER, 65, 45, CAN_EVOLVE},
+    {87, "Dewgong", WATER, 90, 70, CANNOT_EVOLVE},
+    {88, "Grimer", POISON, 80, 80, CAN_EVOLVE},
+    {89, "Muk", POISON, 105, 105, CANNOT_EVOLVE},
+    {90, "Shellder", WATER, 30, 65, CAN_EVOLVE},
+    {91, "Cloyster", WATER, 50, 95, CANNOT_EVOLVE},
+    {92, "Gastly", GHOST, 30, 35, CAN_EVOLVE},
+    {93, "Haunter", GHOST, 45, 50, CAN_EVOLVE},
+    {94, "Gengar", GHOST, 60, 65, CANNOT_EVOLVE},
+    {95, "Onix", ROCK, 35, 45, CANNOT_EVOLVE},
+    {96, "Drowzee", PSYCHIC, 60, 48, CAN_EVOLVE},
+    {97, "Hypno", PSYCHIC, 85, 73, CANNOT_EVOLVE},
+    {98, "Krabby", WATER, 30, 105, CAN_EVOLVE},
+    {99, "Kingler", WATER, 55, 130, CANNOT_EVOLVE},
+    {100, "Voltorb", ELECTRIC, 40, 30, CAN_EVOLVE},
+    {101, "Electrode", ELECTRIC, 60, 50, CANNOT_EVOLVE},
+    {102, "Exeggcute", GRASS, 60, 40, CAN_EVOLVE},
+    {103, "Exeggutor", GRASS, 95, 95, CANNOT_EVOLVE},
+    {104, "Cubone", GROUND, 50, 50, CAN_EVOLVE},
+    {105, "Marowak", GROUND, 60, 80, CANNOT_EVOLVE},
+    {106, "Hitmonlee", FIGHTING, 50, 120, CANNOT_EVOLVE},
+    {107, "Hitmonchan", FIGHTING, 50, 105, CANNOT_EVOLVE},
+    {108, "Lickitung", NORMAL, 90, 55, CANNOT_EVOLVE},
+    {109, "Koffing", POISON, 40, 65, CAN_EVOLVE},
+    {110, "Weezing", POISON, 65, 90, CANNOT_EVOLVE},
+    {111, "Rhyhorn", GROUND, 80, 85, CAN_EVOLVE},
+    {112, "Rhydon", GROUND, 105, 130, CANNOT_EVOLVE},
+    {113, "Chansey", NORMAL, 250, 5, CANNOT_EVOLVE},
+    {114, "Tangela", GRASS, 65, 55, CANNOT_EVOLVE},
+    {115, "Kangaskhan", NORMAL, 105, 95, CANNOT_EVOLVE},
+    {116, "Horsea", WATER, 30, 40, CAN_EVOLVE},
+    {117, "Seadra", WATER, 55, 65, CANNOT_EVOLVE},
+    {118, "Goldeen", WATER, 45, 67, CAN_EVOLVE},
+    {119, "Seaking", WATER, 80, 92, CANNOT_EVOLVE},
+    {120, "Staryu", WATER, 30, 45, CAN_EVOLVE},
+    {121, "Starmie", WATER, 60, 75, CANNOT_EVOLVE},
+    {122, "Mr. Mime", PSYCHIC, 40, 45, CANNOT_EVOLVE},
+    {123, "Scyther", BUG, 70, 110, CANNOT_EVOLVE},
+    {124, "Jynx", ICE, 65, 50, CANNOT_EVOLVE},
+    {125, "Electabuzz", ELECTRIC, 65, 83, CANNOT_EVOLVE},
+    {126, "Magmar", FIRE, 65, 95, CANNOT_EVOLVE},
+    {127, "Pinsir", BUG, 65, 125, CANNOT_EVOLVE},
+    {128, "Tauros", NORMAL, 75, 100, CANNOT_EVOLVE},
+    {129, "Magikarp", WATER, 20, 10, CAN_EVOLVE},
+    {130, "Gyarados", WATER, 95, 125, CANNOT_EVOLVE},
+    {131, "Lapras", WATER, 130, 85, CANNOT_EVOLVE},
+    {132, "Ditto", NORMAL, 48, 48, CANNOT_EVOLVE},
+    {133, "Eevee", NORMAL, 55, 55, CAN_EVOLVE},
+    {134, "Vaporeon", WATER, 130, 65, CANNOT_EVOLVE},
+    {135, "Jolteon", ELECTRIC, 65, 65, CANNOT_EVOLVE},
+    {136, "Flareon", FIRE, 65, 130, CANNOT_EVOLVE},
+    {137, "Porygon", NORMAL, 65, 60, CANNOT_EVOLVE},
+    {138, "Omanyte", ROCK, 35, 40, CAN_EVOLVE},
+    {139, "Omastar", ROCK, 70, 60, CANNOT_EVOLVE},
+    {140, "Kabuto", ROCK, 30, 80, CAN_EVOLVE},
+    {141, "Kabutops", ROCK, 60, 115, CANNOT_EVOLVE},
+    {142, "Aerodactyl", ROCK, 80, 105, CANNOT_EVOLVE},
+    {143, "Snorlax", NORMAL, 160, 110, CANNOT_EVOLVE},
+    {144, "Articuno", ICE, 90, 85, CANNOT_EVOLVE},
+    {145, "Zapdos", ELECTRIC, 90, 90, CANNOT_EVOLVE},
+    {146, "Moltres", FIRE, 90, 100, CANNOT_EVOLVE},
+    {147, "Dratini", DRAGON, 41, 64, CAN_EVOLVE},
+    {148, "Dragonair", DRAGON, 61, 84, CAN_EVOLVE},
+    {149, "Dragonite", DRAGON, 91, 134, CANNOT_EVOLVE},
+    {150, "Mewtwo", PSYCHIC, 106, 110, CANNOT_EVOLVE},
+    {151, "Mew", PSYCHIC, 100, 100, CANNOT_EVOLVE}};
+
+// ================================================
+// Basic struct definitions from ex6.h assumed:
+//   PokemonData { int id; char *name; PokemonType TYPE; int hp; int attack; EvolutionStatus CAN_EVOLVE; }
+//   PokemonNode { refCount; uint32_t left, right; uint8_t speciesId; } (see the node pool below)
+//   OwnerNode   { char* ownerName; PokemonNode* pokedexRoot; OwnerNode *next, *prev; }
+//   OwnerNode* ownerHead;
+//   const PokemonData pokedex[];
+// ================================================
+
+//========================================
+// Pokemon Node Pool
+// Every PokemonNode lives in a 64 KB chunk of one global pool. A node's
+// index is chunk number << NODE_CHUNK_SHIFT | slot, so children fit in
+// 32 bits. Chunks are aligned to their size: a node finds its own index
+// from the chunk's slot 0, which holds the chunk number instead of a node
+// (and makes index 0 the "no child" value). Free slots are chained
+// through their left index; each thread keeps a small cache of them and
+// trades batches with the shared list under nodePoolLock. Chunks are never
+// returned, so node pointers stay valid for as long as the node is live.
+//========================================
+
+#define NODE_CHUNK_SHIFT 12
+#define NODE_CHUNK_NODES (1u << NODE_CHUNK_SHIFT)                 // 4096 nodes
+#define NODE_CHUNK_BYTES (NODE_CHUNK_NODES * sizeof(PokemonNode)) // 64 KB
+#define NODE_POOL_MAX_CHUNKS (1u << 16)                           // Up to 2^28 nodes
+#define NODE_CACHE_MAX 64                                         // Free slots a thread keeps
+#define NODE_CACHE_BATCH 32                                       // Slots moved to/from the shared list at once
+
+static PokemonNode *nodeChunks[NODE_POOL_MAX_CHUNKS];
+static pthread_mutex_t nodePoolLock = PTHREAD_MUTEX_INITIALIZER;
+static uint32_t nodeChunkCount;    // Guarded by nodePoolLock
+static uint32_t nodeNextFresh;     // Next never-used index; guarded by nodePoolLock
+static uint32_t nodeFreeList;      // Guarded by nodePoolLock
+static pthread_key_t nodeCacheKey; // Only there to flush a finishing thread's cache
+static pthread_once_t nodeCacheKeyOnce = PTHREAD_ONCE_INIT;
+static _Thread_local uint32_t nodeCache;
+static _Thread_local int nodeCacheCount;
+static _Thread_local int nodeCacheRegistered;
+
+static void memCountAlloc(MemCategory category, size_t bytes);
+static void memCountFree(MemCategory category, size_t bytes);
+
+static inline PokemonNode *nodeAt(uint32_t index)
+{
+    return index == 0 ? NULL : nodeChunks[index >> NODE_CHUNK_SHIFT] + (index & (NODE_CHUNK_NODES - 1));
+}
+
+static inline uint32_t nodeIndex(const PokemonNode *node)
+{
+    if (node == NULL)
+    {
+        return 0;
+    }
+    const PokemonNode *chunk = (const PokemonNode *)((uintptr_t)node & ~(uintptr_t)(NODE_CHUNK_BYTES - 1));
+    return chunk->left << NODE_CHUNK_SHIFT | (uint32_t)(node - chunk);
+}
+
+static inline const PokemonData *nodeData(const PokemonNode *node)
+{
+    return &pokedex[node->speciesId - 1];
+}
+
+static inline PokemonNode *nodeLeft(const PokemonNode *node)
+{
+    return nodeAt(node->left);
+}
+
+static inline PokemonNode *nodeRight(const PokemonNode *node)
+{
+    return nodeAt(node->right);
+}
+
+static inline void setNodeLeft(PokemonNode *node, PokemonNode *child)
+{
+    node->left = nodeIndex(child);
+}
+
+static inline void setNodeRight(PokemonNode *node, PokemonNode *child)
+{
+    node->right = nodeIndex(child);
+}
+
+const PokemonData *pokemonNodeData(const PokemonNode *node)
+{
+    return nodeData(node);
+}
+
+PokemonNode *pokemonNodeLeft(const PokemonNode *node)
+{
+    return nodeLeft(node);
+}
+
+PokemonNode *pokemonNodeRight(const PokemonNode *node)
+{
+    return nodeRight(node);
+}
+
+// Hands count cached slots (count <= nodeCacheCount) back to the shared list
+static void nodeCacheSpill(int count)
+{
+    pthread_mutex_lock(&nodePoolLock);
+    for (int i = 0; i < count; i++)
+    {
+        PokemonNode *node = nodeAt(nodeCache);
+        uint32_t next = node->left;
+        node->left = nodeFreeList;
+        nodeFreeList = nodeCache;
+        nodeCache = next;
+    }
+    pthread_mutex_unlock(&nodePoolLock);
+    nodeCacheCount -= count;
+}
+
+static void flushNodeCache(void *unused)
+{
+    (void)unused;
+    nodeCacheSpill(nodeCacheCount);
+}
+
+static void makeNodeCacheKey(void)
+{
+    pthread_key_create(&nodeCacheKey, flushNodeCache);
+}
+
+static void registerNodeCache(void)
+{
+    pthread_once(&nodeCacheKeyOnce, makeNodeCacheKey);
+    pthread_setspecific(nodeCacheKey, &nodeCache); // Any non-NULL value runs the destructor
+    nodeCacheRegistered = 1;
+}
+
+// Fills the empty cache with up to NODE_CACHE_BATCH slots. Returns 0 when the pool is exhausted.
+static int nodeCacheRefill(void)
+{
+    if (!nodeCacheRegistered)
+    {
+        registerNodeCache();
+    }
+
+    pthread_mutex_lock(&nodePoolLock);
+    while (nodeCacheCount < NODE_CACHE_BATCH)
+    {
+        uint32_t index = nodeFreeList;
+        if (index != 0)
+        {
+            nodeFreeList = nodeAt(index)->left;
+        }
+        else
+        {
+            if ((nodeNextFresh & (NODE_CHUNK_NODES - 1)) == 0)
+            {
+                // Current chunk used up (or none yet): map the next one
+                PokemonNode *chunk = NULL;
+                if (nodeChunkCount < NODE_POOL_MAX_CHUNKS)
+                {
+                    chunk = (PokemonNode *)aligned_alloc(NODE_CHUNK_BYTES, NODE_CHUNK_BYTES);
+                }
+                if (chunk == NULL)
+                {
+                    break;
+                }
+                chunk->left = nodeChunkCount; // Slot 0 holds the chunk number
+                nodeChunks[nodeChunkCount] = chunk;
+                nodeNextFresh = nodeChunkCount++ << NODE_CHUNK_SHIFT | 1;
+            }
+            index = nodeNextFresh++;
+        }
+        nodeAt(index)->left = nodeCache;
+        nodeCache = index;
+        nodeCacheCount++;
+    }
+    pthread_mutex_unlock(&nodePoolLock);
+    return nodeCacheCount > 0;
+}
+
+static PokemonNode *allocPokemonNode(void)
+{
+    if (nodeCacheCount == 0 && !nodeCacheRefill())
+    {
+        return NULL;
+    }
+    PokemonNode *node = nodeAt(nodeCache);
+    nodeCache = node->left;
+    nodeCacheCount--;
+    memCountAlloc(MEM_POKEMON_NODES, sizeof(PokemonNode));
+    return node;
+}
+
+static void releasePokemonNodeSlot(PokemonNode *node)
+{
+    memCountFree(MEM_POKEMON_NODES, sizeof(PokemonNode));
+    if (!nodeCacheRegistered)
+    {
+        registerNodeCache();
+    }
+    node->left = nodeCache;
+    nodeCache = nodeIndex(node);
+    if (++nodeCacheCount > NODE_CACHE_MAX)
+    {
+        nodeCacheSpill(NODE_CACHE_BATCH);
+    }
+}
+
+// --------------------------------------------------------------
+// 1) Safe integer reading & String Manipulation
+//    Helper functions to ensure robust user input and memory safety.
+// --------------------------------------------------------------
+
+/**
+ * Removes leading and trailing whitespace characters from a string.
+ * Modifies the string in-place.
+ */
+void trimWhitespace(char *str)
+{
+    // Remove leading spaces/tabs/\r
+    int start = 0;
+    while (str[start] == ' ' || str[start] == '\t' || str[start] == '\r')
+        start++;
+
+    if (start > 0)
+    {
+        int idx = 0;
+        while (str[start])
+            str[idx++] = str[start++];
+        str[idx] = '\0';
+    }
+
+    // Remove trailing spaces/tabs/\r
+    int len = (int)strlen(str);
+    while (len > 0 && (str[len - 1] == ' ' || str[len - 1] == '\t' || str[len - 1] == '\r'))
+    {
+        str[--len] = '\0';
+    }
+}
+
+/**
+ * Custom implementation of strdup to ensure cross-platform compatibility
+ * and safe memory allocation checks.
+ */
+char *myStrdup(const char *src)
+{
+    if (!src)
+        return NULL;
+    size_t len = strlen(src);
+    char *dest = (char *)memAlloc(MEM_SCRATCH, len + 1);
+    if (!dest)
+    {
+        printf("Memory allocation failed in mymyStrdup.\n");
+        return NULL;
+    }
+    strcpy(dest, src);
+    return dest;
+}
+
+/**
+ * Parses a whole line as one integer (trailing \r / \n ignored).
+ * Returns 1 and stores the value on success, 0 if empty or not a pure number.
+ */
+int parseIntLine(const char *line, int *value)
+{
+    return parseIntSlice(line, strlen(line), value);
+}
+/**
+ * Hand-rolled integer parser (same rules as the strtol check it replaced):
+ * optional leading whitespace and sign, at least one digit, then only a
+ * trailing '\r'/'\n'. Values outside int are rejected.
+ */
+int parseIntSlice(const char *text, size_t length, int *value)
+{
+    const char *p = text;
+    const char *end = text + length;
+    while (end > p && (end[-1] == '\n' || end[-1] == '\r'))
+        end--;
+    while (p < end && isspace((unsigned char)*p))
+        p++;
+
+    int negative = 0;
+    if (p < end && (*p == '-' || *p == '+'))
+    {
+        negative = (*p == '-');
+        p++;
+    }
+    if (p == end)
+        return 0;
+
+    // Accumulate as a negative number so INT_MIN fits
+    long long result = 0;
+    for (; p < end; p++)
+    {
+        unsigned digit = (unsigned)(*p - '0');
+        if (digit > 9)
+            return 0;
+        result = result * 10 - digit;
+        if (result < -2147483648LL)
+            return 0;
+    }
+    if (!negative && result == -2147483648LL)
+        return 0;
+    *value = (int)(negative ? result : -result);
+    return 1;
+}
+
+// --------------------------------------------------------------
+// Buffered line input
+// Reads big chunks with read(2) and hands out lines as slices of the
+// buffer: no copy and no allocation per line. The buffer only grows when
+// a single line is longer than it.
+// --------------------------------------------------------------
+
+#define LINE_READER_CHUNK 65536
+
+void lineReaderInit(LineReader *reader, int fd)
+{
+    reader->fd = fd;
+    reader->buffer = NULL;
+    reader->capacity = 0;
+    reader->head = 0;
+    reader->tail = 0;
+    reader->scanned = 0;
+    reader->eof = 0;
+}
+
+void lineReaderFree(LineReader *reader)
+{
+    memFree(MEM_SCRATCH, reader->buffer);
+    reader->buffer = NULL;
+    reader->capacity = reader->head = reader->tail = reader->scanned = 0;
+}
+
+// Moves the unread bytes to the front and reads more. Returns 0 at end of input.
+static int lineReaderFill(LineReader *reader)
+{
+    if (reader->head > 0)
+    {
+        memmove(reader->buffer, reader->buffer + reader->head, reader->tail - reader->head);
+        reader->tail -= reader->head;
+        reader->scanned -= reader->head;
+        reader->head = 0;
+    }
+    // Keep one byte free to terminate a final line that has no newline
+    if (reader->capacity - reader->tail <= 1)
+    {
+        size_t capacity = reader->capacity ? reader->capacity * 2 : LINE_READER_CHUNK;
+        char *grown = (char *)memRealloc(MEM_SCRATCH, reader->buffer, capacity);
+        if (grown == NULL)
+        {
+            fprintf(stderr, "Memory allocation failed for input buffer.\n");
+            exit(EXIT_FAILURE);
+        }
+        reader->buffer = grown;
+        reader->capacity = capacity;
+    }
+
+    // Prompts are printed without a newline; make sure they are visible first
+    fflush(stdout);
+    while (1)
+    {
+        ssize_t got = read(reader->fd, reader->buffer + reader->tail, reader->capacity - 1 - reader->tail);
+        if (got > 0)
+        {
+            reader->tail += (size_t)got;
+            return 1;
+        }
+        if (got < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        reader->eof = 1;
+        return 0;
+    }
+}
+
+char *lineReaderNext(LineReader *reader, size_t *length)
+{
+    while (1)
+    {
+        char *newline = NULL;
+        if (reader->scanned < reader->tail)
+        {
+            newline = memchr(reader->buffer + reader->scanned, '\n', reader->tail - reader->scanned);
+        }
+
+        size_t end;
+        if (newline != NULL)
+        {
+            end = (size_t)(newline - reader->buffer);
+            reader->scanned = end + 1;
+        }
+        else
+        {
+            reader->scanned = reader->tail;
+            if (!reader->eof && lineReaderFill(reader))
+            {
+                continue;
+            }
+            if (reader->head == reader->tail)
+            {
+                return NULL;
+            }
+            // Last line without a trailing newline
+            end = reader->tail;
+        }
+
+        char *line = reader->buffer + reader->head;
+        reader->head = (end < reader->tail) ? end + 1 : end;
+        reader->buffer[end] = '\0';
+        if (end > 0 && line < reader->buffer + end && reader->buffer[end - 1] == '\r')
+        {
+            reader->buffer[--end] = '\0';
+        }
+        if (length != NULL)
+        {
+            *length = (size_t)(reader->buffer + end - line);
+        }
+        return line;
+    }
+}
+
+// --------------------------------------------------------------
+// 2) Utility: Get type name from enum
+// --------------------------------------------------------------
+const char *getTypeName(PokemonType type)
+{
+    switch (type)
+    {
+    case GRASS:
+        return "GRASS";
+    case FIRE:
+        return "FIRE";
+    case WATER:
+        return "WATER";
+    case BUG:
+        return "BUG";
+    case NORMAL:
+        return "NORMAL";
+    case POISON:
+        return "POISON";
+    case ELECTRIC:
+        return "ELECTRIC";
+    case GROUND:
+        return "GROUND";
+    case FAIRY:
+        return "FAIRY";
+    case FIGHTING:
+        return "FIGHTING";
+    case PSYCHIC:
+        return "PSYCHIC";
+    case ROCK:
+        return "ROCK";
+    case GHOST:
+        return "GHOST";
+    case DRAGON:
+        return "DRAGON";
+    case ICE:
+        return "ICE";
+    default:
+        return "UNKNOWN";
+    }
+}
+
+// Function to print a single Pokemon node
+void printPokemonNode(PokemonNode *node)
+{
+    if (!node)
+        return;
+    const PokemonData *data = nodeData(node);
+    printf(POKEMON_LINE_FORMAT,
+           data->id,
+           data->name,
+           getTypeName(data->TYPE),
+           data->hp,
+           data->attack,
+           (data->CAN_EVOLVE == CAN_EVOLVE) ? "Yes" : "No");
+}
+
+// --------------------------------------------------------------
+// Tree Traversals
+// Implements various tree traversal algorithms (BFS, DFS variations).
+// --------------------------------------------------------------
+
+/**
+ * BFS Search Implementation.
+ * Uses a manually allocated queue to traverse the BST level by level
+ * to find a Pokemon by ID.
+ * @param root The root of the BST.
+ * @param id The ID to search for.
+ * @return Pointer to the found PokemonNode or NULL.
+ */
+PokemonNode *searchPokemonBFS(PokemonNode *root, int id)
+{
+    
+    if (root == NULL)
+    {
+        return NULL;
+    }
+
+    // Create a queue for BFS
+    PokemonNode **queue = (PokemonNode **)memAlloc(MEM_SCRATCH, sizeof(PokemonNode *) * 151); // Adjust size as needed
+    if (queue == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed for BFS queue.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    int front = 0, rear = 0;
+
+    // Enqueue the root node
+    queue[rear++] = root;
+
+    while (front < rear)
+    {
+        // Dequeue a node
+        PokemonNode *current = queue[front++];
+
+        // Check if the current node's ID matches the target ID
+        if (current->speciesId == id)
+        {
+            memFree(MEM_SCRATCH, queue); // Free allocated memory before returning
+            return current;
+        }
+
+        // Enqueue left child if it exists
+        if (nodeLeft(current) != NULL)
+        {
+            queue[rear++] = nodeLeft(current);
+        }
+
+        // Enqueue right child if it exists
+        if (nodeRight(current) != NULL)
+        {
+            queue[rear++] = nodeRight(current);
+        }
+    }
+
+    // Free allocated memory
+    memFree(MEM_SCRATCH, queue);
+
+    // If we reach here, the ID was not found
+    return NULL;
+
+}
+
+/**
+ * Plain BST lookup by ID, O(height) and allocation-free.
+ * Used by the mutation paths to decide up front whether anything changes,
+ * so we never path-copy a shared tree for a no-op.
+ */
+// Walks one root-to-leaf path; *visited gets the number of nodes compared.
+static PokemonNode *findPokemonWithDepth(PokemonNode *root, int id, unsigned long *visited)
+{
+    unsigned long steps = 0;
+    while (root != NULL && root->speciesId != id)
+    {
+        steps++;
+        root = (id < root->speciesId) ? nodeLeft(root) : nodeRight(root);
+    }
+    *visited = steps + (root != NULL);
+    return root;
+}
+
+PokemonNode *findPokemonBST(PokemonNode *root, int id)
+{
+    unsigned long visited;
+    unsigned long long start = metricsStart(METRIC_SEARCH);
+    PokemonNode *found = findPokemonWithDepth(root, id, &visited);
+    metricsStop(METRIC_SEARCH, start, visited);
+    return found;
+}
+
+/**
+ * Standard Breadth-First Search traversal to display nodes.
+ */
+void displayBFS(PokemonNode* root)
+{
+    if (root == NULL) 
+    {
+        printf("Pokedex is empty.\n");
+        return;
+    }
+    PokemonNode **queue = (PokemonNode **)memAlloc(MEM_SCRATCH, sizeof(PokemonNode *) * 1000); // Adjust size as needed
+    if (queue == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed for BFS queue.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    int front = 0, rear = 0;
+
+    // Enqueue the root node
+    queue[rear++] = root;
+
+    while (front < rear)
+    {
+        // Dequeue a node
+        PokemonNode *current = queue[front++];
+
+        // Print the current node
+        printPokemonNode(current);
+
+        // Enqueue left child if it exists
+        if (nodeLeft(current) != NULL)
+        {
+            queue[rear++] = nodeLeft(current);
+        }
+
+        // Enqueue right child if it exists
+        if (nodeRight(current) != NULL)
+        {
+            queue[rear++] = nodeRight(current);
+        }
+    }
+
+    // Free allocated memory
+    memFree(MEM_SCRATCH, queue);
+    
+}
+
+// Recursive Pre-Order Traversal (Root -> Left -> Right)
+void preOrderTraversal(PokemonNode* root) 
+{
+     if (root == NULL)
+    {
+        return;
+    }
+
+    // Print the current node
+    printPokemonNode(root);
+
+    // Recursively traverse the left subtree
+    preOrderTraversal(nodeLeft(root));
+
+    // Recursively traverse the right subtree
+    preOrderTraversal(nodeRight(root));
+}
+
+// Recursive In-Order Traversal (Left -> Root -> Right)
+void inOrderTraversal(PokemonNode* root) 
+{
+    if (root == NULL)
+    {
+        return;
+    }
+
+    // Recursively traverse the left subtree
+    inOrderTraversal(nodeLeft(root));
+
+    // Print the current node
+    printPokemonNode(root);
+
+    // Recursively traverse the right subtree
+    inOrderTraversal(nodeRight(root));
+}
+
+// Recursive Post-Order Traversal (Left -> Right -> Root)
+void postOrderTraversal(PokemonNode* root) 
+{
+     if (root == NULL)
+    {
+        return;
+    }
+    // Recursively traverse the left subtree
+    postOrderTraversal(nodeLeft(root));
+
+    // Recursively traverse the right subtree
+    postOrderTraversal(nodeRight(root));
+
+    // Print the current node
+    printPokemonNode(root);
+}
+
+/**
+ * Displays Pokemon sorted alphabetically.
+ * Strategy: Collects all nodes into an array using BFS, then uses QuickSort (qsort).
+ */
+void displayAlphabetical(PokemonNode *root)
+{
+    if (root == NULL)
+    {
+        return;
+    }
+
+    // Create a queue for BFS
+    PokemonNode **queue = (PokemonNode **)memAlloc(MEM_SCRATCH, sizeof(PokemonNode *) * 1000);
+    if (queue == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed for BFS queue.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // Create an array to store the nodes for sorting
+    PokemonNode **nodes = (PokemonNode **)memAlloc(MEM_SCRATCH, sizeof(PokemonNode *) * 1000);
+    if (nodes == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed for nodes array.\n");
+        memFree(MEM_SCRATCH, queue);
+        exit(EXIT_FAILURE);
+    }
+
+    int front = 0, rear = 0, count = 0;
+
+    // Enqueue the root node
+    queue[rear++] = root;
+
+    while (front < rear)
+    {
+        // Dequeue a node
+        PokemonNode *current = queue[front++];
+
+        // Add the current node to the array for sorting
+        nodes[count++] = current;
+
+        // Enqueue left child if it exists
+        if (nodeLeft(current) != NULL)
+        {
+            queue[rear++] = nodeLeft(current);
+        }
+
+        // Enqueue right child if it exists
+        if (nodeRight(current) != NULL)
+        {
+            queue[rear++] = nodeRight(current);
+        }
+    }
+
+    // Sort the nodes alphabetically by name
+    qsort(nodes, count, sizeof(PokemonNode *), compareByNameNode);
+
+    // Display the sorted nodes
+    for (int i = 0; i < count; i++)
+    {
+        printPokemonNode(nodes[i]);
+    }
+
+    // Free allocated memory
+    memFree(MEM_SCRATCH, queue);
+    memFree(MEM_SCRATCH, nodes);
+}
+
+void initNodeArray(NodeArray *na, int cap)
+{
+    na->nodes = (PokemonNode **)memAlloc(MEM_SCRATCH, sizeof(PokemonNode *) * cap);
+    if (na->nodes == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed for NodeArray.\n");
+        exit(EXIT_FAILURE);
+    }
+    na->size = 0;
+    na->capacity = cap;
+}
+
+void addNode(NodeArray *na, PokemonNode *node)
+{
+    if (na->size == na->capacity)
+    {
+        na->capacity *= 2;
+        PokemonNode **temp = (PokemonNode **)memRealloc(MEM_SCRATCH, na->nodes, sizeof(PokemonNode *) * na->capacity);
+        if (temp == NULL)
+        {
+            fprintf(stderr, "Memory reallocation failed for NodeArray.\n");
+            exit(EXIT_FAILURE);
+        }
+        na->nodes = temp;
+    }
+    na->nodes[na->size++] = node;
+}
+
+void collectAll(PokemonNode *root, NodeArray *na)
+{
+    collectTraversal(root, TRAVERSAL_PRE_ORDER, na);
+}
+
+/**
+ * Appends the tree's nodes to na in the requested display order,
+ * so callers that don't write to stdout (sessions) can format them.
+ */
+void collectTraversal(PokemonNode *root, TraversalOrder order, NodeArray *na)
+{
+    if (root == NULL)
+    {
+        return;
+    }
+    switch (order)
+    {
+    case TRAVERSAL_BFS:
+    {
+        int front = na->size;
+        addNode(na, root);
+        while (front < na->size)
+        {
+            PokemonNode *current = na->nodes[front++];
+            if (nodeLeft(current) != NULL)
+                addNode(na, nodeLeft(current));
+            if (nodeRight(current) != NULL)
+                addNode(na, nodeRight(current));
+        }
+        break;
+    }
+    case TRAVERSAL_PRE_ORDER:
+        addNode(na, root);
+        collectTraversal(nodeLeft(root), order, na);
+        collectTraversal(nodeRight(root), order, na);
+        break;
+    case TRAVERSAL_IN_ORDER:
+        collectTraversal(nodeLeft(root), order, na);
+        addNode(na, root);
+        collectTraversal(nodeRight(root), order, na);
+        break;
+    case TRAVERSAL_POST_ORDER:
+        collectTraversal(nodeLeft(root), order, na);
+        collectTraversal(nodeRight(root), order, na);
+        addNode(na, root);
+        break;
+    case TRAVERSAL_ALPHABETICAL:
+    {
+        int start = na->size;
+        collectTraversal(root, TRAVERSAL_BFS, na);
+        qsort(na->nodes + start, na->size - start, sizeof(PokemonNode *), compareByNameNode);
+        break;
+    }
+    }
+}
+
+// Comparator for sorting Pokémon by their names
+int compareByNameNode(const void *a, const void *b)
+{
+    PokemonNode *nodeA = *(PokemonNode **)a;
+    PokemonNode *nodeB = *(PokemonNode **)b;
+    return strcmp(nodeData(nodeA)->name, nodeData(nodeB)->name);
+}
+
+
+/**
+ * Builds a height-balanced BST from nodes already sorted by ID.
+ * The middle node becomes the root, each half becomes a subtree.
+ */
+PokemonNode *buildBalancedFromSorted(PokemonNode **nodes, int lo, int hi)
+{
+    if (lo > hi)
+    {
+        return NULL;
+    }
+    int mid = lo + (hi - lo) / 2;
+    PokemonNode *root = nodes[mid];
+    setNodeLeft(root, buildBalancedFromSorted(nodes, lo, mid - 1));
+    setNodeRight(root, buildBalancedFromSorted(nodes, mid + 1, hi));
+    return root;
+}
+
+// Gives every species of a shared subtree a fresh private node in its slot.
+// Returns 0 as soon as a copy cannot be allocated.
+static int copySpeciesIntoSlots(PokemonNode *root, PokemonNode **slots)
+{
+    if (root == NULL)
+    {
+        return 1;
+    }
+    if (!copySpeciesIntoSlots(nodeLeft(root), slots))
+    {
+        return 0;
+    }
+    slots[root->speciesId] = createPokemonNode(nodeData(root));
+    return slots[root->speciesId] != NULL && copySpeciesIntoSlots(nodeRight(root), slots);
+}
+
+// Frees the copies copySpeciesIntoSlots made of a shared subtree.
+static void freeSpeciesCopies(PokemonNode *root, PokemonNode **slots)
+{
+    if (root == NULL)
+    {
+        return;
+    }
+    freeSpeciesCopies(nodeLeft(root), slots);
+    freePokemonTree(slots[root->speciesId]);
+    slots[root->speciesId] = NULL;
+    freeSpeciesCopies(nodeRight(root), slots);
+}
+
+/**
+ * Drops every node of the tree into its species slot (slots[id] = node).
+ * Private nodes are reused as-is since they are about to be relinked;
+ * a shared subtree keeps belonging to its other trees, so we take private
+ * copies of its nodes and list it in shared[] for the caller to release.
+ * Nothing is relinked or released here, so on failure (0) the tree is
+ * still whole once the copies in shared[] are freed.
+ */
+static int scatterBySpecies(PokemonNode *root, PokemonNode **slots, PokemonNode **shared, int *sharedCount)
+{
+    if (root == NULL)
+    {
+        return 1;
+    }
+    if (atomic_load(&root->refCount) > 1)
+    {
+        shared[(*sharedCount)++] = root;
+        return copySpeciesIntoSlots(root, slots);
+    }
+    if (!scatterBySpecies(nodeLeft(root), slots, shared, sharedCount))
+    {
+        return 0;
+    }
+    slots[root->speciesId] = root;
+    return scatterBySpecies(nodeRight(root), slots, shared, sharedCount);
+}
+
+static void speciesIndexAdd(OwnerNode *owner, int id);
+
+/**
+ * Adds a whole list of IDs at once.
+ * The ID domain is only 151 species, so a counting sort over species slots
+ * both sorts and deduplicates the input together with the nodes already in
+ * the tree; the merged sequence is then rebuilt into a balanced tree in O(n).
+ * Existing private nodes are reused, only new (or shared) species get a fresh node.
+ */
+int addPokemonBulk(OwnerNode *owner, const int *ids, int count)
+{
+    if (owner == NULL || ids == NULL)
+    {
+        return 0;
+    }
+
+    PokemonNode *slots[POKEDEX_SIZE + 1] = {NULL};
+    PokemonNode *shared[POKEDEX_SIZE];
+    int sharedCount = 0;
+    lockOwnerWrite(owner);
+    if (owner->mergedAway)
+    {
+        unlockOwner(owner);
+        return -POKEDEX_MERGED_AWAY;
+    }
+    if (!scatterBySpecies(owner->pokedexRoot, slots, shared, &sharedCount))
+    {
+        // The tree is untouched; only the copies made so far go
+        for (int i = 0; i < sharedCount; i++)
+        {
+            freeSpeciesCopies(shared[i], slots);
+        }
+        unlockOwner(owner);
+        return -POKEDEX_NO_MEMORY;
+    }
+    // Every shared species has a private copy now; drop our references to the originals
+    for (int i = 0; i < sharedCount; i++)
+    {
+        freePokemonTree(shared[i]);
+    }
+
+    int added = 0;
+    for (int i = 0; i < count; i++)
+    {
+        int id = ids[i];
+        if (id <= 0 || id > POKEDEX_SIZE || slots[id] != NULL)
+        {
+            continue;
+        }
+        PokemonNode *node = createPokemonNode(&pokedex[id - 1]);
+        if (node == NULL)
+        {
+            break;
+        }
+        slots[id] = node;
+        speciesIndexAdd(owner, id);
+        added++;
+    }
+
+    // Compact the species slots into one sorted run
+    PokemonNode *sorted[POKEDEX_SIZE];
+    int total = 0;
+    for (int id = 1; id <= POKEDEX_SIZE; id++)
+    {
+        if (slots[id] != NULL)
+        {
+            sorted[total++] = slots[id];
+        }
+    }
+
+    owner->pokedexRoot = buildBalancedFromSorted(sorted, 0, total - 1);
+    unlockOwner(owner);
+    return added;
+}
+
+// Name characters: letters plus the '.' and '\'' of "Mr. Mime" and "Farfetch'd"
+static int isNameChar(char c)
+{
+    return isalpha((unsigned char)c) || c == '.' || c == '\'';
+}
+
+/**
+ * Cursor tokenizer over a bulk-add line: reads the entry at *cursor into *id
+ * and moves the cursor past it. Allocates nothing. Returns 0 when no entry
+ * is left; an unknown name or out-of-range number yields an ID of 0.
+ */
+int nextIdInList(const char **cursor, const char *end, int *id)
+{
+    const char *p = *cursor;
+    while (p < end && !isdigit((unsigned char)*p) && !isNameChar(*p) &&
+           !(*p == '-' && p + 1 < end && isdigit((unsigned char)p[1])))
+    {
+        p++;
+    }
+    if (p == end)
+    {
+        *cursor = p;
+        return 0;
+    }
+
+    if (isNameChar(*p))
+    {
+        // Longest run of words, then shorter prefixes of it ("Mr. Mime Pikachu")
+        const char *firstWordEnd = p;
+        while (firstWordEnd < end && isNameChar(*firstWordEnd))
+            firstWordEnd++;
+        const char *runEnd = firstWordEnd;
+        while (runEnd < end && (*runEnd == ' ' || *runEnd == '\t'))
+        {
+            const char *word = runEnd;
+            while (word < end && (*word == ' ' || *word == '\t'))
+                word++;
+            if (word == end || !isNameChar(*word))
+                break;
+            while (word < end && isNameChar(*word))
+                word++;
+            runEnd = word;
+        }
+        for (const char *candidate = runEnd; candidate >= firstWordEnd; candidate--)
+        {
+            if (candidate != runEnd && !(isNameChar(candidate[-1]) && !isNameChar(*candidate)))
+            {
+                continue; // Only try word boundaries
+            }
+            int species = speciesIdBySlice(p, (size_t)(candidate - p));
+            if (species != 0)
+            {
+                *cursor = candidate;
+                *id = species;
+                return 1;
+            }
+        }
+        // Unknown word: one invalid entry
+        *cursor = firstWordEnd;
+        *id = 0;
+        return 1;
+    }
+
+    int negative = (*p == '-');
+    p += negative;
+    long value = 0;
+    for (; p < end && isdigit((unsigned char)*p); p++)
+    {
+        // Anything past the table is just "invalid"; stop growing early
+        if (value <= POKEDEX_SIZE)
+        {
+            value = value * 10 + (*p - '0');
+        }
+    }
+    *cursor = p;
+    // Out-of-range IDs become 0 so callers can count and then skip them
+    *id = (negative || value > POKEDEX_SIZE) ? 0 : (int)value;
+    return 1;
+}
+
+/**
+ * Parses a line like "1 4, 7 Pikachu, Mr. Mime" into a malloc'd array of IDs.
+ * Numbers are digit runs; names are runs of name characters, possibly several
+ * words. Anything else separates two entries.
+ */
+int *parseIdList(const char *line, int *outCount)
+{
+    *outCount = 0;
+    int capacity = 16;
+    int *ids = (int *)memAlloc(MEM_SCRATCH, sizeof(int) * capacity);
+    if (ids == NULL)
+    {
+        printf("Memory allocation failed.\n");
+        return NULL;
+    }
+
+    const char *end = line + strlen(line);
+    int id;
+    while (nextIdInList(&line, end, &id))
+    {
+        if (*outCount == capacity)
+        {
+            capacity *= 2;
+            int *temp = (int *)memRealloc(MEM_SCRATCH, ids, sizeof(int) * capacity);
+            if (temp == NULL)
+            {
+                printf("Memory reallocation failed.\n");
+                memFree(MEM_SCRATCH, ids);
+                *outCount = 0;
+                return NULL;
+            }
+            ids = temp;
+        }
+        ids[(*outCount)++] = id;
+    }
+    return ids;
+}
+/**
+ * Keeps the distinct valid IDs of a list, in order, in ids (room for POKEDEX_SIZE).
+ * Returns how many were kept; *given receives how many IDs the list had.
+ */
+static int collectDistinctIds(const char *line, const char *end, int *ids, int *given)
+{
+    unsigned char seen[POKEDEX_SIZE + 1] = {0};
+    int count = 0, id;
+    *given = 0;
+    while (nextIdInList(&line, end, &id))
+    {
+        (*given)++;
+        if (id >= 1 && !seen[id])
+        {
+            seen[id] = 1;
+            ids[count++] = id;
+        }
+    }
+    return count;
+}
+
+// Helper: Finds the minimum value node in a BST (leftmost child)
+PokemonNode* findMin(PokemonNode* node) 
+{
+    while (nodeLeft(node) != NULL) 
+    {
+        node = nodeLeft(node);
+    }
+    return node;
+}
+
+/**
+ * Deletes a node from the BST while maintaining BST properties.
+ * Handles 3 cases:
+ * 1. Node is leaf (no children).
+ * 2. Node has one child.
+ * 3. Node has two children (the in-order successor node takes its place).
+ */
+static PokemonNode *detachPokemonNode(PokemonNode **root, int id);
+
+PokemonNode* deletePokemonNode(PokemonNode* root, int id)
+{
+    unsigned long visited;
+    unsigned long long start = metricsStart(METRIC_DELETE);
+    // Only walk (and path-copy) when the ID is really there
+    if (findPokemonWithDepth(root, id, &visited) != NULL)
+    {
+        freePokemonNode(detachPokemonNode(&root, id));
+    }
+    metricsStop(METRIC_DELETE, start, visited);
+    return root;
+}
+
+// Points parent's left or right link, or *root when parent is NULL, at child
+static void setChildLink(PokemonNode **root, PokemonNode *parent, int left, PokemonNode *child)
+{
+    if (parent == NULL)
+    {
+        *root = child;
+    }
+    else if (left)
+    {
+        setNodeLeft(parent, child);
+    }
+    else
+    {
+        setNodeRight(parent, child);
+    }
+}
+
+/**
+ * Unlinks the node holding id (which must be in the tree) and returns it,
+ * private and childless, for the caller to free or reuse. Iterative, and
+ * nothing is copied: with two children, the in-order successor node itself
+ * is spliced into the removed node's place. Nodes whose links change are
+ * made writable first, so only a shared tree allocates (its path copies).
+ */
+static PokemonNode *detachPokemonNode(PokemonNode **root, int id)
+{
+    PokemonNode *parent = NULL;
+    int left = 0;
+    PokemonNode *node = makeNodeWritable(*root);
+    *root = node;
+    while (node->speciesId != id)
+    {
+        parent = node;
+        left = id < node->speciesId;
+        node = makeNodeWritable(left ? nodeLeft(node) : nodeRight(node));
+        setChildLink(root, parent, left, node);
+    }
+
+    PokemonNode *replacement;
+    if (node->left == 0)
+    {
+        replacement = nodeRight(node);
+    }
+    else if (node->right == 0)
+    {
+        replacement = nodeLeft(node);
+    }
+    else
+    {
+        // Leftmost node of the right subtree, and the node above it
+        PokemonNode *successorParent = node;
+        PokemonNode *successor = makeNodeWritable(nodeRight(node));
+        setNodeRight(node, successor);
+        while (successor->left != 0)
+        {
+            successorParent = successor;
+            successor = makeNodeWritable(nodeLeft(successor));
+            setNodeLeft(successorParent, successor);
+        }
+        if (successorParent != node)
+        {
+            // The successor's right subtree takes its old spot
+            setNodeLeft(successorParent, nodeRight(successor));
+            setNodeRight(successor, nodeRight(node));
+        }
+        setNodeLeft(successor, nodeLeft(node));
+        replacement = successor;
+    }
+    setChildLink(root, parent, left, replacement);
+    setNodeLeft(node, NULL);
+    setNodeRight(node, NULL);
+    return node;
+}
+
+// --------------------------------------------------------------
+// Thread-safe core operations
+// Every function here takes the owner's dexLock itself and never
+// prints or reads input, so menus, benchmarks and other sessions
+// can all drive the same code concurrently.
+// --------------------------------------------------------------
+
+// Owner this thread holds for writing; tree nodes allocated meanwhile are charged to it
+static _Thread_local OwnerNode *memOwnerContext = NULL;
+
+static void dropFrozenDex(OwnerNode *owner);
+
+void lockOwnerRead(OwnerNode *owner)
+{
+    pthread_rwlock_rdlock(&owner->dexLock);
+}
+
+void lockOwnerWrite(OwnerNode *owner)
+{
+    pthread_rwlock_wrlock(&owner->dexLock);
+    memOwnerContext = owner;
+    // Every write may change the tree: the frozen copy and the read streak go
+    dropFrozenDex(owner);
+}
+
+void unlockOwner(OwnerNode *owner)
+{
+    if (memOwnerContext == owner)
+    {
+        memOwnerContext = NULL;
+    }
+    pthread_rwlock_unlock(&owner->dexLock);
+}
+
+int pokedexIsEmpty(OwnerNode *owner)
+{
+    lockOwnerRead(owner);
+    int empty = (owner->pokedexRoot == NULL);
+    unlockOwner(owner);
+    return empty;
+}
+
+//========================================
+// Frozen Pokedexes (Eytzinger layout)
+// A read-mostly tree is copied into keys[1..count]: the sorted species IDs
+// laid out like a heap (children of k at 2k and 2k + 1), so the top levels
+// share a cache line and a search is one predictable loop with no branch on
+// the comparison. Readers build it once treeReads reaches the threshold;
+// the first to publish wins. Only a writer (exclusive lock, so no reader
+// can be looking at it) frees it.
+//========================================
+
+typedef struct FrozenDex
+{
+    int count;
+    uint8_t keys[]; // keys[0] unused
+} FrozenDex;
+
+static atomic_int frozenDexThreshold = 16;
+
+void setFrozenDexThreshold(int reads)
+{
+    atomic_store(&frozenDexThreshold, reads < 0 ? 0 : reads);
+}
+
+int getFrozenDexThreshold(void)
+{
+    return atomic_load(&frozenDexThreshold);
+}
+
+static void dropFrozenDex(OwnerNode *owner)
+{
+    memFree(MEM_INDEXES, atomic_exchange_explicit(&owner->frozenDex, NULL, memory_order_relaxed));
+    atomic_store_explicit(&owner->treeReads, 0, memory_order_relaxed);
+}
+
+// In-order position i goes to Eytzinger slot k
+static void fillEytzinger(const uint8_t *sorted, int *next, FrozenDex *dex, int k)
+{
+    if (k <= dex->count)
+    {
+        fillEytzinger(sorted, next, dex, 2 * k);
+        dex->keys[k] = sorted[(*next)++];
+        fillEytzinger(sorted, next, dex, 2 * k + 1);
+    }
+}
+
+// Caller holds the read lock
+static FrozenDex *freezeDex(PokemonNode *root)
+{
+    // Presence by species, then read back in ID order
+    uint8_t owned[POKEDEX_SIZE + 1] = {0};
+    PokemonNode *stack[POKEDEX_SIZE + 1];
+    int top = 0, count = 0;
+    if (root != NULL)
+    {
+        stack[top++] = root;
+    }
+    while (top > 0)
+    {
+        PokemonNode *node = stack[--top];
+        owned[node->speciesId] = 1;
+        count++;
+        if (node->left != 0)
+        {
+            stack[top++] = nodeLeft(node);
+        }
+        if (node->right != 0)
+        {
+            stack[top++] = nodeRight(node);
+        }
+    }
+    uint8_t sorted[POKEDEX_SIZE];
+    int n = 0;
+    for (int id = 1; id <= POKEDEX_SIZE; id++)
+    {
+        if (owned[id])
+        {
+            sorted[n++] = (uint8_t)id;
+        }
+    }
+
+    FrozenDex *dex = (FrozenDex *)memAlloc(MEM_INDEXES, sizeof(FrozenDex) + (size_t)count + 1);
+    if (dex == NULL)
+    {
+        return NULL;
+    }
+    dex->count = count;
+    dex->keys[0] = 0;
+    int next = 0;
+    fillEytzinger(sorted, &next, dex, 1);
+    return dex;
+}
+
+static int frozenDexContains(const FrozenDex *dex, int id, unsigned long *visited)
+{
+    unsigned k = 1;
+    unsigned long steps = 0;
+    while (k <= (unsigned)dex->count)
+    {
+        // Four levels down is 16 slots on: one line ahead of the search
+        __builtin_prefetch(dex->keys + 16 * k);
+        k = 2 * k + (dex->keys[k] < id);
+        steps++;
+    }
+    // Undo the right turns taken after the last left turn: that node is the lower bound
+    k >>= __builtin_ffs(~k);
+    *visited = steps;
+    return k != 0 && dex->keys[k] == id;
+}
+
+// Caller holds the read lock. Uses (or builds) the frozen copy when the owner is read-mostly.
+static const PokemonData *lookupSpeciesLocked(OwnerNode *owner, int id)
+{
+    if (id <= 0 || id > POKEDEX_SIZE)
+    {
+        return NULL;
+    }
+    FrozenDex *dex = atomic_load_explicit(&owner->frozenDex, memory_order_acquire);
+    if (dex == NULL)
+    {
+        int threshold = atomic_load_explicit(&frozenDexThreshold, memory_order_relaxed);
+        unsigned reads = atomic_fetch_add_explicit(&owner->treeReads, 1, memory_order_relaxed) + 1;
+        if (threshold == 0 || reads < (unsigned)threshold)
+        {
+            PokemonNode *node = findPokemonBST(owner->pokedexRoot, id);
+            return node != NULL ? nodeData(node) : NULL;
+        }
+        // Read-mostly now: freeze the tree (concurrent readers may race; one copy wins)
+        FrozenDex *built = freezeDex(owner->pokedexRoot);
+        if (built == NULL)
+        {
+            PokemonNode *node = findPokemonBST(owner->pokedexRoot, id);
+            return node != NULL ? nodeData(node) : NULL;
+        }
+        FrozenDex *expected = NULL;
+        if (!atomic_compare_exchange_strong_explicit(&owner->frozenDex, &expected, built, memory_order_acq_rel,
+                                                     memory_order_acquire))
+        {
+            memFree(MEM_INDEXES, built);
+            built = expected;
+        }
+        dex = built;
+    }
+
+    unsigned long visited;
+    unsigned long long start = metricsStart(METRIC_SEARCH);
+    int found = frozenDexContains(dex, id, &visited);
+    metricsStop(METRIC_SEARCH, start, visited);
+    return found ? &pokedex[id - 1] : NULL;
+}
+
+int pokedexHasPokemon(OwnerNode *owner, int id)
+{
+    lockOwnerRead(owner);
+    int found = lookupSpeciesLocked(owner, id) != NULL;
+    unlockOwner(owner);
+    return found;
+}
+
+//========================================
+// Strength Leaderboard (indexable skip list)
+// Every indexed owner, strongest first (ties by name, then address).
+// Strength is kept in tenths of a point, attack * 15 + hp * 12 per
+// species, so totals are exact integers that never drift. Every link also
+// records its span, the level-0 steps it jumps, so a search can count
+// positions on the way down: rank and "the Nth owner" are O(log n).
+// The species index hooks move an owner whenever its total changes;
+// leaderboardLock is always taken last.
+//========================================
+
+#define LEADERBOARD_MAX_LEVEL 16
+
+typedef struct LeaderboardNode
+{
+    OwnerNode *owner;
+    long strength; // owner->strength while the node is placed
+    int level;
+    struct
+    {
+        struct LeaderboardNode *next;
+        int span; // Level-0 steps to next (or to past the end)
+    } links[];
+} LeaderboardNode;
+
+static LeaderboardNode *leaderboardHead; // Sentinel with every level, allocated on first use
+static int leaderboardLevel = 1;
+static int leaderboardCount;
+static unsigned long long leaderboardRandom = 0xD1B54A32D192ED03ULL;
+static pthread_mutex_t leaderboardLock = PTHREAD_MUTEX_INITIALIZER;
+
+static long speciesStrength(int id)
+{
+    return pokedex[id - 1].attack * 15L + pokedex[id - 1].hp * 12L;
+}
+
+static int leaderboardRandomLevel(void)
+{
+    // xorshift64; two random bits per level gives p = 1/4
+    leaderboardRandom ^= leaderboardRandom << 13;
+    leaderboardRandom ^= leaderboardRandom >> 7;
+    leaderboardRandom ^= leaderboardRandom << 17;
+    unsigned long long bits = leaderboardRandom;
+    int level = 1;
+    while (level < LEADERBOARD_MAX_LEVEL && (bits & 3) == 0)
+    {
+        level++;
+        bits >>= 2;
+    }
+    return level;
+}
+
+// Whether node ranks ahead of an owner with this strength
+static int leaderboardAhead(const LeaderboardNode *node, long strength, const OwnerNode *owner)
+{
+    if (node->strength != strength)
+    {
+        return node->strength > strength;
+    }
+    int order = strcmp(node->owner->ownerName, owner->ownerName);
+    return order != 0 ? order < 0 : node->owner < owner;
+}
+
+// Fills update[] with the last node ahead of (strength, owner) on every level, rank[] with their positions
+static void leaderboardSearch(long strength, const OwnerNode *owner, LeaderboardNode **update, int *rank)
+{
+    LeaderboardNode *node = leaderboardHead;
+    int position = 0;
+    for (int level = leaderboardLevel - 1; level >= 0; level--)
+    {
+        while (node->links[level].next != NULL && leaderboardAhead(node->links[level].next, strength, owner))
+        {
+            position += node->links[level].span;
+            node = node->links[level].next;
+        }
+        update[level] = node;
+        rank[level] = position;
+    }
+}
+
+// Caller holds leaderboardLock
+static void leaderboardPlace(LeaderboardNode *node)
+{
+    LeaderboardNode *update[LEADERBOARD_MAX_LEVEL];
+    int rank[LEADERBOARD_MAX_LEVEL];
+    leaderboardSearch(node->strength, node->owner, update, rank);
+    for (; leaderboardLevel < node->level; leaderboardLevel++)
+    {
+        update[leaderboardLevel] = leaderboardHead;
+        rank[leaderboardLevel] = 0;
+        leaderboardHead->links[leaderboardLevel].span = leaderboardCount;
+    }
+    for (int i = 0; i < node->level; i++)
+    {
+        node->links[i].next = update[i]->links[i].next;
+        update[i]->links[i].next = node;
+        node->links[i].span = update[i]->links[i].span - (rank[0] - rank[i]);
+        update[i]->links[i].span = rank[0] - rank[i] + 1;
+    }
+    for (int i = node->level; i < leaderboardLevel; i++)
+    {
+        update[i]->links[i].span++;
+    }
+    leaderboardCount++;
+}
+
+// Caller holds leaderboardLock
+static void leaderboardUnplace(LeaderboardNode *node)
+{
+    LeaderboardNode *update[LEADERBOARD_MAX_LEVEL];
+    int rank[LEADERBOARD_MAX_LEVEL];
+    leaderboardSearch(node->strength, node->owner, update, rank);
+    for (int i = 0; i < leaderboardLevel; i++)
+    {
+        if (update[i]->links[i].next == node)
+        {
+            update[i]->links[i].span += node->links[i].span - 1;
+            update[i]->links[i].next = node->links[i].next;
+        }
+        else
+        {
+            update[i]->links[i].span--;
+        }
+    }
+    while (leaderboardLevel > 1 && leaderboardHead->links[leaderboardLevel - 1].next == NULL)
+    {
+        leaderboardLevel--;
+    }
+    leaderboardCount--;
+}
+
+// Caller holds the owner's write lock. A listed owner moves to its new place; nothing is allocated.
+static void leaderboardAdjust(OwnerNode *owner, long delta)
+{
+    pthread_mutex_lock(&leaderboardLock);
+    LeaderboardNode *node = owner->boardEntry;
+    if (node != NULL)
+    {
+        leaderboardUnplace(node);
+        node->strength += delta;
+        leaderboardPlace(node);
+    }
+    owner->strength += delta;
+    pthread_mutex_unlock(&leaderboardLock);
+}
+
+// The owner is being indexed and its strength is complete. Out of memory leaves it off the board.
+static void leaderboardAdd(OwnerNode *owner)
+{
+    pthread_mutex_lock(&leaderboardLock);
+    if (leaderboardHead == NULL)
+    {
+        leaderboardHead = (LeaderboardNode *)memCalloc(MEM_INDEXES, 1, sizeof(LeaderboardNode) +
+                                                       LEADERBOARD_MAX_LEVEL * sizeof(leaderboardHead->links[0]));
+    }
+    int level = leaderboardRandomLevel();
+    LeaderboardNode *node = (leaderboardHead == NULL)
+                                ? NULL
+                                : (LeaderboardNode *)memAlloc(MEM_INDEXES, sizeof(LeaderboardNode) +
+                                                                               level * sizeof(node->links[0]));
+    if (node != NULL)
+    {
+        node->owner = owner;
+        node->strength = owner->strength;
+        node->level = level;
+        leaderboardPlace(node);
+        owner->boardEntry = node;
+    }
+    pthread_mutex_unlock(&leaderboardLock);
+}
+
+static void leaderboardDrop(OwnerNode *owner)
+{
+    pthread_mutex_lock(&leaderboardLock);
+    LeaderboardNode *node = owner->boardEntry;
+    if (node != NULL)
+    {
+        leaderboardUnplace(node);
+        memFree(MEM_INDEXES, node);
+        owner->boardEntry = NULL;
+        if (leaderboardCount == 0)
+        {
+            memFree(MEM_INDEXES, leaderboardHead);
+            leaderboardHead = NULL;
+            leaderboardLevel = 1;
+        }
+    }
+    pthread_mutex_unlock(&leaderboardLock);
+}
+
+double ownerStrength(OwnerNode *owner)
+{
+    pthread_mutex_lock(&leaderboardLock);
+    long strength = owner->strength;
+    pthread_mutex_unlock(&leaderboardLock);
+    return strength / 10.0;
+}
+
+int ownerStrengthRank(OwnerNode *owner)
+{
+    int position = 0;
+    pthread_mutex_lock(&leaderboardLock);
+    LeaderboardNode *node = owner->boardEntry;
+    if (node != NULL)
+    {
+        LeaderboardNode *update[LEADERBOARD_MAX_LEVEL];
+        int rank[LEADERBOARD_MAX_LEVEL];
+        leaderboardSearch(node->strength, owner, update, rank);
+        position = rank[0] + 1;
+    }
+    pthread_mutex_unlock(&leaderboardLock);
+    return position;
+}
+
+int strongestOwners(int firstRank, OwnerNode **owners, double *strengths, int limit)
+{
+    if (firstRank < 1)
+    {
+        firstRank = 1;
+    }
+    int found = 0;
+    pthread_mutex_lock(&leaderboardLock);
+    if (leaderboardHead != NULL && firstRank <= leaderboardCount)
+    {
+        // Descend by spans to the node at position firstRank
+        LeaderboardNode *node = leaderboardHead;
+        int position = 0;
+        for (int level = leaderboardLevel - 1; level >= 0; level--)
+        {
+            while (node->links[level].next != NULL && position + node->links[level].span <= firstRank)
+            {
+                position += node->links[level].span;
+                node = node->links[level].next;
+            }
+        }
+        for (; node != NULL && found < limit; node = node->links[0].next)
+        {
+            // Listed owners are linked: the ring's reference keeps these pins from failing
+            if (tryAcquireOwner(node->owner))
+            {
+                owners[found] = node->owner;
+                if (strengths != NULL)
+                {
+                    strengths[found] = node->strength / 10.0;
+                }
+                found++;
+            }
+        }
+    }
+    pthread_mutex_unlock(&leaderboardLock);
+    return found;
+}
+
+//========================================
+// Species Index
+// For every species, the linked owners that have it: an unordered array,
+// plus each owner's slot in every array (speciesSlots, -1 if absent), so
+// adding and removing are O(1) swaps. Linking an owner indexes its whole
+// tree and unlinking drops it; in between, the core operations update it
+// under the owner's write lock. Each species list has its own rwlock,
+// always taken last (inside any dexLock).
+//========================================
+
+typedef struct
+{
+    pthread_rwlock_t lock;
+    OwnerNode **owners;
+    int count;
+    int capacity;
+} SpeciesPostings;
+
+static SpeciesPostings speciesPostings[POKEDEX_SIZE + 1];
+static pthread_once_t speciesPostingsOnce = PTHREAD_ONCE_INIT;
+
+// Collection bitsets: bit id - 1 of row bitsRow is set when that owner has
+// the species. Rows are packed (an unlinked owner's row is filled by the
+// last one), so a similarity scan streams through one array. Bits change
+// under the table's read lock with atomic or/and; rows come and go under
+// its write lock.
+#define SPECIES_WORDS ((POKEDEX_SIZE + 63) / 64)
+
+typedef struct
+{
+    _Atomic uint64_t words[SPECIES_WORDS];
+} SpeciesBits;
+
+static SpeciesBits *collectionBits;
+static OwnerNode **collectionOwners; // Owner of each row
+static int collectionCount;
+static int collectionCapacity;
+static pthread_rwlock_t collectionLock = PTHREAD_RWLOCK_INITIALIZER;
+
+// Caller holds the owner's write lock
+static void collectionBitsUpdate(OwnerNode *owner, int id, int owned)
+{
+    uint64_t bit = 1ULL << ((id - 1) & 63);
+    pthread_rwlock_rdlock(&collectionLock);
+    if (owner->bitsRow >= 0)
+    {
+        _Atomic uint64_t *word = &collectionBits[owner->bitsRow].words[(id - 1) >> 6];
+        if (owned)
+        {
+            atomic_fetch_or_explicit(word, bit, memory_order_relaxed);
+        }
+        else
+        {
+            atomic_fetch_and_explicit(word, ~bit, memory_order_relaxed);
+        }
+    }
+    pthread_rwlock_unlock(&collectionLock);
+}
+
+// Caller holds the owner's write lock; its speciesSlots are complete. Out of memory leaves it rowless.
+static void collectionBitsAttach(OwnerNode *owner)
+{
+    pthread_rwlock_wrlock(&collectionLock);
+    if (collectionCount == collectionCapacity)
+    {
+        int capacity = collectionCapacity ? collectionCapacity * 2 : 64;
+        SpeciesBits *bits =
+            (SpeciesBits *)memRealloc(MEM_INDEXES, collectionBits, (size_t)capacity * sizeof(SpeciesBits));
+        if (bits != NULL)
+        {
+            collectionBits = bits;
+        }
+        OwnerNode **rowOwners = (bits == NULL) ? NULL
+                                               : (OwnerNode **)memRealloc(MEM_INDEXES, collectionOwners,
+                                                                          (size_t)capacity * sizeof(OwnerNode *));
+        if (rowOwners == NULL)
+        {
+            pthread_rwlock_unlock(&collectionLock);
+            return;
+        }
+        collectionOwners = rowOwners;
+        collectionCapacity = capacity;
+    }
+    int row = collectionCount++;
+    for (int w = 0; w < SPECIES_WORDS; w++)
+    {
+        uint64_t word = 0;
+        for (int bit = 0; bit < 64 && w * 64 + bit < POKEDEX_SIZE; bit++)
+        {
+            word |= (uint64_t)(owner->speciesSlots[w * 64 + bit + 1] >= 0) << bit;
+        }
+        atomic_store_explicit(&collectionBits[row].words[w], word, memory_order_relaxed);
+    }
+    collectionOwners[row] = owner;
+    owner->bitsRow = row;
+    pthread_rwlock_unlock(&collectionLock);
+}
+
+static void collectionBitsDetach(OwnerNode *owner)
+{
+    pthread_rwlock_wrlock(&collectionLock);
+    int row = owner->bitsRow;
+    if (row >= 0)
+    {
+        int last = --collectionCount;
+        for (int w = 0; w < SPECIES_WORDS; w++)
+        {
+            atomic_store_explicit(&collectionBits[row].words[w],
+                                  atomic_load_explicit(&collectionBits[last].words[w], memory_order_relaxed),
+                                  memory_order_relaxed);
+        }
+        collectionOwners[row] = collectionOwners[last];
+        collectionOwners[row]->bitsRow = row;
+        owner->bitsRow = -1;
+        if (collectionCount == 0)
+        {
+            memFree(MEM_INDEXES, collectionBits);
+            memFree(MEM_INDEXES, collectionOwners);
+            collectionBits = NULL;
+            collectionOwners = NULL;
+            collectionCapacity = 0;
+        }
+    }
+    pthread_rwlock_unlock(&collectionLock);
+}
+
+static void initSpeciesPostings(void)
+{
+    for (int id = 1; id <= POKEDEX_SIZE; id++)
+    {
+        pthread_rwlock_init(&speciesPostings[id].lock, NULL);
+    }
+}
+
+// Caller holds the owner's write lock. Nothing happens if it's unindexed or already listed.
+static void speciesIndexAdd(OwnerNode *owner, int id)
+{
+    int *slots = owner->speciesSlots;
+    if (slots == NULL)
+    {
+        return;
+    }
+    SpeciesPostings *list = &speciesPostings[id];
+    int added = 0;
+    pthread_rwlock_wrlock(&list->lock);
+    if (slots[id] < 0)
+    {
+        if (list->count == list->capacity)
+        {
+            int capacity = list->capacity ? list->capacity * 2 : 8;
+            OwnerNode **grown =
+                (OwnerNode **)memRealloc(MEM_INDEXES, list->owners, (size_t)capacity * sizeof(OwnerNode *));
+            if (grown == NULL)
+            {
+                fprintf(stderr, "Memory allocation failed for the species index.\n");
+                exit(EXIT_FAILURE);
+            }
+            list->owners = grown;
+            list->capacity = capacity;
+        }
+        slots[id] = list->count;
+        list->owners[list->count++] = owner;
+        added = 1;
+    }
+    pthread_rwlock_unlock(&list->lock);
+    collectionBitsUpdate(owner, id, 1);
+    if (added)
+    {
+        leaderboardAdjust(owner, speciesStrength(id));
+    }
+}
+
+// Caller holds the owner's write lock.
+static void speciesIndexRemove(OwnerNode *owner, int id)
+{
+    int *slots = owner->speciesSlots;
+    if (slots == NULL)
+    {
+        return;
+    }
+    SpeciesPostings *list = &speciesPostings[id];
+    pthread_rwlock_wrlock(&list->lock);
+    int slot = slots[id];
+    if (slot >= 0)
+    {
+        // The last owner fills the hole
+        OwnerNode *moved = list->owners[--list->count];
+        list->owners[slot] = moved;
+        moved->speciesSlots[id] = slot;
+        slots[id] = -1;
+        if (list->count == 0)
+        {
+            memFree(MEM_INDEXES, list->owners);
+            list->owners = NULL;
+            list->capacity = 0;
+        }
+    }
+    pthread_rwlock_unlock(&list->lock);
+    collectionBitsUpdate(owner, id, 0);
+    if (slot >= 0)
+    {
+        leaderboardAdjust(owner, -speciesStrength(id));
+    }
+}
+
+// The owner is being linked: index everything it has. Out of memory leaves it unindexed.
+static void speciesIndexOwner(OwnerNode *owner)
+{
+    pthread_once(&speciesPostingsOnce, initSpeciesPostings);
+    lockOwnerWrite(owner);
+    if (owner->speciesSlots == NULL)
+    {
+        owner->speciesSlots = (int *)memAlloc(MEM_INDEXES, (POKEDEX_SIZE + 1) * sizeof(int));
+        if (owner->speciesSlots != NULL)
+        {
+            for (int id = 0; id <= POKEDEX_SIZE; id++)
+            {
+                owner->speciesSlots[id] = -1;
+            }
+            PokemonNode *stack[POKEDEX_SIZE + 1];
+            int top = 0;
+            if (owner->pokedexRoot != NULL)
+            {
+                stack[top++] = owner->pokedexRoot;
+            }
+            while (top > 0)
+            {
+                PokemonNode *node = stack[--top];
+                speciesIndexAdd(owner, node->speciesId);
+                if (node->left != 0)
+                {
+                    stack[top++] = nodeLeft(node);
+                }
+                if (node->right != 0)
+                {
+                    stack[top++] = nodeRight(node);
+                }
+            }
+            collectionBitsAttach(owner);
+            leaderboardAdd(owner);
+        }
+    }
+    unlockOwner(owner);
+}
+
+// The owner has been unlinked: take it out of every species list.
+static void speciesUnindexOwner(OwnerNode *owner)
+{
+    lockOwnerWrite(owner);
+    if (owner->speciesSlots != NULL)
+    {
+        leaderboardDrop(owner);
+        collectionBitsDetach(owner);
+        for (int id = 1; id <= POKEDEX_SIZE; id++)
+        {
+            if (owner->speciesSlots[id] >= 0)
+            {
+                speciesIndexRemove(owner, id);
+            }
+        }
+        memFree(MEM_INDEXES, owner->speciesSlots);
+        owner->speciesSlots = NULL;
+    }
+    unlockOwner(owner);
+}
+
+int countOwnersWithSpecies(int id)
+{
+    if (id <= 0 || id > POKEDEX_SIZE)
+    {
+        return 0;
+    }
+    pthread_once(&speciesPostingsOnce, initSpeciesPostings);
+    SpeciesPostings *list = &speciesPostings[id];
+    pthread_rwlock_rdlock(&list->lock);
+    int count = list->count;
+    pthread_rwlock_unlock(&list->lock);
+    return count;
+}
+
+int ownersWithSpecies(int id, OwnerNode **owners, int limit)
+{
+    return ownersWithAllSpecies(&id, 1, owners, limit);
+}
+
+int ownersWithAllSpecies(const int *ids, int count, OwnerNode **owners, int limit)
+{
+    unsigned char wanted[POKEDEX_SIZE + 1] = {0};
+    int distinct = 0;
+    for (int i = 0; i < count; i++)
+    {
+        if (ids[i] <= 0 || ids[i] > POKEDEX_SIZE)
+        {
+            return 0;
+        }
+        distinct += !wanted[ids[i]];
+        wanted[ids[i]] = 1;
+    }
+    if (distinct == 0)
+    {
+        return 0;
+    }
+    pthread_once(&speciesPostingsOnce, initSpeciesPostings);
+
+    // Read-lock every list in ID order; listed owners can't be unindexed meanwhile
+    int species[POKEDEX_SIZE];
+    int shortest = 0;
+    distinct = 0;
+    for (int id = 1; id <= POKEDEX_SIZE; id++)
+    {
+        if (wanted[id])
+        {
+            pthread_rwlock_rdlock(&speciesPostings[id].lock);
+            if (distinct == 0 || speciesPostings[id].count < speciesPostings[species[shortest]].count)
+            {
+                shortest = distinct;
+            }
+            species[distinct++] = id;
+        }
+    }
+
+    int found = 0;
+    const SpeciesPostings *list = &speciesPostings[species[shortest]];
+    for (int i = 0; i < list->count && found < limit; i++)
+    {
+        OwnerNode *owner = list->owners[i];
+        int hasAll = 1;
+        for (int k = 0; k < distinct && hasAll; k++)
+        {
+            hasAll = owner->speciesSlots[species[k]] >= 0;
+        }
+        // Indexed owners are linked, so the ring's reference keeps this from failing
+        if (hasAll && tryAcquireOwner(owner))
+        {
+            owners[found++] = owner;
+        }
+    }
+
+    for (int k = distinct - 1; k >= 0; k--)
+    {
+        pthread_rwlock_unlock(&speciesPostings[species[k]].lock);
+    }
+    return found;
+}
+
+// Scores every row against mine into the best-first top list (rows[], best[], *found <= limit).
+// Built twice: with the POPCNT instruction where the CPU has it, and portable. The
+// clones are picked by an ifunc resolver that runs before ThreadSanitizer starts up,
+// so TSan builds keep the portable one.
+#if defined(__x86_64__) && !defined(__SANITIZE_THREAD__)
+__attribute__((target_clones("popcnt", "default")))
+#endif
+static void scanCollections(const uint64_t *mine, int skipRow, SimilarityMetric metric, int *rows, double *best,
+                            int *found, int limit)
+{
+    int mineCount = 0;
+    for (int w = 0; w < SPECIES_WORDS; w++)
+    {
+        mineCount += __builtin_popcountll(mine[w]);
+    }
+    for (int row = 0; row < collectionCount; row++)
+    {
+        int shared = 0, theirs = 0;
+        for (int w = 0; w < SPECIES_WORDS; w++)
+        {
+            uint64_t word = atomic_load_explicit(&collectionBits[row].words[w], memory_order_relaxed);
+            shared += __builtin_popcountll(word & mine[w]);
+            theirs += __builtin_popcountll(word);
+        }
+        if (shared == 0 || row == skipRow)
+        {
+            continue;
+        }
+        int denominator = (metric == SIMILARITY_OVERLAP) ? (mineCount < theirs ? mineCount : theirs)
+                                                         : mineCount + theirs - shared;
+        // Most rows lose to the current 10th: reject them with a multiply, not a divide
+        if (*found == limit && shared <= best[limit - 1] * denominator)
+        {
+            continue;
+        }
+        double score = (double)shared / denominator;
+        if (*found == limit && score <= best[limit - 1])
+        {
+            continue;
+        }
+        // Insertion into the short sorted list; ties keep the earlier row
+        int at = (*found < limit) ? (*found)++ : limit - 1;
+        while (at > 0 && best[at - 1] < score)
+        {
+            best[at] = best[at - 1];
+            rows[at] = rows[at - 1];
+            at--;
+        }
+        best[at] = score;
+        rows[at] = row;
+    }
+}
+
+int mostSimilarOwners(OwnerNode *owner, SimilarityMetric metric, OwnerNode **owners, double *scores, int limit)
+{
+    if (owner == NULL || limit <= 0)
+    {
+        return 0;
+    }
+    int *rows = (int *)memAlloc(MEM_SCRATCH, (size_t)limit * sizeof(int));
+    double *best = (double *)memAlloc(MEM_SCRATCH, (size_t)limit * sizeof(double));
+    if (rows == NULL || best == NULL)
+    {
+        memFree(MEM_SCRATCH, rows);
+        memFree(MEM_SCRATCH, best);
+        return 0;
+    }
+
+    int found = 0;
+    pthread_rwlock_rdlock(&collectionLock);
+    int myRow = owner->bitsRow;
+    if (myRow >= 0)
+    {
+        uint64_t mine[SPECIES_WORDS];
+        for (int w = 0; w < SPECIES_WORDS; w++)
+        {
+            mine[w] = atomic_load_explicit(&collectionBits[myRow].words[w], memory_order_relaxed);
+        }
+        scanCollections(mine, myRow, metric, rows, best, &found, limit);
+    }
+    // Rowed owners are linked: the ring's reference keeps these pins from failing
+    int pinned = 0;
+    for (int i = 0; i < found; i++)
+    {
+        if (tryAcquireOwner(collectionOwners[rows[i]]))
+        {
+            owners[pinned] = collectionOwners[rows[i]];
+            if (scores != NULL)
+            {
+                scores[pinned] = best[i];
+            }
+            pinned++;
+        }
+    }
+    pthread_rwlock_unlock(&collectionLock);
+
+    memFree(MEM_SCRATCH, rows);
+    memFree(MEM_SCRATCH, best);
+    return pinned;
+}
+
+double pokemonScore(const PokemonData *data)
+{
+    return data->attack * 1.5 + data->hp * 1.2;
+}
+
+//========================================
+// Species Names
+// Hash-and-displace perfect hash over the pokedex[] names, built by
+// pokemon_hashgen.c into pokemon_species_hash.h. A name's hash picks a
+// bucket; the bucket's displacement moves its names into slots no other
+// name uses, so a lookup is one hash, two table reads and one compare.
+// The compare also makes a stale table fail closed (unknown name).
+//========================================
+
+unsigned long long speciesNameHash(const char *name, size_t length, unsigned long long seed)
+{
+    unsigned long long h = 0xCBF29CE484222325ULL ^ seed;
+    for (size_t i = 0; i < length; i++)
+    {
+        unsigned char c = (unsigned char)name[i];
+        c |= (unsigned char)(((unsigned)(c - 'A') < 26u) << 5); // ASCII tolower without a branch
+        h = (h ^ c) * 0x100000001B3ULL;
+    }
+    // Final avalanche so the bucket (low) and slot (high) bits both depend on every byte
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    return h;
+}
+
+int speciesIdBySlice(const char *name, size_t length)
+{
+    unsigned long long h = speciesNameHash(name, length, SPECIES_HASH_SEED);
+    unsigned slot = ((unsigned)(h >> 32) ^ speciesHashDisplacement[h % SPECIES_HASH_BUCKETS]) % SPECIES_HASH_SLOTS;
+    int id = speciesHashSlots[slot];
+    if (id == 0)
+    {
+        return 0;
+    }
+    const char *candidate = pokedex[id - 1].name;
+    return (strncasecmp(candidate, name, length) == 0 && candidate[length] == '\0') ? id : 0;
+}
+
+int speciesIdByName(const char *name)
+{
+    return speciesIdBySlice(name, strlen(name));
+}
+
+//========================================
+// Name Completion
+// Compact tries keyed on case-folded bytes. Nodes live in one growable
+// array and point at each other by index; children form a sibling list
+// sorted by byte, and parent links let completion walk in order and
+// deletion prune upward without a stack. The species trie is built once
+// and then only read. The owner trie is updated by ring writers (under
+// ownerRingLock) and guarded by its own rwlock for readers.
+//========================================
+
+typedef struct TrieValue
+{
+    void *value;
+    struct TrieValue *next;
+} TrieValue;
+
+typedef struct
+{
+    int parent;
+    int firstChild;
+    int nextSibling; // Also links the free list
+    TrieValue *values;
+    unsigned char key;
+} TrieNode;
+
+typedef struct
+{
+    TrieNode *nodes; // nodes[0] is the root once anything was inserted
+    int count;
+    int capacity;
+    int freeList;
+} NameTrie;
+
+static NameTrie speciesTrie;
+static pthread_once_t speciesTrieOnce = PTHREAD_ONCE_INIT;
+static NameTrie ownerTrie = {NULL, 0, 0, -1};
+static pthread_rwlock_t ownerTrieLock = PTHREAD_RWLOCK_INITIALIZER;
+
+static unsigned char foldNameByte(unsigned char c)
+{
+    return c | (unsigned char)(((unsigned)(c - 'A') < 26u) << 5);
+}
+
+// Returns the new node's index, or -1 if the array could not grow
+static int trieNewNode(NameTrie *trie, int parent, unsigned char key)
+{
+    int index;
+    if (trie->freeList >= 0)
+    {
+        index = trie->freeList;
+        trie->freeList = trie->nodes[index].nextSibling;
+    }
+    else
+    {
+        if (trie->count == trie->capacity)
+        {
+            int capacity = trie->capacity ? trie->capacity * 2 : 64;
+            TrieNode *grown = (TrieNode *)memRealloc(MEM_INDEXES, trie->nodes, sizeof(TrieNode) * capacity);
+            if (grown == NULL)
+            {
+                return -1;
+            }
+            trie->nodes = grown;
+            trie->capacity = capacity;
+        }
+        index = trie->count++;
+    }
+    TrieNode *node = &trie->nodes[index];
+    node->parent = parent;
+    node->firstChild = -1;
+    node->nextSibling = -1;
+    node->values = NULL;
+    node->key = key;
+    return index;
+}
+
+// Node spelling exactly name (folded), or -1
+static int trieFind(const NameTrie *trie, const char *name, size_t length)
+{
+    if (trie->count == 0)
+    {
+        return -1;
+    }
+    int node = 0;
+    for (size_t i = 0; i < length && node >= 0; i++)
+    {
+        unsigned char key = foldNameByte((unsigned char)name[i]);
+        int child = trie->nodes[node].firstChild;
+        while (child >= 0 && trie->nodes[child].key < key)
+        {
+            child = trie->nodes[child].nextSibling;
+        }
+        node = (child >= 0 && trie->nodes[child].key == key) ? child : -1;
+    }
+    return node;
+}
+
+// Returns 0 if memory ran out (the trie stays consistent, just without value)
+static int trieInsert(NameTrie *trie, const char *name, size_t length, void *value)
+{
+    if (trie->count == 0 && trieNewNode(trie, -1, 0) < 0)
+    {
+        return 0;
+    }
+    int node = 0;
+    for (size_t i = 0; i < length; i++)
+    {
+        unsigned char key = foldNameByte((unsigned char)name[i]);
+        int previous = -1;
+        int child = trie->nodes[node].firstChild;
+        while (child >= 0 && trie->nodes[child].key < key)
+        {
+            previous = child;
+            child = trie->nodes[child].nextSibling;
+        }
+        if (child < 0 || trie->nodes[child].key != key)
+        {
+            int fresh = trieNewNode(trie, node, key);
+            if (fresh < 0)
+            {
+                return 0;
+            }
+            // Keep siblings sorted so completion comes out in order
+            trie->nodes[fresh].nextSibling = child;
+            if (previous < 0)
+                trie->nodes[node].firstChild = fresh;
+            else
+                trie->nodes[previous].nextSibling = fresh;
+            child = fresh;
+        }
+        node = child;
+    }
+
+    TrieValue *entry = (TrieValue *)memAlloc(MEM_INDEXES, sizeof(TrieValue));
+    if (entry == NULL)
+    {
+        return 0;
+    }
+    entry->value = value;
+    entry->next = trie->nodes[node].values;
+    trie->nodes[node].values = entry;
+    return 1;
+}
+
+static void trieRemove(NameTrie *trie, const char *name, size_t length, void *value)
+{
+    int node = trieFind(trie, name, length);
+    if (node < 0)
+    {
+        return;
+    }
+    TrieValue **link = &trie->nodes[node].values;
+    while (*link != NULL && (*link)->value != value)
+    {
+        link = &(*link)->next;
+    }
+    if (*link == NULL)
+    {
+        return;
+    }
+    TrieValue *entry = *link;
+    *link = entry->next;
+    memFree(MEM_INDEXES, entry);
+
+    // Prune nodes left with neither values nor children (never the root)
+    while (node > 0 && trie->nodes[node].values == NULL && trie->nodes[node].firstChild < 0)
+    {
+        int parent = trie->nodes[node].parent;
+        int *sibling = &trie->nodes[parent].firstChild;
+        while (*sibling != node)
+        {
+            sibling = &trie->nodes[*sibling].nextSibling;
+        }
+        *sibling = trie->nodes[node].nextSibling;
+        trie->nodes[node].nextSibling = trie->freeList;
+        trie->freeList = node;
+        node = parent;
+    }
+}
+
+static void trieClear(NameTrie *trie)
+{
+    for (int i = 0; i < trie->count; i++)
+    {
+        TrieValue *entry = trie->nodes[i].values;
+        while (entry != NULL)
+        {
+            TrieValue *next = entry->next;
+            memFree(MEM_INDEXES, entry);
+            entry = next;
+        }
+    }
+    memFree(MEM_INDEXES, trie->nodes);
+    trie->nodes = NULL;
+    trie->count = trie->capacity = 0;
+    trie->freeList = -1;
+}
+
+/**
+ * Calls take(value, context) for values under start, in name order, until
+ * it returns 0 or limit values were taken. Returns how many were taken.
+ */
+static int trieCollect(const NameTrie *trie, int start, int limit, int (*take)(void *value, void *context, int slot),
+                       void *context)
+{
+    int taken = 0;
+    int node = start;
+    while (node >= 0 && taken < limit)
+    {
+        for (TrieValue *entry = trie->nodes[node].values; entry != NULL && taken < limit; entry = entry->next)
+        {
+            taken += take(entry->value, context, taken);
+        }
+        // Pre-order step: down if possible, else to the next sibling of the nearest ancestor
+        if (trie->nodes[node].firstChild >= 0)
+        {
+            node = trie->nodes[node].firstChild;
+            continue;
+        }
+        while (node != start && trie->nodes[node].nextSibling < 0)
+        {
+            node = trie->nodes[node].parent;
+        }
+        node = (node == start) ? -1 : trie->nodes[node].nextSibling;
+    }
+    return taken;
+}
+
+static void buildSpeciesTrie(void)
+{
+    speciesTrie.freeList = -1;
+    for (int i = 0; i < POKEDEX_SIZE; i++)
+    {
+        trieInsert(&speciesTrie, pokedex[i].name, strlen(pokedex[i].name), (void *)(intptr_t)pokedex[i].id);
+    }
+}
+
+static int takeSpeciesId(void *value, void *context, int slot)
+{
+    ((int *)context)[slot] = (int)(intptr_t)value;
+    return 1;
+}
+
+int completeSpeciesNames(const char *prefix, size_t length, int *ids, int limit)
+{
+    pthread_once(&speciesTrieOnce, buildSpeciesTrie);
+    int start = trieFind(&speciesTrie, prefix, length);
+    return (start < 0 || limit <= 0) ? 0 : trieCollect(&speciesTrie, start, limit, takeSpeciesId, ids);
+}
+
+static int takeOwner(void *value, void *context, int slot)
+{
+    // Every owner in the trie is linked, so the ring's reference keeps this from failing
+    OwnerNode *owner = (OwnerNode *)value;
+    if (!tryAcquireOwner(owner))
+    {
+        return 0;
+    }
+    ((OwnerNode **)context)[slot] = owner;
+    return 1;
+}
+
+int completeOwnerNames(const char *prefix, size_t length, OwnerNode **owners, int limit)
+{
+    pthread_rwlock_rdlock(&ownerTrieLock);
+    int start = trieFind(&ownerTrie, prefix, length);
+    int found = (start < 0 || limit <= 0) ? 0 : trieCollect(&ownerTrie, start, limit, takeOwner, owners);
+    pthread_rwlock_unlock(&ownerTrieLock);
+    return found;
+}
+
+// Ring writers call these with ownerRingLock held
+static void ownerTrieInsert(OwnerNode *owner)
+{
+    pthread_rwlock_wrlock(&ownerTrieLock);
+    // Out of memory only makes this owner missing from completions
+    trieInsert(&ownerTrie, owner->ownerName, strlen(owner->ownerName), owner);
+    pthread_rwlock_unlock(&ownerTrieLock);
+}
+
+static void ownerTrieRemove(OwnerNode *owner)
+{
+    pthread_rwlock_wrlock(&ownerTrieLock);
+    trieRemove(&ownerTrie, owner->ownerName, strlen(owner->ownerName), owner);
+    pthread_rwlock_unlock(&ownerTrieLock);
+}
+
+static void ownerTrieClear(void)
+{
+    pthread_rwlock_wrlock(&ownerTrieLock);
+    trieClear(&ownerTrie);
+    pthread_rwlock_unlock(&ownerTrieLock);
+}
+
+//========================================
+// Owner Name Index (skip list)
+// Every linked owner, ordered by strcmp of its name (ties by address, so
+// duplicate names from linkOwnerInCircularList stay distinct). Levels are
+// geometric with p = 1/4. Only ring writers change it, under
+// ownerRingLock, which range listings take as well.
+//========================================
+
+#define OWNER_INDEX_MAX_LEVEL 16 // Plenty for 4^16 owners
+
+typedef struct OwnerIndexNode
+{
+    OwnerNode *owner;
+    struct OwnerIndexNode *forward[]; // One per level of this node
+} OwnerIndexNode;
+
+static OwnerIndexNode *ownerIndexHead; // Sentinel with every level, allocated on first use
+static int ownerIndexLevel = 1;
+static int ownerIndexCount;
+static unsigned long long ownerIndexRandom = 0x9E3779B97F4A7C15ULL;
+
+static int ownerIndexCompare(const OwnerNode *a, const OwnerNode *b)
+{
+    int order = strcmp(a->ownerName, b->ownerName);
+    return order != 0 ? order : (a > b) - (a < b);
+}
+
+static int ownerIndexRandomLevel(void)
+{
+    // xorshift64; two random bits per level gives p = 1/4
+    ownerIndexRandom ^= ownerIndexRandom << 13;
+    ownerIndexRandom ^= ownerIndexRandom >> 7;
+    ownerIndexRandom ^= ownerIndexRandom << 17;
+    unsigned long long bits = ownerIndexRandom;
+    int level = 1;
+    while (level < OWNER_INDEX_MAX_LEVEL && (bits & 3) == 0)
+    {
+        level++;
+        bits >>= 2;
+    }
+    return level;
+}
+
+// Fills update[] with the last node before owner's position on every level
+static void ownerIndexSearch(const OwnerNode *owner, OwnerIndexNode **update)
+{
+    OwnerIndexNode *node = ownerIndexHead;
+    for (int level = ownerIndexLevel - 1; level >= 0; level--)
+    {
+        while (node->forward[level] != NULL && ownerIndexCompare(node->forward[level]->owner, owner) < 0)
+        {
+            node = node->forward[level];
+        }
+        update[level] = node;
+    }
+}
+
+// Must be called with ownerRingLock held. Out of memory leaves the owner unindexed.
+static void ownerIndexInsert(OwnerNode *owner)
+{
+    if (ownerIndexHead == NULL)
+    {
+        ownerIndexHead = (OwnerIndexNode *)memCalloc(MEM_INDEXES, 1, sizeof(OwnerIndexNode) +
+                                                     OWNER_INDEX_MAX_LEVEL * sizeof(OwnerIndexNode *));
+        if (ownerIndexHead == NULL)
+        {
+            return;
+        }
+    }
+    OwnerIndexNode *update[OWNER_INDEX_MAX_LEVEL];
+    ownerIndexSearch(owner, update);
+
+    int level = ownerIndexRandomLevel();
+    OwnerIndexNode *node = (OwnerIndexNode *)memAlloc(MEM_INDEXES, sizeof(OwnerIndexNode) +
+                                                      level * sizeof(OwnerIndexNode *));
+    if (node == NULL)
+    {
+        return;
+    }
+    for (; ownerIndexLevel < level; ownerIndexLevel++)
+    {
+        update[ownerIndexLevel] = ownerIndexHead;
+    }
+    node->owner = owner;
+    for (int i = 0; i < level; i++)
+    {
+        node->forward[i] = update[i]->forward[i];
+        update[i]->forward[i] = node;
+    }
+    ownerIndexCount++;
+}
+
+// Must be called with ownerRingLock held.
+static void ownerIndexRemove(OwnerNode *owner)
+{
+    if (ownerIndexHead == NULL)
+    {
+        return;
+    }
+    OwnerIndexNode *update[OWNER_INDEX_MAX_LEVEL];
+    ownerIndexSearch(owner, update);
+    OwnerIndexNode *node = update[0]->forward[0];
+    if (node == NULL || node->owner != owner)
+    {
+        return; // Never made it into the index
+    }
+    for (int i = 0; i < ownerIndexLevel && update[i]->forward[i] == node; i++)
+    {
+        update[i]->forward[i] = node->forward[i];
+    }
+    while (ownerIndexLevel > 1 && ownerIndexHead->forward[ownerIndexLevel - 1] == NULL)
+    {
+        ownerIndexLevel--;
+    }
+    memFree(MEM_INDEXES, node);
+    ownerIndexCount--;
+}
+
+// Must be called with ownerRingLock held.
+static void ownerIndexClear(void)
+{
+    OwnerIndexNode *node = (ownerIndexHead != NULL) ? ownerIndexHead->forward[0] : NULL;
+    while (node != NULL)
+    {
+        OwnerIndexNode *next = node->forward[0];
+        memFree(MEM_INDEXES, node);
+        node = next;
+    }
+    memFree(MEM_INDEXES, ownerIndexHead);
+    ownerIndexHead = NULL;
+    ownerIndexLevel = 1;
+    ownerIndexCount = 0;
+}
+
+int listOwnersInRange(const char *from, const char *to, OwnerNode **owners, int limit)
+{
+    int found = 0;
+    pthread_mutex_lock(&ownerRingLock);
+    OwnerIndexNode *node = ownerIndexHead;
+    if (node != NULL && from != NULL)
+    {
+        // Last node with a name < from, on every level
+        for (int level = ownerIndexLevel - 1; level >= 0; level--)
+        {
+            while (node->forward[level] != NULL && strcmp(node->forward[level]->owner->ownerName, from) < 0)
+            {
+                node = node->forward[level];
+            }
+        }
+    }
+    node = (node != NULL) ? node->forward[0] : NULL;
+    for (; node != NULL && found < limit; node = node->forward[0])
+    {
+        if (to != NULL && strcmp(node->owner->ownerName, to) >= 0)
+        {
+            break;
+        }
+        // Linked owners hold the ring's reference, so this always succeeds
+        if (tryAcquireOwner(node->owner))
+        {
+            owners[found++] = node->owner;
+        }
+    }
+    pthread_mutex_unlock(&ownerRingLock);
+    return found;
+}
+
+//========================================
+// Type effectiveness
+// typeBonus[mode][attacker][defender] is the multiplier minus one, so every
+// entry the initializer leaves out is neutral (1x) and the whole classic
+// plane is zero. Both planes are built by the compiler.
+//========================================
+
+#define SUPER_EFFECTIVE 1.0     // 2x
+#define NOT_VERY_EFFECTIVE -0.5 // 0.5x
+#define NO_EFFECT -1.0          // 0x
+
+static const double typeBonus[BATTLE_MODE_COUNT][POKEMON_TYPE_COUNT][POKEMON_TYPE_COUNT] = {
+    [BATTLE_TYPED] = {
+        [NORMAL] = {[ROCK] = NOT_VERY_EFFECTIVE, [GHOST] = NO_EFFECT},
+        [FIRE] = {[GRASS] = SUPER_EFFECTIVE, [ICE] = SUPER_EFFECTIVE, [BUG] = SUPER_EFFECTIVE,
+                  [FIRE] = NOT_VERY_EFFECTIVE, [WATER] = NOT_VERY_EFFECTIVE, [ROCK] = NOT_VERY_EFFECTIVE,
+                  [DRAGON] = NOT_VERY_EFFECTIVE},
+        [WATER] = {[FIRE] = SUPER_EFFECTIVE, [GROUND] = SUPER_EFFECTIVE, [ROCK] = SUPER_EFFECTIVE,
+                   [WATER] = NOT_VERY_EFFECTIVE, [GRASS] = NOT_VERY_EFFECTIVE, [DRAGON] = NOT_VERY_EFFECTIVE},
+        [ELECTRIC] = {[WATER] = SUPER_EFFECTIVE, [ELECTRIC] = NOT_VERY_EFFECTIVE, [GRASS] = NOT_VERY_EFFECTIVE,
+                      [DRAGON] = NOT_VERY_EFFECTIVE, [GROUND] = NO_EFFECT},
+        [GRASS] = {[WATER] = SUPER_EFFECTIVE, [GROUND] = SUPER_EFFECTIVE, [ROCK] = SUPER_EFFECTIVE,
+                   [FIRE] = NOT_VERY_EFFECTIVE, [GRASS] = NOT_VERY_EFFECTIVE, [POISON] = NOT_VERY_EFFECTIVE,
+                   [BUG] = NOT_VERY_EFFECTIVE, [DRAGON] = NOT_VERY_EFFECTIVE},
+        [ICE] = {[GRASS] = SUPER_EFFECTIVE, [GROUND] = SUPER_EFFECTIVE, [DRAGON] = SUPER_EFFECTIVE,
+                 [FIRE] = NOT_VERY_EFFECTIVE, [WATER] = NOT_VERY_EFFECTIVE, [ICE] = NOT_VERY_EFFECTIVE},
+        [FIGHTING] = {[NORMAL] = SUPER_EFFECTIVE, [ICE] = SUPER_EFFECTIVE, [ROCK] = SUPER_EFFECTIVE,
+                      [POISON] = NOT_VERY_EFFECTIVE, [PSYCHIC] = NOT_VERY_EFFECTIVE, [BUG] = NOT_VERY_EFFECTIVE,
+                      [FAIRY] = NOT_VERY_EFFECTIVE, [GHOST] = NO_EFFECT},
+        [POISON] = {[GRASS] = SUPER_EFFECTIVE, [FAIRY] = SUPER_EFFECTIVE, [POISON] = NOT_VERY_EFFECTIVE,
+                    [GROUND] = NOT_VERY_EFFECTIVE, [ROCK] = NOT_VERY_EFFECTIVE, [GHOST] = NOT_VERY_EFFECTIVE},
+        [GROUND] = {[FIRE] = SUPER_EFFECTIVE, [ELECTRIC] = SUPER_EFFECTIVE, [POISON] = SUPER_EFFECTIVE,
+                    [ROCK] = SUPER_EFFECTIVE, [GRASS] = NOT_VERY_EFFECTIVE, [BUG] = NOT_VERY_EFFECTIVE},
+        [PSYCHIC] = {[FIGHTING] = SUPER_EFFECTIVE, [POISON] = SUPER_EFFECTIVE, [PSYCHIC] = NOT_VERY_EFFECTIVE},
+        [BUG] = {[GRASS] = SUPER_EFFECTIVE, [PSYCHIC] = SUPER_EFFECTIVE, [FIRE] = NOT_VERY_EFFECTIVE,
+                 [FIGHTING] = NOT_VERY_EFFECTIVE, [POISON] = NOT_VERY_EFFECTIVE, [GHOST] = NOT_VERY_EFFECTIVE,
+                 [FAIRY] = NOT_VERY_EFFECTIVE},
+        [ROCK] = {[FIRE] = SUPER_EFFECTIVE, [ICE] = SUPER_EFFECTIVE, [BUG] = SUPER_EFFECTIVE,
+                  [FIGHTING] = NOT_VERY_EFFECTIVE, [GROUND] = NOT_VERY_EFFECTIVE},
+        [GHOST] = {[GHOST] = SUPER_EFFECTIVE, [PSYCHIC] = SUPER_EFFECTIVE, [NORMAL] = NO_EFFECT},
+        [DRAGON] = {[DRAGON] = SUPER_EFFECTIVE, [FAIRY] = NO_EFFECT},
+        [FAIRY] = {[FIGHTING] = SUPER_EFFECTIVE, [DRAGON] = SUPER_EFFECTIVE, [FIRE] = NOT_VERY_EFFECTIVE,
+                   [POISON] = NOT_VERY_EFFECTIVE},
+    },
+};
+
+static _Atomic BattleMode battleMode = BATTLE_CLASSIC;
+
+double typeMultiplier(PokemonType attacker, PokemonType defender)
+{
+    return 1.0 + typeBonus[BATTLE_TYPED][attacker][defender];
+}
+
+double battleScore(const PokemonData *attacker, const PokemonData *defender, BattleMode mode)
+{
+    double base = pokemonScore(attacker);
+    return base + base * typeBonus[mode][attacker->TYPE][defender->TYPE];
+}
+
+void setBattleMode(BattleMode mode)
+{
+    atomic_store_explicit(&battleMode, mode, memory_order_relaxed);
+}
+
+BattleMode getBattleMode(void)
+{
+    return atomic_load_explicit(&battleMode, memory_order_relaxed);
+}
+
+//========================================
+// Monte-Carlo Battle Simulation
+// Workers share nothing but the read-only rosters and four atomic
+// counters, which they bump once per batch of battles.
+//========================================
+
+#define SIM_BATCH 4096          // Battles between two updates of the shared counters
+#define SIM_MAX_EXCHANGES 10000 // Immune-vs-immune standoffs end as draws
+#define SIM_DAMAGE_SCALE 0.25   // A hit takes a quarter of the attack stat (before the roll)
+
+typedef struct
+{
+    atomic_ullong done;
+    atomic_ullong firstWins;
+    atomic_ullong secondWins;
+    atomic_ullong draws;
+} SimulationTally;
+
+typedef struct
+{
+    const PokemonData **rosters[2];
+    int sizes[2];
+    BattleMode mode;
+    unsigned long long battles;
+    unsigned long long rng[4];
+    SimulationTally *tally;
+} SimulationWorker;
+
+static unsigned long long rotl64(unsigned long long x, int k)
+{
+    return (x << k) | (x >> (64 - k));
+}
+
+// xoshiro256**: one private stream per worker
+static unsigned long long xoshiroNext(unsigned long long *s)
+{
+    unsigned long long result = rotl64(s[1] * 5, 7) * 9;
+    unsigned long long t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl64(s[3], 45);
+    return result;
+}
+
+// splitmix64, to spread one seed over the xoshiro state words
+static unsigned long long splitMix64(unsigned long long *x)
+{
+    unsigned long long z = (*x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Returns 0 if the first roster wins, 1 if the second does, 2 for a draw
+static int simulateOneBattle(const SimulationWorker *w, unsigned long long *rng)
+{
+    int next[2] = {0, 0};
+    double hp[2] = {w->rosters[0][0]->hp, w->rosters[1][0]->hp};
+    for (int exchange = 0; exchange < SIM_MAX_EXCHANGES; exchange++)
+    {
+        unsigned long long bits = xoshiroNext(rng);
+        int attacker = (int)(bits & 1);
+        for (int strike = 0; strike < 2; strike++, attacker ^= 1)
+        {
+            int defender = attacker ^ 1;
+            const PokemonData *a = w->rosters[attacker][next[attacker]];
+            const PokemonData *d = w->rosters[defender][next[defender]];
+            // Top 53 bits as a uniform [0, 1)
+            double roll = 0.85 + 0.15 * ((double)(xoshiroNext(rng) >> 11) * 0x1.0p-53);
+            hp[defender] -= a->attack * SIM_DAMAGE_SCALE * roll * (1.0 + typeBonus[w->mode][a->TYPE][d->TYPE]);
+            if (hp[defender] <= 0)
+            {
+                if (++next[defender] == w->sizes[defender])
+                {
+                    return attacker;
+                }
+                // The replacement comes in; the exchange ends
+                hp[defender] = w->rosters[defender][next[defender]]->hp;
+                break;
+            }
+        }
+    }
+    return 2;
+}
+
+static void *simulationWorker(void *arg)
+{
+    SimulationWorker *w = (SimulationWorker *)arg;
+    unsigned long long remaining = w->battles;
+    while (remaining > 0)
+    {
+        unsigned long long batch = remaining < SIM_BATCH ? remaining : SIM_BATCH;
+        unsigned long long outcomes[3] = {0, 0, 0};
+        for (unsigned long long i = 0; i < batch; i++)
+        {
+            outcomes[simulateOneBattle(w, w->rng)]++;
+        }
+        atomic_fetch_add_explicit(&w->tally->firstWins, outcomes[0], memory_order_relaxed);
+        atomic_fetch_add_explicit(&w->tally->secondWins, outcomes[1], memory_order_relaxed);
+        atomic_fetch_add_explicit(&w->tally->draws, outcomes[2], memory_order_relaxed);
+        // Release: a reader that sees done also sees the outcomes above
+        atomic_fetch_add_explicit(&w->tally->done, batch, memory_order_release);
+        remaining -= batch;
+    }
+    return NULL;
+}
+
+// Copies an owner's species (in ID order) into a scratch array
+static const PokemonData **snapshotRoster(OwnerNode *owner, int *size)
+{
+    NodeArray nodes;
+    initNodeArray(&nodes, 16);
+    lockOwnerRead(owner);
+    collectTraversal(owner->pokedexRoot, TRAVERSAL_IN_ORDER, &nodes);
+    unlockOwner(owner);
+
+    const PokemonData **roster = NULL;
+    *size = nodes.size;
+    if (nodes.size > 0)
+    {
+        roster = (const PokemonData **)memAlloc(MEM_SCRATCH, sizeof(*roster) * nodes.size);
+    }
+    for (int i = 0; roster != NULL && i < nodes.size; i++)
+    {
+        // Nodes may be freed once unlocked; the pokedex[] records they point at never are
+        roster[i] = nodeData(nodes.nodes[i]);
+    }
+    memFree(MEM_SCRATCH, nodes.nodes);
+    return roster;
+}
+
+// Newton's method; keeps the build free of -lm for one reporting sqrt
+static double squareRoot(double x)
+{
+    if (x <= 0)
+    {
+        return 0;
+    }
+    double r = x > 1 ? x : 1;
+    for (int i = 0; i < 64; i++)
+    {
+        double next = 0.5 * (r + x / r);
+        if (next >= r)
+        {
+            break;
+        }
+        r = next;
+    }
+    return r;
+}
+
+static void reportSimulationProgress(FILE *out, SimulationTally *tally)
+{
+    unsigned long long done = atomic_load_explicit(&tally->done, memory_order_acquire);
+    unsigned long long wins = atomic_load_explicit(&tally->firstWins, memory_order_relaxed);
+    if (done == 0)
+    {
+        return;
+    }
+    // Counters are read one by one, so wins may run a batch ahead of done
+    double p = (double)(wins < done ? wins : done) / (double)done;
+    double halfWidth = 1.96 * squareRoot(p * (1.0 - p) / (double)done);
+    fprintf(out, "  after %llu battles: P(first wins) = %.4f +/- %.4f\n", done, p, halfWidth);
+}
+
+PokedexStatus simulateRosterBattles(OwnerNode *first, OwnerNode *second, unsigned long long simulations,
+                                    int threads, unsigned long long seed, BattleMode mode, FILE *progress,
+                                    SimulationResult *result)
+{
+    memset(result, 0, sizeof(*result));
+    if (threads < 1)
+    {
+        threads = 1;
+    }
+
+    int sizes[2];
+    const PokemonData **rosters[2] = {snapshotRoster(first, &sizes[0]), snapshotRoster(second, &sizes[1])};
+    if (rosters[0] == NULL || rosters[1] == NULL)
+    {
+        PokedexStatus status = (sizes[0] == 0 || sizes[1] == 0) ? POKEDEX_NOT_FOUND : POKEDEX_NO_MEMORY;
+        memFree(MEM_SCRATCH, rosters[0]);
+        memFree(MEM_SCRATCH, rosters[1]);
+        return status;
+    }
+
+    SimulationWorker *workers = (SimulationWorker *)memCalloc(MEM_SCRATCH, threads, sizeof(SimulationWorker));
+    pthread_t *tids = (pthread_t *)memCalloc(MEM_SCRATCH, threads, sizeof(pthread_t));
+    if (workers == NULL || tids == NULL)
+    {
+        memFree(MEM_SCRATCH, workers);
+        memFree(MEM_SCRATCH, tids);
+        memFree(MEM_SCRATCH, rosters[0]);
+        memFree(MEM_SCRATCH, rosters[1]);
+        return POKEDEX_NO_MEMORY;
+    }
+
+    SimulationTally tally;
+    atomic_init(&tally.done, 0);
+    atomic_init(&tally.firstWins, 0);
+    atomic_init(&tally.secondWins, 0);
+    atomic_init(&tally.draws, 0);
+
+    unsigned long long begin = monotonicNanos();
+    int started = 0;
+    for (int t = 0; t < threads; t++)
+    {
+        SimulationWorker *w = &workers[t];
+        w->rosters[0] = rosters[0];
+        w->rosters[1] = rosters[1];
+        w->sizes[0] = sizes[0];
+        w->sizes[1] = sizes[1];
+        w->mode = mode;
+        w->tally = &tally;
+        w->battles = simulations / threads + ((unsigned long long)t < simulations % threads ? 1 : 0);
+        unsigned long long mix = seed + (unsigned long long)t * 0x632BE59BD9B4E019ULL;
+        for (int k = 0; k < 4; k++)
+        {
+            w->rng[k] = splitMix64(&mix);
+        }
+        if (pthread_create(&tids[t], NULL, simulationWorker, w) != 0)
+        {
+            // Run this share on the calling thread instead
+            simulationWorker(w);
+            continue;
+        }
+        started++;
+        tids[started - 1] = tids[t];
+    }
+
+    if (progress != NULL)
+    {
+        // Report at 1/64, 1/16, 1/4 and all of the run, from live counters
+        unsigned long long mark = simulations / 64;
+        while (mark > 0 && mark < simulations)
+        {
+            while (atomic_load_explicit(&tally.done, memory_order_acquire) < mark)
+            {
+                struct timespec pause = {0, 1000000};
+                nanosleep(&pause, NULL);
+            }
+            reportSimulationProgress(progress, &tally);
+            mark *= 4;
+        }
+    }
+    for (int t = 0; t < started; t++)
+    {
+        pthread_join(tids[t], NULL);
+    }
+    if (progress != NULL)
+    {
+        reportSimulationProgress(progress, &tally);
+    }
+
+    result->seconds = (double)(monotonicNanos() - begin) / 1e9;
+    result->simulations = atomic_load(&tally.done);
+    result->firstWins = atomic_load(&tally.firstWins);
+    result->secondWins = atomic_load(&tally.secondWins);
+    result->draws = atomic_load(&tally.draws);
+
+    memFree(MEM_SCRATCH, workers);
+    memFree(MEM_SCRATCH, tids);
+    memFree(MEM_SCRATCH, rosters[0]);
+    memFree(MEM_SCRATCH, rosters[1]);
+    return POKEDEX_OK;
+}
+
+//========================================
+// Team Matchups (assignment problem)
+// Every pairing gets a weight: n + 1 for a win of the first owner's
+// Pokemon, 1 for a tie, 0 for a loss. At most n ties can't outweigh one
+// win, so the most wins come first and ties only decide between
+// assignments with equally many. The rosters are padded to a square with
+// zero-weight dummies, and the Hungarian algorithm (shortest augmenting
+// paths with potentials, O(n^3)) finds the minimum of n + 1 - weight.
+//========================================
+
+static int matchupOutcome(const PokemonData *a, const PokemonData *b, BattleMode mode)
+{
+    double scoreA = battleScore(a, b, mode);
+    double scoreB = battleScore(b, a, mode);
+    return (scoreA > scoreB) - (scoreA < scoreB);
+}
+
+/**
+ * Minimum-cost perfect assignment of an n x n cost matrix (row-major).
+ * rowToColumn[i] receives row i's column. Scratch needs 6 * (n + 1) longs.
+ */
+static void hungarianAssign(const int *cost, int n, int *rowToColumn, long *scratch)
+{
+    // 1-based as in the textbook formulation; row 0 / column 0 are the virtual start
+    long *u = scratch;
+    long *v = u + (n + 1);
+    long *columnRow = v + (n + 1); // Row matched to each column (0 = none)
+    long *way = columnRow + (n + 1);
+    long *minSlack = way + (n + 1);
+    long *used = minSlack + (n + 1);
+    for (int j = 0; j <= n; j++)
+    {
+        u[j] = v[j] = columnRow[j] = way[j] = 0;
+    }
+
+    for (int i = 1; i <= n; i++)
+    {
+        columnRow[0] = i;
+        int j0 = 0;
+        for (int j = 0; j <= n; j++)
+        {
+            minSlack[j] = LONG_MAX;
+            used[j] = 0;
+        }
+        // Grow a tree of tight edges from row i until it reaches a free column
+        do
+        {
+            used[j0] = 1;
+            long i0 = columnRow[j0];
+            long delta = LONG_MAX;
+            int j1 = 0;
+            for (int j = 1; j <= n; j++)
+            {
+                if (used[j])
+                {
+                    continue;
+                }
+                long reduced = cost[(i0 - 1) * n + (j - 1)] - u[i0] - v[j];
+                if (reduced < minSlack[j])
+                {
+                    minSlack[j] = reduced;
+                    way[j] = j0;
+                }
+                if (minSlack[j] < delta)
+                {
+                    delta = minSlack[j];
+                    j1 = j;
+                }
+            }
+            for (int j = 0; j <= n; j++)
+            {
+                if (used[j])
+                {
+                    u[columnRow[j]] += delta;
+                    v[j] -= delta;
+                }
+                else
+                {
+                    minSlack[j] -= delta;
+                }
+            }
+            j0 = j1;
+        } while (columnRow[j0] != 0);
+        // Flip the augmenting path back to the root
+        do
+        {
+            int j1 = (int)way[j0];
+            columnRow[j0] = columnRow[j1];
+            j0 = j1;
+        } while (j0 != 0);
+    }
+
+    for (int j = 1; j <= n; j++)
+    {
+        rowToColumn[columnRow[j] - 1] = j - 1;
+    }
+}
+
+PokedexStatus bestMatchup(OwnerNode *first, OwnerNode *second, BattleMode mode, Matchup *matchup)
+{
+    memset(matchup, 0, sizeof(*matchup));
+    int sizes[2];
+    const PokemonData **rosters[2] = {snapshotRoster(first, &sizes[0]), snapshotRoster(second, &sizes[1])};
+    if (rosters[0] == NULL || rosters[1] == NULL)
+    {
+        PokedexStatus status = (sizes[0] == 0 || sizes[1] == 0) ? POKEDEX_NOT_FOUND : POKEDEX_NO_MEMORY;
+        memFree(MEM_SCRATCH, rosters[0]);
+        memFree(MEM_SCRATCH, rosters[1]);
+        return status;
+    }
+
+    int n = sizes[0] > sizes[1] ? sizes[0] : sizes[1];
+    // Solver scratch, cost matrix and assignment share one block (longs first, for alignment)
+    long *scratch = (long *)memAlloc(MEM_SCRATCH, sizeof(long) * 6 * (n + 1) + sizeof(int) * (n * n + n));
+    int *cost = (scratch != NULL) ? (int *)(scratch + 6 * (n + 1)) : NULL;
+    int *assignment = (cost != NULL) ? cost + n * n : NULL;
+    int pairCount = sizes[0] < sizes[1] ? sizes[0] : sizes[1];
+    matchup->pairs = (MatchupPair *)memAlloc(MEM_SCRATCH, sizeof(MatchupPair) * pairCount);
+    PokedexStatus status = POKEDEX_NO_MEMORY;
+    if (scratch != NULL && matchup->pairs != NULL)
+    {
+        int winWeight = n + 1;
+        for (int i = 0; i < n; i++)
+        {
+            for (int j = 0; j < n; j++)
+            {
+                int weight = 0; // Pairings with a dummy win nothing
+                if (i < sizes[0] && j < sizes[1])
+                {
+                    int outcome = matchupOutcome(rosters[0][i], rosters[1][j], mode);
+                    weight = (outcome > 0) ? winWeight : (outcome == 0);
+                }
+                cost[i * n + j] = winWeight - weight;
+            }
+        }
+        hungarianAssign(cost, n, assignment, scratch);
+
+        for (int i = 0; i < sizes[0]; i++)
+        {
+            int j = assignment[i];
+            if (j >= sizes[1])
+            {
+                continue;
+            }
+            MatchupPair *pair = &matchup->pairs[matchup->count++];
+            pair->firstId = rosters[0][i]->id;
+            pair->secondId = rosters[1][j]->id;
+            pair->outcome = matchupOutcome(rosters[0][i], rosters[1][j], mode);
+            matchup->wins += (pair->outcome > 0);
+            matchup->ties += (pair->outcome == 0);
+            matchup->losses += (pair->outcome < 0);
+        }
+        status = POKEDEX_OK;
+    }
+    else
+    {
+        memFree(MEM_SCRATCH, matchup->pairs);
+        matchup->pairs = NULL;
+    }
+
+    memFree(MEM_SCRATCH, scratch);
+    memFree(MEM_SCRATCH, rosters[0]);
+    memFree(MEM_SCRATCH, rosters[1]);
+    return status;
+}
+
+void freeMatchup(Matchup *matchup)
+{
+    memFree(MEM_SCRATCH, matchup->pairs);
+    matchup->pairs = NULL;
+    matchup->count = 0;
+}
+
+PokedexStatus pokedexAddPokemon(OwnerNode *owner, int id)
+{
+    if (id <= 0 || id > POKEDEX_SIZE)
+    {
+        return POKEDEX_INVALID_ID;
+    }
+
+    PokedexStatus status = POKEDEX_OK;
+    lockOwnerWrite(owner);
+    if (owner->mergedAway)
+    {
+        status = POKEDEX_MERGED_AWAY;
+    }
+    else if (findPokemonBST(owner->pokedexRoot, id) != NULL)
+    {
+        status = POKEDEX_DUPLICATE;
+    }
+    else
+    {
+        PokemonNode *node = createPokemonNode(&pokedex[id - 1]);
+        if (node == NULL)
+        {
+            status = POKEDEX_NO_MEMORY;
+        }
+        else
+        {
+            owner->pokedexRoot = insertPokemonNode(owner->pokedexRoot, node);
+            speciesIndexAdd(owner, id);
+        }
+    }
+    unlockOwner(owner);
+    return status;
+}
+
+PokedexStatus pokedexReleasePokemon(OwnerNode *owner, int id)
+{
+    PokedexStatus status = POKEDEX_OK;
+    lockOwnerWrite(owner);
+    if (owner->mergedAway)
+    {
+        status = POKEDEX_MERGED_AWAY;
+    }
+    else if (findPokemonBST(owner->pokedexRoot, id) == NULL)
+    {
+        status = POKEDEX_NOT_FOUND;
+    }
+    else
+    {
+        owner->pokedexRoot = deletePokemonNode(owner->pokedexRoot, id);
+        speciesIndexRemove(owner, id);
+    }
+    unlockOwner(owner);
+    return status;
+}
+
+PokedexStatus pokedexEvolvePokemon(OwnerNode *owner, int oldId)
+{
+    PokedexStatus status = POKEDEX_OK;
+    unsigned long visited = 0;
+    unsigned long long start = metricsStart(METRIC_EVOLVE);
+    lockOwnerWrite(owner);
+    PokemonNode *pokemonToEvolve = NULL;
+    if (owner->mergedAway)
+    {
+        status = POKEDEX_MERGED_AWAY;
+    }
+    else if ((pokemonToEvolve = findPokemonWithDepth(owner->pokedexRoot, oldId, &visited)) == NULL)
+    {
+        status = POKEDEX_NOT_FOUND;
+    }
+    else if (nodeData(pokemonToEvolve)->CAN_EVOLVE == CANNOT_EVOLVE)
+    {
+        status = POKEDEX_CANNOT_EVOLVE;
+    }
+    else if (findPokemonBST(owner->pokedexRoot, oldId + 1) != NULL)
+    {
+        // Evolved form already owned: just release the original
+        owner->pokedexRoot = deletePokemonNode(owner->pokedexRoot, oldId);
+        speciesIndexRemove(owner, oldId);
+        status = POKEDEX_EVOLUTION_OWNED;
+    }
+    else
+    {
+        // The unlinked node becomes the evolved form: no allocation on a private tree
+        PokemonNode *evolved = detachPokemonNode(&owner->pokedexRoot, oldId);
+        evolved->speciesId = (uint8_t)(oldId + 1);
+        owner->pokedexRoot = insertPokemonNode(owner->pokedexRoot, evolved);
+        speciesIndexRemove(owner, oldId);
+        speciesIndexAdd(owner, oldId + 1);
+    }
+    unlockOwner(owner);
+    metricsStop(METRIC_EVOLVE, start, visited);
+    return status;
+}
+
+PokedexStatus pokedexFight(OwnerNode *owner, int id1, int id2, double *score1, double *score2)
+{
+    PokedexStatus status = POKEDEX_OK;
+    lockOwnerRead(owner);
+    const PokemonData *pokemon1 = lookupSpeciesLocked(owner, id1);
+    const PokemonData *pokemon2 = lookupSpeciesLocked(owner, id2);
+    if (pokemon1 == NULL || pokemon2 == NULL)
+    {
+        status = POKEDEX_NOT_FOUND;
+    }
+    else
+    {
+        BattleMode mode = getBattleMode();
+        *score1 = battleScore(pokemon1, pokemon2, mode);
+        *score2 = battleScore(pokemon2, pokemon1, mode);
+    }
+    unlockOwner(owner);
+    return status;
+}
+
+/**
+ * Write-locks merge target and source in address order. Two merges
+ * running in opposite directions on the same pair therefore always
+ * queue on the same lock first and cannot deadlock. Source is locked
+ * for writing too, because the merge marks it merged away.
+ */
+static void lockOwnersForMerge(OwnerNode *target, OwnerNode *source)
+{
+    if (target < source)
+    {
+        lockOwnerWrite(target);
+        lockOwnerWrite(source);
+    }
+    else
+    {
+        lockOwnerWrite(source);
+        lockOwnerWrite(target);
+    }
+}
+
+PokedexStatus mergeOwners(OwnerNode *target, OwnerNode *source)
+{
+    if (target == source)
+    {
+        return POKEDEX_SAME_OWNER;
+    }
+
+    unsigned long long start = metricsStart(METRIC_MERGE);
+    unsigned long moved = 0;
+    lockOwnersForMerge(target, source);
+    if (target->mergedAway || source->mergedAway)
+    {
+        // A concurrent merge got here first
+        unlockOwner(source);
+        unlockOwner(target);
+        metricsStop(METRIC_MERGE, start, 0);
+        return POKEDEX_MERGED_AWAY;
+    }
+
+    // Perform BFS on the source Pokedex and add each node to the target Pokedex
+    // (at most POKEDEX_SIZE nodes, each enqueueing two children)
+    PokemonNode *queue[2 * POKEDEX_SIZE + 1];
+    int front = 0, rear = 0;
+    PokedexStatus status = POKEDEX_OK;
+    queue[rear++] = source->pokedexRoot;
+
+    while (front < rear) 
+    {
+        PokemonNode *current = queue[front++];
+        if (current == NULL) 
+        {
+            continue;
+        }
+
+        // Create a new node for insertion
+        PokemonNode *newNode = createPokemonNode(nodeData(current)); // Same species
+        if (!newNode) 
+        {
+            status = POKEDEX_NO_MEMORY;
+            break;
+        }
+        target->pokedexRoot = insertPokemonNode(target->pokedexRoot, newNode);
+        speciesIndexAdd(target, current->speciesId); // No-op if target already had it
+        moved++;
+
+        // Enqueue children
+        queue[rear++] = nodeLeft(current);
+        queue[rear++] = nodeRight(current);
+    }
+
+    // Edits to source from here on would be lost with it: refuse them. The
+    // unlink itself can't happen under this lock (ring lock comes first).
+    source->mergedAway = (status == POKEDEX_OK);
+    unlockOwner(source);
+    unlockOwner(target);
+
+    if (status == POKEDEX_OK)
+    {
+        // Remove the source owner
+        deleteOwnerFromList(source);
+    }
+    metricsStop(METRIC_MERGE, start, moved);
+    return status;
+}
+
+#ifndef POKEMON_NO_MAIN
+// --fast-exit leaves the owners to the OS instead of freeing every node
+static void freeEverythingAtExit(int fastExit)
+{
+    if (fastExit)
+    {
+        shutdownOwnerReclaimer(1);
+    }
+    freeAllOwners();
+    epochReclaimAll();
+}
+
+int main(int argc, char **argv)
+{
+    // "kill -USR1 <pid>" prints the metrics to stderr
+    metricsDumpOnSignal();
+
+    // "--replay FILE" applies a command trace first; "--serve PATH" then hosts
+    // many trainers over a Unix socket instead of the stdin console
+    // "--battle typed" scores fights with type effectiveness
+    const char *replayPath = NULL;
+    const char *socketPath = NULL;
+    int fastExit = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        if (i + 1 < argc && strcmp(argv[i], "--battle") == 0 &&
+            (strcmp(argv[i + 1], "classic") == 0 || strcmp(argv[i + 1], "typed") == 0))
+        {
+            setBattleMode(strcmp(argv[++i], "typed") == 0 ? BATTLE_TYPED : BATTLE_CLASSIC);
+        }
+        else if (i + 1 < argc && strcmp(argv[i], "--replay") == 0 && replayPath == NULL)
+        {
+            replayPath = argv[++i];
+        }
+        else if (i + 1 < argc && strcmp(argv[i], "--serve") == 0 && socketPath == NULL)
+        {
+            socketPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--fast-exit") == 0)
+        {
+            fastExit = 1;
+        }
+        else
+        {
+            fprintf(stderr,
+                    "usage: %s [--battle classic|typed] [--replay COMMAND_FILE] [--serve SOCKET_PATH] [--fast-exit]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+
+    if (replayPath != NULL && replayCommandFile(replayPath) != 0)
+    {
+        freeEverythingAtExit(fastExit);
+        return 1;
+    }
+    if (socketPath != NULL)
+    {
+        int status = runServer(socketPath);
+        freeEverythingAtExit(fastExit);
+        return status;
+    }
+
+    runConsoleSession();
+    freeEverythingAtExit(fastExit);
+    return 0;
+}
+#endif
+
+
+static PokemonNode *insertMissingNode(PokemonNode *root, PokemonNode *newNode);
+
+PokemonNode *insertPokemonNode(PokemonNode *root, PokemonNode *newNode) 
+{
+    unsigned long visited;
+    unsigned long long start = metricsStart(METRIC_INSERT);
+    if (findPokemonWithDepth(root, newNode->speciesId, &visited) != NULL)
+    {
+        // Duplicate: nothing to insert
+        freePokemonNode(newNode);
+    }
+    else
+    {
+        root = insertMissingNode(root, newNode);
+    }
+    metricsStop(METRIC_INSERT, start, visited);
+    return root;
+}
+
+static PokemonNode *insertMissingNode(PokemonNode *root, PokemonNode *newNode)
+{
+    if (root == NULL) 
+    {
+        // If the tree is empty, the new node becomes the root
+        return newNode;
+    }
+
+    // Every node on the way down is made private first, so a tree shared
+    // with a clone or snapshot is path-copied instead of modified.
+    root = makeNodeWritable(root);
+    PokemonNode *cur = root;
+    int id = newNode->speciesId;
+    while (1) 
+    {
+        if (id < cur->speciesId) 
+        {
+            if (nodeLeft(cur) == NULL) 
+            {
+                setNodeLeft(cur, newNode);
+                break;
+            }
+            setNodeLeft(cur, makeNodeWritable(nodeLeft(cur)));
+            cur = nodeLeft(cur);
+        } 
+        else 
+        {
+            if (nodeRight(cur) == NULL) 
+            {
+                setNodeRight(cur, newNode);
+                break;
+            }
+            setNodeRight(cur, makeNodeWritable(nodeRight(cur)));
+            cur = nodeRight(cur);
+        }
+    }
+    return root;
+}
+
+/**
+ * Unlinks an owner from the ring and drops the ring's reference to it.
+ * The node itself is retired by whoever releases the last reference, so a
+ * session still holding it (acquireOwner) keeps a valid pointer, and a
+ * lock-free reader inside an epoch never sees freed memory.
+ */
+void deleteOwnerFromList(OwnerNode *target) 
+{
+    if(target == NULL)
+    {
+            return;
+    }
+    pthread_mutex_lock(&ownerRingLock);
+    if(ownerHead == NULL || target->next == NULL)
+    {
+        // Already unlinked by someone else
+        pthread_mutex_unlock(&ownerRingLock);
+        return;
+    }
+    if(ownerHead == target && ownerHead->next == ownerHead)
+    {
+        ownerHead = NULL;
+    } else {
+        OwnerNode* temp1 = target->next;
+        OwnerNode* temp2 = target->prev;
+        temp2->next = temp1;
+        temp1->prev = temp2;
+        if(target == ownerHead)
+        {
+            ownerHead = temp1;
+        }
+    }
+    target->next = NULL;
+    target->prev = NULL;
+    ownerTrieRemove(target);
+    ownerIndexRemove(target);
+    publishRingViewLocked();
+    pthread_mutex_unlock(&ownerRingLock);
+    speciesUnindexOwner(target);
+    // Readers may still see target in an older view; the free is deferred
+    releaseOwner(target);
+}
+
+// Whether a NUL-terminated owner name equals a length-delimited one
+static int ownerNameEquals(const char *ownerName, const char *name, size_t length)
+{
+    return strncmp(ownerName, name, length) == 0 && ownerName[length] == '\0';
+}
+
+// Must be called with ownerRingLock held.
+static OwnerNode *findOwnerByNameLocked(const char *name)
+{
+    OwnerNode *current = ownerHead;
+    if (current == NULL)
+    {
+        return NULL;
+    }
+
+    // Traverse the circular list once to find the owner
+    do
+    {
+        if (strcmp(current->ownerName, name) == 0) 
+        {
+            // Found the owner
+            return current;
+        }
+        current = current->next;
+    } while (current != ownerHead);
+
+    // Owner not found
+    return NULL;
+}
+
+// Must be called inside an epoch section.
+static OwnerNode *findOwnerInView(const OwnerRingView *view, const char *name, size_t length)
+{
+    unsigned long long start = metricsStart(METRIC_OWNER_LOOKUP);
+    OwnerNode *found = NULL;
+    int i = 0;
+    for (; view != NULL && i < view->count; i++)
+    {
+        if (ownerNameEquals(view->owners[i]->ownerName, name, length))
+        {
+            found = view->owners[i];
+            i++;
+            break;
+        }
+    }
+    metricsStop(METRIC_OWNER_LOOKUP, start, (unsigned long)i);
+    return found;
+}
+
+OwnerNode *findOwnerByName(const char *name) 
+{
+    return findOwnerBySlice(name, strlen(name));
+}
+OwnerNode *acquireOwnerByName(const char *name)
+{
+    return acquireOwnerBySlice(name, strlen(name));
+}
+
+OwnerNode *findOwnerBySlice(const char *name, size_t length)
+{
+    epochEnter();
+    OwnerNode *found = findOwnerInView(currentRingView(), name, length);
+    epochExit();
+    return found;
+}
+
+OwnerNode *acquireOwnerBySlice(const char *name, size_t length)
+{
+    epochEnter();
+    OwnerNode *found = findOwnerInView(currentRingView(), name, length);
+    if (found != NULL && !tryAcquireOwner(found))
+    {
+        // Deleted and already on its way out
+        found = NULL;
+    }
+    epochExit();
+    return found;
+}
+
+OwnerNode *acquireOwnerByNumber(int number, int wrap)
+{
+    OwnerNode *found = NULL;
+    while (found == NULL)
+    {
+        epochEnter();
+        const OwnerRingView *view = currentRingView();
+        if (view == NULL || (!wrap && (number < 1 || number > view->count)))
+        {
+            epochExit();
+            return NULL;
+        }
+        OwnerNode *chosen = view->owners[number < 1 ? 0 : (number - 1) % view->count];
+        if (tryAcquireOwner(chosen))
+        {
+            found = chosen;
+        }
+        epochExit();
+        // A failed pin means the owner is being deleted: the next view won't list it
+    }
+    return found;
+}
+
+void acquireOwner(OwnerNode *owner)
+{
+    atomic_fetch_add(&owner->refCount, 1);
+}
+
+int tryAcquireOwner(OwnerNode *owner)
+{
+    int count = atomic_load(&owner->refCount);
+    while (count > 0)
+    {
+        if (atomic_compare_exchange_weak(&owner->refCount, &count, count + 1))
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void queueOwnerReclaim(OwnerNode *owner);
+
+// Runs once no reader can reach the owner; the frees happen in the background
+static void freeOwnerNodeDeferred(void *owner)
+{
+    queueOwnerReclaim((OwnerNode *)owner);
+}
+
+void releaseOwner(OwnerNode *owner)
+{
+    if (owner != NULL && atomic_fetch_sub(&owner->refCount, 1) == 1)
+    {
+        epochRetire(owner, freeOwnerNodeDeferred);
+    }
+}
+
+
+static int compareOwnersByName(const void *a, const void *b)
+{
+    const OwnerNode *ownerA = *(OwnerNode *const *)a;
+    const OwnerNode *ownerB = *(OwnerNode *const *)b;
+    return strcmp(ownerA->ownerName, ownerB->ownerName);
+}
+
+/**
+ * Sorts the ring by relinking the nodes in name order.
+ * Owners keep their identity (and their locks/pins); only next/prev change.
+ * The order comes from the name index in O(n); the qsort path only runs if
+ * the index is missing owners (an allocation failed while linking them).
+ * Returns 1 when sorted, 0 with fewer than two owners, -1 on allocation failure.
+ */
+int sortOwnerRing(void)
+{
+    pthread_mutex_lock(&ownerRingLock);
+    if (ownerHead == NULL || ownerHead->next == ownerHead) {
+        pthread_mutex_unlock(&ownerRingLock);
+        return 0;
+    }
+
+    int count = 0;
+    OwnerNode *current = ownerHead;
+    do {
+        count++;
+        current = current->next;
+    } while (current != ownerHead);
+
+    if (count == ownerIndexCount) {
+        OwnerIndexNode *node = ownerIndexHead->forward[0];
+        ownerHead = node->owner;
+        for (; node != NULL; node = node->forward[0]) {
+            OwnerNode *next = (node->forward[0] != NULL) ? node->forward[0]->owner : ownerHead;
+            node->owner->next = next;
+            next->prev = node->owner;
+        }
+        publishRingViewLocked();
+        pthread_mutex_unlock(&ownerRingLock);
+        return 1;
+    }
+
+    OwnerNode **owners = (OwnerNode **)memAlloc(MEM_SCRATCH, sizeof(OwnerNode *) * count);
+    if (owners == NULL) {
+        pthread_mutex_unlock(&ownerRingLock);
+        return -1;
+    }
+    current = ownerHead;
+    for (int i = 0; i < count; i++) {
+        owners[i] = current;
+        current = current->next;
+    }
+
+    qsort(owners, count, sizeof(OwnerNode *), compareOwnersByName);
+
+    // Relink the circular doubly linked list in sorted order
+    for (int i = 0; i < count; i++) {
+        owners[i]->next = owners[(i + 1) % count];
+        owners[i]->prev = owners[(i + count - 1) % count];
+    }
+    ownerHead = owners[0];
+    publishRingViewLocked();
+    pthread_mutex_unlock(&ownerRingLock);
+
+    memFree(MEM_SCRATCH, owners);
+    return 1;
+}
+
+
+/**
+ * Links a new OwnerNode into the circular doubly linked list.
+ * Updates pointers for the new node, the previous tail, and the head.
+ */
+// Must be called with ownerRingLock held.
+static void linkOwnerLocked(OwnerNode *newOwner)
+{
+    ownerTrieInsert(newOwner);
+    ownerIndexInsert(newOwner);
+    speciesIndexOwner(newOwner);
+    if(ownerHead == NULL)
+    {
+        ownerHead = newOwner;
+        newOwner->next = newOwner;
+        newOwner->prev = newOwner;
+        return;
+    }
+    OwnerNode* lastowner = ownerHead->prev;;
+    lastowner->next = newOwner;
+    newOwner->prev = lastowner;
+
+    newOwner->next = ownerHead;
+    ownerHead->prev = newOwner;
+    
+}
+
+void linkOwnerInCircularList(OwnerNode *newOwner)
+{
+    pthread_mutex_lock(&ownerRingLock);
+    linkOwnerLocked(newOwner);
+    publishRingViewLocked();
+    pthread_mutex_unlock(&ownerRingLock);
+}
+
+int linkOwnerIfNameFree(OwnerNode *newOwner)
+{
+    pthread_mutex_lock(&ownerRingLock);
+    int isFree = (findOwnerByNameLocked(newOwner->ownerName) == NULL);
+    if (isFree)
+    {
+        linkOwnerLocked(newOwner);
+        publishRingViewLocked();
+    }
+    pthread_mutex_unlock(&ownerRingLock);
+    return isFree;
+}
+
+
+
+PokemonNode *createPokemonNode(const PokemonData *data)
+{
+    PokemonNode *newpokemonnode = allocPokemonNode();
+    if (!newpokemonnode)
+    {
+        printf("Memory allocation failed for PokemonNode.\n");
+        return NULL;
+    }
+
+    newpokemonnode->speciesId = (uint8_t)data->id;
+    newpokemonnode->left = 0;
+    newpokemonnode->right = 0;
+    atomic_init(&newpokemonnode->refCount, 1);
+    return newpokemonnode;
+}
+
+
+
+
+OwnerNode *createOwner(char *ownerName, PokemonNode *starter)
+{
+    return createOwnerFromSlice(ownerName, strlen(ownerName), starter);
+}
+
+OwnerNode *createOwnerFromSlice(const char *name, size_t length, PokemonNode *starter)
+{
+    OwnerNode *newOwner = (OwnerNode *)memAlloc(MEM_OWNERS, sizeof(OwnerNode));
+    if (newOwner == NULL) 
+    {
+        printf("Memory allocation failed for OwnerNode.\n");
+        memFree(MEM_OWNERS, newOwner);
+        return NULL;
+    }
+
+    // Allocate memory for the ownerName and copy the provided name into it
+    newOwner->ownerName = (char *)memAlloc(MEM_OWNERS, length + 1);
+    if (newOwner->ownerName == NULL) 
+    {
+        printf("Memory allocation failed for ownerName.\n");
+        memFree(MEM_OWNERS, newOwner);
+        return NULL;
+    }
+    memcpy(newOwner->ownerName, name, length);
+    newOwner->ownerName[length] = '\0';
+
+    newOwner->pokedexRoot = starter;
+    newOwner->next = NULL;
+    newOwner->prev = NULL;
+    pthread_rwlock_init(&newOwner->dexLock, NULL);
+    // The creator's reference; linking hands it over to the ring
+    atomic_init(&newOwner->refCount, 1);
+    atomic_init(&newOwner->nodeAllocations, 0);
+    atomic_init(&newOwner->frozenDex, NULL);
+    atomic_init(&newOwner->treeReads, 0);
+    newOwner->speciesSlots = NULL;
+    newOwner->bitsRow = -1;
+    newOwner->strength = 0;
+    newOwner->boardEntry = NULL;
+    newOwner->mergedAway = 0;
+
+    return newOwner;
+
+}
+
+
+#define CYCLE_WRITE_CHUNK (1 << 16) // Bytes handed to fwrite at a time
+
+// One "name\n" per owner in stepping order; line k of a lap is text[offsets[k] .. offsets[k + 1])
+typedef struct OwnerCycle
+{
+    int count;
+    size_t *offsets;
+    char *text;
+} OwnerCycle;
+
+// Must be called inside an epoch section (reads the view's owner names)
+static int renderOwnerCycle(const OwnerRingView *view, int forward, OwnerCycle *cycle, MemCategory category)
+{
+    size_t bytes = 0;
+    for (int i = 0; i < view->count; i++)
+    {
+        bytes += strlen(view->owners[i]->ownerName) + 1;
+    }
+    cycle->count = view->count;
+    cycle->offsets = (size_t *)memAlloc(category, (size_t)(view->count + 1) * sizeof(size_t));
+    cycle->text = (char *)memAlloc(category, bytes);
+    if (cycle->offsets == NULL || cycle->text == NULL)
+    {
+        memFree(category, cycle->offsets);
+        memFree(category, cycle->text);
+        return 0;
+    }
+    size_t used = 0;
+    for (int step = 0; step < view->count; step++)
+    {
+        // Clockwise (F) or counter-clockwise (B) from head
+        int index = forward ? step : (view->count - step) % view->count;
+        const char *name = view->owners[index]->ownerName;
+        size_t length = strlen(name);
+        cycle->offsets[step] = used;
+        memcpy(cycle->text + used, name, length);
+        cycle->text[used + length] = '\n';
+        used += length + 1;
+    }
+    cycle->offsets[view->count] = used;
+    return 1;
+}
+
+/**
+ * Formats lines *done + 1 .. total into buffer until the next one doesn't
+ * fit, advancing *done. Returns the bytes used; 0 with lines left means the
+ * next line alone is longer than capacity.
+ */
+static size_t formatOwnerCycle(const OwnerCycle *cycle, long long *done, long long total, char *buffer,
+                               size_t capacity)
+{
+    // Line number as decimal text, incremented in place
+    char digits[24];
+    char *digitsEnd = digits + sizeof(digits);
+    char *digitsStart = digitsEnd;
+    for (long long number = *done + 1; number > 0; number /= 10)
+    {
+        *--digitsStart = (char)('0' + number % 10);
+    }
+
+    size_t used = 0;
+    int step = (int)(*done % cycle->count);
+    long long i = *done;
+    for (; i < total; i++)
+    {
+        size_t digitCount = (size_t)(digitsEnd - digitsStart);
+        size_t nameLength = cycle->offsets[step + 1] - cycle->offsets[step];
+        size_t lineLength = digitCount + 3 + nameLength;
+        if (used + lineLength > capacity)
+        {
+            break;
+        }
+        char *p = buffer + used;
+        *p++ = '[';
+        memcpy(p, digitsStart, digitCount);
+        p += digitCount;
+        *p++ = ']';
+        *p++ = ' ';
+        memcpy(p, cycle->text + cycle->offsets[step], nameLength);
+        used += lineLength;
+
+        if (++step == cycle->count)
+        {
+            step = 0;
+        }
+        char *digit = digitsEnd - 1;
+        while (digit >= digitsStart && *digit == '9')
+        {
+            *digit-- = '0';
+        }
+        if (digit < digitsStart)
+        {
+            *--digitsStart = '1';
+        }
+        else
+        {
+            (*digit)++;
+        }
+    }
+    *done = i;
+    return used;
+}
+
+static void freeOwnerCycle(OwnerCycle *cycle, MemCategory category)
+{
+    memFree(category, cycle->offsets);
+    memFree(category, cycle->text);
+}
+
+long long writeOwnerCycle(FILE *out, int forward, long long prints)
+{
+    OwnerCycle cycle;
+    epochEnter();
+    const OwnerRingView *view = currentRingView();
+    if (view == NULL || prints <= 0)
+    {
+        epochExit();
+        return 0;
+    }
+    char *chunk = (char *)memAlloc(MEM_SCRATCH, CYCLE_WRITE_CHUNK);
+    if (chunk == NULL || !renderOwnerCycle(view, forward, &cycle, MEM_SCRATCH))
+    {
+        // Out of memory: one line at a time straight from the view
+        memFree(MEM_SCRATCH, chunk);
+        for (long long i = 0; i < prints; i++)
+        {
+            int step = (int)(i % view->count);
+            int index = forward ? step : (view->count - step) % view->count;
+            fprintf(out, "[%lld] %s\n", i + 1, view->owners[index]->ownerName);
+        }
+        epochExit();
+        return prints;
+    }
+    // The names are copied: a long print doesn't hold back reclamation
+    epochExit();
+
+    long long done = 0;
+    while (done < prints)
+    {
+        size_t used = formatOwnerCycle(&cycle, &done, prints, chunk, CYCLE_WRITE_CHUNK);
+        if (used == 0)
+        {
+            // A name longer than the whole chunk goes out on its own
+            int step = (int)(done % cycle.count);
+            fprintf(out, "[%lld] ", done + 1);
+            fwrite(cycle.text + cycle.offsets[step], 1, cycle.offsets[step + 1] - cycle.offsets[step], out);
+            done++;
+            continue;
+        }
+        fwrite(chunk, 1, used, out);
+    }
+
+    memFree(MEM_SCRATCH, chunk);
+    freeOwnerCycle(&cycle, MEM_SCRATCH);
+    return prints;
+}
+
+//========================================
+// Streaming Export (CSV / JSON Lines)
+// Every species' part of a row is rendered once. A CSV row is then the
+// owner's escaped name plus that text, and a JSON owner line is a prefix
+// plus one rendered object per Pokemon: two memcpys per Pokemon into a
+// 1 MB buffer that is written out whole. Owners are pinned up front in one
+// short epoch section, and each tree is walked from a retained root taken
+// under the read lock, so no write holds a lock or stalls reclamation.
+//========================================
+
+#define EXPORT_BUFFER_SIZE (1 << 20)
+#define EXPORT_SPECIES_MAX 160 // Longest rendered species text, with room to spare
+
+typedef struct
+{
+    FILE *out;
+    char *buffer;
+    size_t used;
+    int failed;
+} ExportWriter;
+
+static char exportSpeciesText[2][POKEDEX_SIZE + 1][EXPORT_SPECIES_MAX];
+static size_t exportSpeciesLength[2][POKEDEX_SIZE + 1];
+static pthread_once_t exportSpeciesOnce = PTHREAD_ONCE_INIT;
+
+// CSV field: quoted, with quotes doubled, only when it holds a comma, quote or line break
+static size_t csvField(char *out, const char *text)
+{
+    if (strpbrk(text, ",\"\r\n") == NULL)
+    {
+        size_t length = strlen(text);
+        memcpy(out, text, length);
+        return length;
+    }
+    char *p = out;
+    *p++ = '"';
+    for (; *text != '\0'; text++)
+    {
+        if (*text == '"')
+        {
+            *p++ = '"';
+        }
+        *p++ = *text;
+    }
+    *p++ = '"';
+    return (size_t)(p - out);
+}
+
+// JSON string literal, control characters as \u00XX
+static size_t jsonString(char *out, const char *text)
+{
+    static const char hex[] = "0123456789abcdef";
+    char *p = out;
+    *p++ = '"';
+    for (; *text != '\0'; text++)
+    {
+        unsigned char c = (unsigned char)*text;
+        if (c == '"' || c == '\\')
+        {
+            *p++ = '\\';
+            *p++ = (char)c;
+        }
+        else if (c < 0x20)
+        {
+            memcpy(p, "\\u00", 4);
+            p[4] = hex[c >> 4];
+            p[5] = hex[c & 15];
+            p += 6;
+        }
+        else
+        {
+            *p++ = (char)c;
+        }
+    }
+    *p++ = '"';
+    return (size_t)(p - out);
+}
+
+static void renderExportSpecies(void)
+{
+    for (int id = 1; id <= POKEDEX_SIZE; id++)
+    {
+        const PokemonData *data = &pokedex[id - 1];
+        int canEvolve = data->CAN_EVOLVE == CAN_EVOLVE;
+        char name[64];
+
+        char *csv = exportSpeciesText[EXPORT_CSV][id];
+        name[csvField(name, data->name)] = '\0';
+        exportSpeciesLength[EXPORT_CSV][id] =
+            (size_t)snprintf(csv, EXPORT_SPECIES_MAX, ",%d,%s,%s,%d,%d,%s\n", data->id, name,
+                             getTypeName(data->TYPE), data->hp, data->attack, canEvolve ? "Yes" : "No");
+
+        char *json = exportSpeciesText[EXPORT_JSON_LINES][id];
+        name[jsonString(name, data->name)] = '\0';
+        exportSpeciesLength[EXPORT_JSON_LINES][id] = (size_t)snprintf(
+            json, EXPORT_SPECIES_MAX, "{\"id\":%d,\"name\":%s,\"type\":\"%s\",\"hp\":%d,\"attack\":%d,\"can_evolve\":%s}",
+            data->id, name, getTypeName(data->TYPE), data->hp, data->attack, canEvolve ? "true" : "false");
+    }
+}
+
+static void exportFlush(ExportWriter *writer)
+{
+    if (writer->used > 0 && !writer->failed && fwrite(writer->buffer, 1, writer->used, writer->out) != writer->used)
+    {
+        writer->failed = 1;
+    }
+    writer->used = 0;
+}
+
+static void exportAppend(ExportWriter *writer, const char *text, size_t length)
+{
+    if (writer->used + length > EXPORT_BUFFER_SIZE)
+    {
+        exportFlush(writer);
+        if (length > EXPORT_BUFFER_SIZE)
+        {
+            // Bigger than the whole buffer (a huge owner name): straight out
+            if (!writer->failed && fwrite(text, 1, length, writer->out) != length)
+            {
+                writer->failed = 1;
+            }
+            return;
+        }
+    }
+    memcpy(writer->buffer + writer->used, text, length);
+    writer->used += length;
+}
+
+long long exportOwners(FILE *out, ExportFormat format)
+{
+    pthread_once(&exportSpeciesOnce, renderExportSpecies);
+    ExportWriter writer = {out, (char *)memAlloc(MEM_SCRATCH, EXPORT_BUFFER_SIZE), 0, 0};
+    char *field = NULL; // The owner's part of every row (CSV) or its line prefix (JSON)
+    size_t fieldCapacity = 0;
+    if (writer.buffer == NULL)
+    {
+        return -1;
+    }
+    if (format == EXPORT_CSV)
+    {
+        static const char header[] = "owner,id,name,type,hp,attack,can_evolve\n";
+        exportAppend(&writer, header, sizeof(header) - 1);
+    }
+
+    // Pin the ring as it stands; the epoch is left before anything is formatted or written
+    OwnerNode **owners = NULL;
+    int ownerCount = 0;
+    int outOfMemory = 0;
+    epochEnter();
+    const OwnerRingView *view = currentRingView();
+    if (view != NULL && view->count > 0)
+    {
+        owners = (OwnerNode **)memAlloc(MEM_SCRATCH, (size_t)view->count * sizeof(OwnerNode *));
+        outOfMemory = (owners == NULL);
+        for (int i = 0; owners != NULL && i < view->count; i++)
+        {
+            if (tryAcquireOwner(view->owners[i]))
+            {
+                owners[ownerCount++] = view->owners[i];
+            }
+        }
+    }
+    epochExit();
+
+    long long written = 0;
+    int i = 0;
+    for (; i < ownerCount && !writer.failed && !outOfMemory; i++)
+    {
+        OwnerNode *owner = owners[i];
+        size_t needed = strlen(owner->ownerName) * 6 + 32;
+        if (needed > fieldCapacity)
+        {
+            char *grown = (char *)memRealloc(MEM_SCRATCH, field, needed);
+            if (grown == NULL)
+            {
+                outOfMemory = 1;
+                break;
+            }
+            field = grown;
+            fieldCapacity = needed;
+        }
+        size_t fieldLength;
+        if (format == EXPORT_CSV)
+        {
+            fieldLength = csvField(field, owner->ownerName);
+        }
+        else
+        {
+            memcpy(field, "{\"owner\":", 9);
+            fieldLength = 9 + jsonString(field + 9, owner->ownerName);
+            memcpy(field + fieldLength, ",\"pokemon\":[", 12);
+            fieldLength += 12;
+        }
+
+        // A retained root is a frozen copy: writers copy the path they change
+        lockOwnerRead(owner);
+        PokemonNode *snapshot = retainPokemonNode(owner->pokedexRoot);
+        unlockOwner(owner);
+
+        if (format == EXPORT_JSON_LINES)
+        {
+            exportAppend(&writer, field, fieldLength);
+        }
+        // In-order walk: rows come out by ID
+        PokemonNode *stack[POKEDEX_SIZE + 1];
+        int top = 0;
+        PokemonNode *node = snapshot;
+        int first = 1;
+        while (node != NULL || top > 0)
+        {
+            while (node != NULL)
+            {
+                stack[top++] = node;
+                node = nodeLeft(node);
+            }
+            node = stack[--top];
+            int id = node->speciesId;
+            if (format == EXPORT_CSV)
+            {
+                exportAppend(&writer, field, fieldLength);
+            }
+            else if (!first)
+            {
+                exportAppend(&writer, ",", 1);
+            }
+            exportAppend(&writer, exportSpeciesText[format][id], exportSpeciesLength[format][id]);
+            first = 0;
+            written++;
+            node = nodeRight(node);
+        }
+        if (format == EXPORT_JSON_LINES)
+        {
+            exportAppend(&writer, "]}\n", 3);
+        }
+        freePokemonTree(snapshot);
+        releaseOwner(owner);
+    }
+    // Owners left unwritten after a failure still hold their pins
+    for (; i < ownerCount; i++)
+    {
+        releaseOwner(owners[i]);
+    }
+    memFree(MEM_SCRATCH, owners);
+
+    exportFlush(&writer);
+    memFree(MEM_SCRATCH, writer.buffer);
+    memFree(MEM_SCRATCH, field);
+    return (writer.failed || outOfMemory) ? -1 : written;
+}
+
+
+//========================================
+// Persistent (copy-on-write) Pokedex Trees
+// Nodes are reference counted: a clone or snapshot shares the whole tree,
+// and a mutation copies just the nodes on its root-to-target path.
+//========================================
+
+PokemonNode *retainPokemonNode(PokemonNode *node)
+{
+    if (node != NULL)
+    {
+        atomic_fetch_add(&node->refCount, 1);
+    }
+    return node;
+}
+
+/**
+ * Returns a node that is safe to modify in place.
+ * A private node (refCount 1) is returned as-is; a shared node is copied,
+ * the copy holds new references to both children, and the caller's old
+ * reference to the shared node is dropped.
+ * Only nodes reached through a private parent are ever checked, so a count
+ * of 1 really means nobody else can see the node.
+ */
+PokemonNode *makeNodeWritable(PokemonNode *node)
+{
+    if (node == NULL || atomic_load(&node->refCount) == 1)
+    {
+        return node;
+    }
+
+    PokemonNode *copy = createPokemonNode(nodeData(node));
+    if (copy == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed while copying a shared node.\n");
+        exit(EXIT_FAILURE);
+    }
+    setNodeLeft(copy, retainPokemonNode(nodeLeft(node)));
+    setNodeRight(copy, retainPokemonNode(nodeRight(node)));
+    // Drop our reference; if the other sharers let go meanwhile, this frees it
+    freePokemonTree(node);
+    return copy;
+}
+
+/**
+ * O(1) clone: the new owner shares the source tree until either side changes.
+ */
+OwnerNode *clonePokedex(OwnerNode *source, const char *newOwnerName, size_t nameLength)
+{
+    if (source == NULL || newOwnerName == NULL)
+    {
+        return NULL;
+    }
+
+    lockOwnerRead(source);
+    PokemonNode *shared = retainPokemonNode(source->pokedexRoot);
+    unlockOwner(source);
+
+    OwnerNode *clone = createOwnerFromSlice(newOwnerName, nameLength, shared);
+    if (clone == NULL)
+    {
+        freePokemonTree(shared);
+        return NULL;
+    }
+    if (!linkOwnerIfNameFree(clone))
+    {
+        releaseOwner(clone);
+        return NULL;
+    }
+    return clone;
+}
+
+/**
+ * Read-only picture of every owner at this moment.
+ * Each entry keeps its own reference to the tree, so later edits on the
+ * live owners path-copy around it and the snapshot never changes.
+ */
+OwnerRingSnapshot *snapshotOwners(void)
+{
+    OwnerRingSnapshot *snap = (OwnerRingSnapshot *)memAlloc(MEM_SCRATCH, sizeof(OwnerRingSnapshot));
+    if (snap == NULL)
+    {
+        printf("Memory allocation failed for snapshot.\n");
+        return NULL;
+    }
+    snap->count = 0;
+    snap->entries = NULL;
+    epochEnter();
+    const OwnerRingView *view = currentRingView();
+    if (view == NULL)
+    {
+        epochExit();
+        return snap;
+    }
+
+    snap->entries = (OwnerSnapshotEntry *)memAlloc(MEM_SCRATCH, sizeof(OwnerSnapshotEntry) * view->count);
+    if (snap->entries == NULL)
+    {
+        epochExit();
+        printf("Memory allocation failed for snapshot.\n");
+        memFree(MEM_SCRATCH, snap);
+        return NULL;
+    }
+
+    // No ring lock at all; each owner is read-locked only long enough
+    // to bump its root's count
+    for (int i = 0; i < view->count; i++)
+    {
+        OwnerNode *cur = view->owners[i];
+        OwnerSnapshotEntry *entry = &snap->entries[snap->count++];
+        entry->ownerName = myStrdup(cur->ownerName);
+        lockOwnerRead(cur);
+        entry->pokedexRoot = retainPokemonNode(cur->pokedexRoot);
+        unlockOwner(cur);
+    }
+    epochExit();
+
+    return snap;
+}
+
+void freeOwnerSnapshot(OwnerRingSnapshot *snap)
+{
+    if (snap == NULL)
+    {
+        return;
+    }
+    for (int i = 0; i < snap->count; i++)
+    {
+        memFree(MEM_SCRATCH, snap->entries[i].ownerName);
+        freePokemonTree(snap->entries[i].pokedexRoot);
+    }
+    memFree(MEM_SCRATCH, snap->entries);
+    memFree(MEM_SCRATCH, snap);
+}
+
+//========================================
+// Lock-free Owner Ring Reads (epoch-based reclamation)
+// Readers wrap their walk in epochEnter()/epochExit() and never lock.
+// Writers (serialized by ownerRingLock) publish a fresh OwnerRingView
+// and hand anything readers might still hold to epochRetire(); it is
+// freed once every thread has left the epoch it could have seen it in.
+//========================================
+
+typedef struct EpochParticipant
+{
+    atomic_ulong localEpoch;        // Global epoch seen when the section began
+    atomic_int active;              // Inside an epoch section right now?
+    atomic_int inUse;               // Claimed by a live thread?
+    int nesting;                    // Only touched by the owning thread
+    struct EpochParticipant *next;  // Registry links are never removed
+} EpochParticipant;
+
+typedef struct RetiredItem
+{
+    void *ptr;
+    void (*freeFn)(void *);
+    unsigned long epoch;
+    struct RetiredItem *next;
+} RetiredItem;
+
+static atomic_ulong globalEpoch = 1;
+static _Atomic(EpochParticipant *) epochParticipants = NULL;
+static pthread_mutex_t retireLock = PTHREAD_MUTEX_INITIALIZER;
+static RetiredItem *retiredList = NULL;
+static pthread_key_t epochKey;
+static pthread_once_t epochKeyOnce = PTHREAD_ONCE_INIT;
+static _Thread_local EpochParticipant *epochSelf = NULL;
+
+// Thread exit: give the participant record back for reuse
+static void releaseParticipant(void *arg)
+{
+    EpochParticipant *self = (EpochParticipant *)arg;
+    atomic_store(&self->active, 0);
+    atomic_store(&self->inUse, 0);
+}
+
+static void makeEpochKey(void)
+{
+    pthread_key_create(&epochKey, releaseParticipant);
+}
+
+static EpochParticipant *registerParticipant(void)
+{
+    pthread_once(&epochKeyOnce, makeEpochKey);
+
+    // Reuse a record left behind by a finished thread if there is one
+    EpochParticipant *p = atomic_load(&epochParticipants);
+    for (; p != NULL; p = p->next)
+    {
+        int expected = 0;
+        if (atomic_compare_exchange_strong(&p->inUse, &expected, 1))
+        {
+            break;
+        }
+    }
+
+    if (p == NULL)
+    {
+        p = (EpochParticipant *)calloc(1, sizeof(EpochParticipant));
+        if (p == NULL)
+        {
+            fprintf(stderr, "Memory allocation failed for epoch participant.\n");
+            exit(EXIT_FAILURE);
+        }
+        atomic_init(&p->inUse, 1);
+        p->next = atomic_load(&epochParticipants);
+        while (!atomic_compare_exchange_weak(&epochParticipants, &p->next, p))
+        {
+        }
+    }
+
+    p->nesting = 0;
+    pthread_setspecific(epochKey, p);
+    epochSelf = p;
+    return p;
+}
+
+void epochEnter(void)
+{
+    EpochParticipant *self = epochSelf ? epochSelf : registerParticipant();
+    if (self->nesting++ > 0)
+    {
+        return;
+    }
+    // Announce ourselves before reading any shared pointer (seq_cst)
+    atomic_store(&self->active, 1);
+    atomic_store(&self->localEpoch, atomic_load(&globalEpoch));
+}
+
+void epochExit(void)
+{
+    EpochParticipant *self = epochSelf;
+    if (--self->nesting == 0)
+    {
+        atomic_store(&self->active, 0);
+    }
+}
+
+// Bump the global epoch if every active reader has caught up with it.
+static unsigned long tryAdvanceEpoch(void)
+{
+    unsigned long epoch = atomic_load(&globalEpoch);
+    for (EpochParticipant *p = atomic_load(&epochParticipants); p != NULL; p = p->next)
+    {
+        if (atomic_load(&p->active) && atomic_load(&p->localEpoch) != epoch)
+        {
+            return epoch;
+        }
+    }
+    atomic_compare_exchange_strong(&globalEpoch, &epoch, epoch + 1);
+    return atomic_load(&globalEpoch);
+}
+
+// Frees retired items at least two epochs old. Caller holds retireLock.
+static void reclaimRetiredLocked(unsigned long epoch)
+{
+    RetiredItem **link = &retiredList;
+    while (*link != NULL)
+    {
+        RetiredItem *item = *link;
+        if (item->epoch + 2 <= epoch)
+        {
+            *link = item->next;
+            item->freeFn(item->ptr);
+            memFree(MEM_EPOCH, item);
+        }
+        else
+        {
+            link = &item->next;
+        }
+    }
+}
+
+void epochRetire(void *ptr, void (*freeFn)(void *))
+{
+    RetiredItem *item = (RetiredItem *)memAlloc(MEM_EPOCH, sizeof(RetiredItem));
+    if (item == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed for retired item.\n");
+        exit(EXIT_FAILURE);
+    }
+    item->ptr = ptr;
+    item->freeFn = freeFn;
+
+    pthread_mutex_lock(&retireLock);
+    item->epoch = atomic_load(&globalEpoch);
+    item->next = retiredList;
+    retiredList = item;
+    reclaimRetiredLocked(tryAdvanceEpoch());
+    pthread_mutex_unlock(&retireLock);
+}
+
+static void drainOwnerReclaimer(void);
+
+void epochReclaimAll(void)
+{
+    pthread_mutex_lock(&retireLock);
+    // Two clean advances put every retired item out of any reader's reach
+    while (retiredList != NULL)
+    {
+        unsigned long before = atomic_load(&globalEpoch);
+        reclaimRetiredLocked(tryAdvanceEpoch());
+        if (retiredList != NULL && atomic_load(&globalEpoch) == before)
+        {
+            // A reader is still inside; let it finish
+            pthread_mutex_unlock(&retireLock);
+            sched_yield();
+            pthread_mutex_lock(&retireLock);
+        }
+    }
+    pthread_mutex_unlock(&retireLock);
+    // Owners reclaimed above may still be waiting for the background thread
+    drainOwnerReclaimer();
+}
+
+const OwnerRingView *currentRingView(void)
+{
+    return atomic_load(&ownerRingView);
+}
+
+int currentRingSize(void)
+{
+    epochEnter();
+    const OwnerRingView *view = currentRingView();
+    int count = (view != NULL) ? view->count : 0;
+    epochExit();
+    return count;
+}
+
+static void freeRingView(void *view)
+{
+    memFree(MEM_RING_VIEWS, view);
+}
+
+/**
+ * Rebuilds the reader view from the ring (head first) and swaps it in.
+ * Must be called with ownerRingLock held, after the links are final.
+ */
+void publishRingViewLocked(void)
+{
+    OwnerRingView *view = NULL;
+    if (ownerHead != NULL)
+    {
+        int count = 0;
+        OwnerNode *cur = ownerHead;
+        do
+        {
+            count++;
+            cur = cur->next;
+        } while (cur != ownerHead);
+
+        view = (OwnerRingView *)memAlloc(MEM_RING_VIEWS, sizeof(OwnerRingView) + sizeof(OwnerNode *) * count);
+        if (view == NULL)
+        {
+            fprintf(stderr, "Memory allocation failed for owner ring view.\n");
+            exit(EXIT_FAILURE);
+        }
+        view->count = count;
+        cur = ownerHead;
+        for (int i = 0; i < count; i++)
+        {
+            view->owners[i] = cur;
+            cur = cur->next;
+        }
+    }
+
+    OwnerRingView *old = atomic_exchange(&ownerRingView, view);
+    if (old != NULL)
+    {
+        epochRetire(old, freeRingView);
+    }
+}
+
+//========================================
+// Background Owner Reclamation
+// Once the epoch says no reader can reach a released owner, its tree,
+// name and record are freed by one background thread instead of the
+// thread that happened to retire it: freeOwnerNodeDeferred only pushes the
+// owner onto reclaimQueue (linked through its unused next field), O(1).
+// The thread takes the whole queue at every wakeup and frees it as one
+// batch. If the thread can't be started, or has been shut down, owners
+// are freed inline as before.
+//========================================
+
+typedef enum
+{
+    RECLAIMER_NOT_STARTED,
+    RECLAIMER_RUNNING,
+    RECLAIMER_INLINE // Never started, or shut down: free on the caller
+} ReclaimerState;
+
+static OwnerNode *reclaimQueue;
+static int reclaimBusy; // The thread is freeing a batch it took off the queue
+static int reclaimStop;
+static ReclaimerState reclaimerState = RECLAIMER_NOT_STARTED;
+static atomic_int reclaimExiting; // Process is exiting: leave the memory to the OS
+static pthread_t reclaimThread;
+static pthread_mutex_t reclaimLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t reclaimWake = PTHREAD_COND_INITIALIZER; // Work queued, or stop
+static pthread_cond_t reclaimIdle = PTHREAD_COND_INITIALIZER; // Queue empty and no batch in progress
+
+static void *ownerReclaimerMain(void *arg)
+{
+    (void)arg;
+    pthread_mutex_lock(&reclaimLock);
+    while (!reclaimStop || reclaimQueue != NULL)
+    {
+        if (reclaimQueue == NULL)
+        {
+            pthread_cond_wait(&reclaimWake, &reclaimLock);
+            continue;
+        }
+        OwnerNode *batch = reclaimQueue;
+        reclaimQueue = NULL;
+        reclaimBusy = 1;
+        pthread_mutex_unlock(&reclaimLock);
+
+        while (batch != NULL && !atomic_load(&reclaimExiting))
+        {
+            OwnerNode *next = batch->next;
+            freeOwnerNode(batch);
+            batch = next;
+        }
+
+        pthread_mutex_lock(&reclaimLock);
+        reclaimBusy = 0;
+        if (reclaimQueue == NULL)
+        {
+            pthread_cond_broadcast(&reclaimIdle);
+        }
+    }
+    pthread_mutex_unlock(&reclaimLock);
+    return NULL;
+}
+
+// The owner is unreachable (no references, no reader in an older epoch)
+static void queueOwnerReclaim(OwnerNode *owner)
+{
+    pthread_mutex_lock(&reclaimLock);
+    if (reclaimerState == RECLAIMER_NOT_STARTED)
+    {
+        int started = pthread_create(&reclaimThread, NULL, ownerReclaimerMain, NULL) == 0;
+        reclaimerState = started ? RECLAIMER_RUNNING : RECLAIMER_INLINE;
+    }
+    if (reclaimerState == RECLAIMER_RUNNING)
+    {
+        owner->next = reclaimQueue;
+        reclaimQueue = owner;
+        pthread_cond_signal(&reclaimWake);
+        pthread_mutex_unlock(&reclaimLock);
+        return;
+    }
+    pthread_mutex_unlock(&reclaimLock);
+    if (!atomic_load(&reclaimExiting))
+    {
+        freeOwnerNode(owner);
+    }
+}
+
+// Waits until every owner queued so far has been freed
+static void drainOwnerReclaimer(void)
+{
+    pthread_mutex_lock(&reclaimLock);
+    while (reclaimerState == RECLAIMER_RUNNING && (reclaimQueue != NULL || reclaimBusy))
+    {
+        pthread_cond_wait(&reclaimIdle, &reclaimLock);
+    }
+    pthread_mutex_unlock(&reclaimLock);
+}
+
+void shutdownOwnerReclaimer(int exiting)
+{
+    if (exiting)
+    {
+        atomic_store(&reclaimExiting, 1);
+    }
+    pthread_mutex_lock(&reclaimLock);
+    int running = reclaimerState == RECLAIMER_RUNNING;
+    reclaimerState = RECLAIMER_INLINE;
+    reclaimStop = 1;
+    pthread_cond_signal(&reclaimWake);
+    pthread_mutex_unlock(&reclaimLock);
+    if (running)
+    {
+        // Frees what is queued first, unless exiting
+        pthread_join(reclaimThread, NULL);
+    }
+    pthread_mutex_lock(&reclaimLock);
+    reclaimQueue = NULL;
+    pthread_mutex_unlock(&reclaimLock);
+}
+
+//========================================
+// Memory Management & Freeing
+// Ensures no memory leaks by recursively freeing trees and lists.
+//========================================
+
+void freePokemonNode(PokemonNode* node)
+{
+    if (node == NULL)
+    {
+        return;
+    }
+    releasePokemonNodeSlot(node);
+}
+
+/**
+ * Drops one reference to the tree. Nodes still shared with another tree
+ * (clone or snapshot) survive; only nodes nobody else points at are freed.
+ */
+void freePokemonTree(PokemonNode *root)
+{
+    if (root == NULL)
+    {
+        return;
+    }
+    if (atomic_fetch_sub(&root->refCount, 1) > 1)
+    {
+        return;
+    }
+    freePokemonTree(nodeLeft(root));
+    freePokemonTree(nodeRight(root));
+    freePokemonNode(root);
+}
+
+void freeOwnerNode(OwnerNode *owner)
+{
+    if (owner == NULL)
+    {
+        return;
+    }
+    freePokemonTree(owner->pokedexRoot);
+    dropFrozenDex(owner);
+    pthread_rwlock_destroy(&owner->dexLock);
+    memFree(MEM_OWNERS, owner->ownerName);
+    memFree(MEM_OWNERS, owner);
+}
+
+void freeAllOwners() 
+{
+    pthread_mutex_lock(&ownerRingLock);
+    if (ownerHead == NULL) 
+    {
+        pthread_mutex_unlock(&ownerRingLock);
+        return;
+    }
+
+    OwnerNode *head = ownerHead;
+    OwnerNode *current = head;
+    OwnerNode *nextNode;
+    // Reset the head pointer to NULL as the list is now empty
+    ownerHead = NULL;
+    if (atomic_load(&reclaimExiting))
+    {
+        // Exit fast path: no owner, node or index entry is freed one by one
+        publishRingViewLocked();
+        pthread_mutex_unlock(&ownerRingLock);
+        return;
+    }
+    ownerTrieClear();
+    ownerIndexClear();
+    publishRingViewLocked();
+    pthread_mutex_unlock(&ownerRingLock);
+
+    // Traverse the detached ring and drop the ring's reference to each node
+    do 
+    {
+        nextNode = current->next;
+        current->next = NULL;
+        current->prev = NULL;
+        speciesUnindexOwner(current);
+        releaseOwner(current);
+        current = nextNode;
+    } 
+    while (current != head);
+}
+
+//========================================
+// Instrumentation
+// Every thread records into its own MetricsBlock, so the core paths
+// never share a cache line or a lock for bookkeeping. Counters are
+// written only by their thread (relaxed load + store, no RMW) and read
+// by metricsDump() from any thread. Blocks of finished threads are
+// reused, keeping their totals.
+//========================================
+
+typedef struct
+{
+    atomic_ullong calls;
+    atomic_ullong visitedSum;
+    atomic_ullong visitedMax;
+    LatencyHistogram latency;
+} OpMetrics;
+
+typedef struct
+{
+    atomic_ullong allocs;
+    atomic_ullong frees;
+    atomic_ullong allocBytes;
+    atomic_ullong freeBytes;
+} MemCounters;
+
+typedef struct MetricsBlock
+{
+    OpMetrics ops[METRIC_COUNT];
+    MemCounters mem[MEM_CATEGORY_COUNT]; // Frees may land on another thread's block
+    atomic_int inUse;
+    struct MetricsBlock *next; // Registry links are never removed
+} MetricsBlock;
+
+static const char *metricNames[METRIC_COUNT] = {"search", "insert", "delete", "evolve",
+                                                "merge", "lookup", "display"};
+
+// Latency sampling: time 1 call in (mask + 1); every call is still counted
+static const unsigned long long metricSampleMask[METRIC_COUNT] = {15, 15, 15, 15, 0, 0, 0};
+
+static _Atomic(MetricsBlock *) metricsBlocks = NULL;
+static pthread_key_t metricsKey;
+static pthread_once_t metricsKeyOnce = PTHREAD_ONCE_INIT;
+static _Thread_local MetricsBlock *metricsSelf = NULL;
+
+// Single-writer increment: plain load/add/store, but race-free for readers
+static inline void counterAdd(atomic_ullong *counter, unsigned long long amount)
+{
+    atomic_store_explicit(counter, atomic_load_explicit(counter, memory_order_relaxed) + amount,
+                          memory_order_relaxed);
+}
+
+static inline void counterMax(atomic_ullong *counter, unsigned long long value)
+{
+    if (value > atomic_load_explicit(counter, memory_order_relaxed))
+    {
+        atomic_store_explicit(counter, value, memory_order_relaxed);
+    }
+}
+
+unsigned long long monotonicNanos(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + (unsigned long long)ts.tv_nsec;
+}
+
+// Values below LATENCY_SUB_COUNT get exact buckets; above that, each power
+// of two is split into LATENCY_SUB_COUNT equal steps.
+static int latencyBucket(unsigned long long nanos)
+{
+    if (nanos < LATENCY_SUB_COUNT)
+    {
+        return (int)nanos;
+    }
+    int shift = (63 - __builtin_clzll(nanos)) - LATENCY_SUB_BITS;
+    if (shift > LATENCY_MAX_SHIFT)
+    {
+        return LATENCY_BUCKETS - 1;
+    }
+    return (shift + 1) * LATENCY_SUB_COUNT + (int)((nanos >> shift) & (LATENCY_SUB_COUNT - 1));
+}
+
+static unsigned long long latencyBucketUpper(int bucket)
+{
+    if (bucket < LATENCY_SUB_COUNT)
+    {
+        return (unsigned long long)bucket + 1;
+    }
+    int shift = bucket / LATENCY_SUB_COUNT - 1;
+    unsigned long long sub = (unsigned long long)(bucket % LATENCY_SUB_COUNT);
+    return (LATENCY_SUB_COUNT + sub + 1) << shift;
+}
+
+void latencyRecord(LatencyHistogram *hist, unsigned long long nanos)
+{
+    counterAdd(&hist->counts[latencyBucket(nanos)], 1);
+    counterAdd(&hist->total, 1);
+    counterAdd(&hist->sumNanos, nanos);
+    counterMax(&hist->maxNanos, nanos);
+}
+
+void latencyMerge(LatencyHistogram *dst, const LatencyHistogram *src)
+{
+    // Sum the buckets and derive total from them, so dst is self-consistent
+    // even while src keeps recording
+    unsigned long long total = 0;
+    for (int bucket = 0; bucket < LATENCY_BUCKETS; bucket++)
+    {
+        unsigned long long count = atomic_load_explicit(&src->counts[bucket], memory_order_relaxed);
+        counterAdd(&dst->counts[bucket], count);
+        total += count;
+    }
+    counterAdd(&dst->total, total);
+    counterAdd(&dst->sumNanos, atomic_load_explicit(&src->sumNanos, memory_order_relaxed));
+    counterMax(&dst->maxNanos, atomic_load_explicit(&src->maxNanos, memory_order_relaxed));
+}
+
+unsigned long long latencyPercentile(const LatencyHistogram *hist, double percentile)
+{
+    unsigned long long total = atomic_load_explicit(&hist->total, memory_order_relaxed);
+    unsigned long long maxNanos = atomic_load_explicit(&hist->maxNanos, memory_order_relaxed);
+    if (total == 0)
+    {
+        return 0;
+    }
+    unsigned long long rank = (unsigned long long)(percentile / 100.0 * total);
+    unsigned long long seen = 0;
+    for (int bucket = 0; bucket < LATENCY_BUCKETS; bucket++)
+    {
+        seen += atomic_load_explicit(&hist->counts[bucket], memory_order_relaxed);
+        if (seen > rank)
+        {
+            // Report the bucket's upper bound (never above the slowest sample)
+            unsigned long long bound = latencyBucketUpper(bucket);
+            return bound < maxNanos ? bound : maxNanos;
+        }
+    }
+    return maxNanos;
+}
+
+// Thread exit: hand the block (and its totals) to the next new thread
+static void releaseMetricsBlock(void *arg)
+{
+    metricsSelf = NULL;
+    atomic_store(&((MetricsBlock *)arg)->inUse, 0);
+}
+
+static void makeMetricsKey(void)
+{
+    pthread_key_create(&metricsKey, releaseMetricsBlock);
+}
+
+static MetricsBlock *registerMetricsBlock(void)
+{
+    pthread_once(&metricsKeyOnce, makeMetricsKey);
+
+    MetricsBlock *block = atomic_load(&metricsBlocks);
+    for (; block != NULL; block = block->next)
+    {
+        int expected = 0;
+        if (atomic_compare_exchange_strong(&block->inUse, &expected, 1))
+        {
+            break;
+        }
+    }
+
+    if (block == NULL)
+    {
+        // Plain calloc: the accounting can't account for its own storage
+        block = (MetricsBlock *)calloc(1, sizeof(MetricsBlock));
+        if (block == NULL)
+        {
+            fprintf(stderr, "Memory allocation failed for metrics.\n");
+            exit(EXIT_FAILURE);
+        }
+        atomic_init(&block->inUse, 1);
+        block->next = atomic_load(&metricsBlocks);
+        while (!atomic_compare_exchange_weak(&metricsBlocks, &block->next, block))
+        {
+        }
+    }
+
+    pthread_setspecific(metricsKey, block);
+    metricsSelf = block;
+    return block;
+}
+
+unsigned long long metricsStart(MetricOp op)
+{
+    MetricsBlock *self = metricsSelf ? metricsSelf : registerMetricsBlock();
+    unsigned long long calls = atomic_load_explicit(&self->ops[op].calls, memory_order_relaxed);
+    return (calls & metricSampleMask[op]) ? 0 : monotonicNanos();
+}
+
+void metricsStop(MetricOp op, unsigned long long start, unsigned long visited)
+{
+    OpMetrics *metrics = &metricsSelf->ops[op];
+    counterAdd(&metrics->calls, 1);
+    counterAdd(&metrics->visitedSum, visited);
+    counterMax(&metrics->visitedMax, visited);
+    if (start != 0)
+    {
+        latencyRecord(&metrics->latency, monotonicNanos() - start);
+    }
+}
+
+void metricsDump(FILE *out)
+{
+    static LatencyHistogram merged; // Large; only built here, under dumpLock
+    static pthread_mutex_t dumpLock = PTHREAD_MUTEX_INITIALIZER;
+
+    pthread_mutex_lock(&dumpLock);
+    int threads = 0;
+    for (MetricsBlock *block = atomic_load(&metricsBlocks); block != NULL; block = block->next)
+    {
+        threads++;
+    }
+
+    fprintf(out, "\n=== Metrics (%d thread%s) ===\n", threads, threads == 1 ? "" : "s");
+    fprintf(out, "%-8s %12s %10s %9s %9s %10s %10s %10s %10s\n", "op", "calls", "timed", "avg visit",
+            "max visit", "p50 us", "p99 us", "p999 us", "max us");
+    for (int op = 0; op < METRIC_COUNT; op++)
+    {
+        unsigned long long calls = 0, visitedSum = 0, visitedMax = 0;
+        memset(&merged, 0, sizeof(merged));
+        for (MetricsBlock *block = atomic_load(&metricsBlocks); block != NULL; block = block->next)
+        {
+            OpMetrics *metrics = &block->ops[op];
+            calls += atomic_load_explicit(&metrics->calls, memory_order_relaxed);
+            visitedSum += atomic_load_explicit(&metrics->visitedSum, memory_order_relaxed);
+            unsigned long long blockMax = atomic_load_explicit(&metrics->visitedMax, memory_order_relaxed);
+            visitedMax = blockMax > visitedMax ? blockMax : visitedMax;
+            latencyMerge(&merged, &metrics->latency);
+        }
+        fprintf(out, "%-8s %12llu %10llu %9.2f %9llu %10.2f %10.2f %10.2f %10.2f\n", metricNames[op], calls,
+                (unsigned long long)merged.total, calls ? (double)visitedSum / calls : 0.0, visitedMax,
+                latencyPercentile(&merged, 50) / 1000.0, latencyPercentile(&merged, 99) / 1000.0,
+                latencyPercentile(&merged, 99.9) / 1000.0, merged.maxNanos / 1000.0);
+    }
+    fflush(out);
+    pthread_mutex_unlock(&dumpLock);
+}
+
+static void *metricsSignalThread(void *arg)
+{
+    sigset_t *set = (sigset_t *)arg;
+    int sig;
+    while (sigwait(set, &sig) == 0)
+    {
+        metricsDump(stderr);
+        memoryReport(stderr, 10);
+    }
+    return NULL;
+}
+
+void metricsDumpOnSignal(void)
+{
+    static sigset_t set;
+    sigemptyset(&set);
+    sigaddset(&set, SIGUSR1);
+    // Threads created from here on inherit the mask; only the helper receives it
+    pthread_sigmask(SIG_BLOCK, &set, NULL);
+
+    pthread_t helper;
+    if (pthread_create(&helper, NULL, metricsSignalThread, &set) == 0)
+    {
+        pthread_detach(helper);
+    }
+}
+
+//========================================
+// Memory Accounting
+// Every allocation names a MemCategory. Sizes come from
+// malloc_usable_size(), so blocks carry no header and callers never pass
+// sizes to memFree(); pooled tree nodes count sizeof(PokemonNode).
+// Counts go to the thread's MetricsBlock; live bytes are allocated minus
+// freed, summed over all threads. Per-owner cost is measured on demand by
+// walking each owner's tree.
+//========================================
+
+static const char *memCategoryNames[MEM_CATEGORY_COUNT] = {"nodes", "owners", "ring views", "epoch",
+                                                           "scratch", "sessions", "indexes"};
+
+static inline MemCounters *memCounters(MemCategory category)
+{
+    MetricsBlock *self = metricsSelf ? metricsSelf : registerMetricsBlock();
+    return &self->mem[category];
+}
+
+static void memCountAlloc(MemCategory category, size_t bytes)
+{
+    MemCounters *counters = memCounters(category);
+    counterAdd(&counters->allocs, 1);
+    counterAdd(&counters->allocBytes, bytes);
+    if (category == MEM_POKEMON_NODES && memOwnerContext != NULL)
+    {
+        // Serialized by the owner's write lock
+        atomic_store_explicit(&memOwnerContext->nodeAllocations,
+                              atomic_load_explicit(&memOwnerContext->nodeAllocations, memory_order_relaxed) + 1,
+                              memory_order_relaxed);
+    }
+}
+
+static void memCountFree(MemCategory category, size_t bytes)
+{
+    MemCounters *counters = memCounters(category);
+    counterAdd(&counters->frees, 1);
+    counterAdd(&counters->freeBytes, bytes);
+}
+
+void *memAlloc(MemCategory category, size_t size)
+{
+    void *ptr = malloc(size);
+    if (ptr != NULL)
+    {
+        memCountAlloc(category, malloc_usable_size(ptr));
+    }
+    return ptr;
+}
+
+void *memCalloc(MemCategory category, size_t count, size_t size)
+{
+    void *ptr = calloc(count, size);
+    if (ptr != NULL)
+    {
+        memCountAlloc(category, malloc_usable_size(ptr));
+    }
+    return ptr;
+}
+
+void *memRealloc(MemCategory category, void *ptr, size_t size)
+{
+    size_t oldSize = malloc_usable_size(ptr);
+    void *moved = realloc(ptr, size);
+    if (moved == NULL)
+    {
+        return NULL;
+    }
+    MemCounters *counters = memCounters(category);
+    if (ptr == NULL)
+    {
+        counterAdd(&counters->allocs, 1);
+    }
+    // Net change only; a resize isn't a new block
+    counterAdd(&counters->freeBytes, oldSize);
+    counterAdd(&counters->allocBytes, malloc_usable_size(moved));
+    return moved;
+}
+
+char *memStrdup(MemCategory category, const char *src)
+{
+    size_t len = strlen(src);
+    char *copy = (char *)memAlloc(category, len + 1);
+    if (copy == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed for string.\n");
+        return NULL;
+    }
+    memcpy(copy, src, len + 1);
+    return copy;
+}
+
+void memFree(MemCategory category, void *ptr)
+{
+    if (ptr == NULL)
+    {
+        return;
+    }
+    memCountFree(category, malloc_usable_size(ptr));
+    free(ptr);
+}
+
+typedef struct
+{
+    OwnerNode *owner;
+    size_t bytes;         // Owner record + name + nodes only this owner reaches
+    size_t sharedBytes;   // Nodes shared with clones/snapshots
+    int nodes;
+    int sharedNodes;
+} OwnerMemory;
+
+static int compareOwnerMemory(const void *a, const void *b)
+{
+    const OwnerMemory *ownerA = (const OwnerMemory *)a;
+    const OwnerMemory *ownerB = (const OwnerMemory *)b;
+    size_t totalA = ownerA->bytes + ownerA->sharedBytes;
+    size_t totalB = ownerB->bytes + ownerB->sharedBytes;
+    return (totalA < totalB) - (totalA > totalB); // Biggest first
+}
+
+// A node is private when it and every ancestor have refCount 1. Caller holds the read lock.
+static void measureOwnerTree(PokemonNode *root, OwnerMemory *usage)
+{
+    PokemonNode *stack[POKEDEX_SIZE + 1];
+    int sharedFrom[POKEDEX_SIZE + 1];
+    int top = 0;
+    if (root != NULL)
+    {
+        stack[top] = root;
+        sharedFrom[top++] = 0;
+    }
+    while (top > 0)
+    {
+        PokemonNode *node = stack[--top];
+        int shared = sharedFrom[top] || atomic_load(&node->refCount) > 1;
+        size_t size = sizeof(PokemonNode);
+        usage->nodes++;
+        if (shared)
+        {
+            usage->sharedNodes++;
+            usage->sharedBytes += size;
+        }
+        else
+        {
+            usage->bytes += size;
+        }
+        if (nodeLeft(node) != NULL)
+        {
+            stack[top] = nodeLeft(node);
+            sharedFrom[top++] = shared;
+        }
+        if (nodeRight(node) != NULL)
+        {
+            stack[top] = nodeRight(node);
+            sharedFrom[top++] = shared;
+        }
+    }
+}
+
+unsigned long long memAllocationCount(MemCategory category)
+{
+    unsigned long long allocs = 0;
+    for (MetricsBlock *block = atomic_load(&metricsBlocks); block != NULL; block = block->next)
+    {
+        allocs += atomic_load_explicit(&block->mem[category].allocs, memory_order_relaxed);
+    }
+    return allocs;
+}
+
+void memoryReport(FILE *out, int topOwners)
+{
+    fprintf(out, "\n=== Memory ===\n");
+    fprintf(out, "%-11s %14s %12s %14s %14s\n", "subsystem", "live bytes", "live blocks", "allocations",
+            "bytes churned");
+    long long totalLive = 0;
+    for (int category = 0; category < MEM_CATEGORY_COUNT; category++)
+    {
+        unsigned long long allocs = 0, frees = 0, allocBytes = 0, freeBytes = 0;
+        for (MetricsBlock *block = atomic_load(&metricsBlocks); block != NULL; block = block->next)
+        {
+            MemCounters *counters = &block->mem[category];
+            allocs += atomic_load_explicit(&counters->allocs, memory_order_relaxed);
+            frees += atomic_load_explicit(&counters->frees, memory_order_relaxed);
+            allocBytes += atomic_load_explicit(&counters->allocBytes, memory_order_relaxed);
+            freeBytes += atomic_load_explicit(&counters->freeBytes, memory_order_relaxed);
+        }
+        long long live = (long long)(allocBytes - freeBytes);
+        totalLive += live;
+        fprintf(out, "%-11s %14lld %12lld %14llu %14llu\n", memCategoryNames[category], live,
+                (long long)(allocs - frees), allocs, allocBytes);
+    }
+    fprintf(out, "%-11s %14lld\n", "total", totalLive);
+
+    // Pin every owner, then measure each one under its read lock
+    epochEnter();
+    const OwnerRingView *view = currentRingView();
+    int count = (view != NULL) ? view->count : 0;
+    OwnerMemory *usage = (OwnerMemory *)memCalloc(MEM_SCRATCH, count ? count : 1, sizeof(OwnerMemory));
+    int pinned = 0;
+    for (int i = 0; usage != NULL && i < count; i++)
+    {
+        if (tryAcquireOwner(view->owners[i]))
+        {
+            usage[pinned++].owner = view->owners[i];
+        }
+    }
+    epochExit();
+    if (usage == NULL)
+    {
+        return;
+    }
+
+    for (int i = 0; i < pinned; i++)
+    {
+        OwnerNode *owner = usage[i].owner;
+        usage[i].bytes = malloc_usable_size(owner) + malloc_usable_size(owner->ownerName);
+        lockOwnerRead(owner);
+        measureOwnerTree(owner->pokedexRoot, &usage[i]);
+        unlockOwner(owner);
+    }
+    qsort(usage, pinned, sizeof(OwnerMemory), compareOwnerMemory);
+
+    fprintf(out, "\nTop %d of %d owners:\n", pinned < topOwners ? pinned : topOwners, pinned);
+    fprintf(out, "%-20s %10s %12s %7s %7s %12s\n", "owner", "own bytes", "shared bytes", "nodes", "shared",
+            "node allocs");
+    for (int i = 0; i < pinned; i++)
+    {
+        if (i < topOwners)
+        {
+            fprintf(out, "%-20.20s %10zu %12zu %7d %7d %12lu\n", usage[i].owner->ownerName, usage[i].bytes,
+                    usage[i].sharedBytes, usage[i].nodes, usage[i].sharedNodes,
+                    atomic_load_explicit(&usage[i].owner->nodeAllocations, memory_order_relaxed));
+        }
+        releaseOwner(usage[i].owner);
+    }
+    fflush(out);
+    memFree(MEM_SCRATCH, usage);
+}
+
+//========================================
+// Sessions: the menu flow as a resumable state machine
+// A Session holds everything the menus need between input lines
+// (which prompt we are at, the chosen owner, half-entered names), so
+// one thread can advance many trainers one input line at a time.
+// Output is appended to the session's buffer; the driver decides where
+// it goes (stdout for the console, a socket for the server).
+//========================================
+
+#define SESSION_CHUNK 65536 // Streamed "print owners" output is produced this much at a time
+
+// Reply to an edit of a Pokedex that another session has merged away meanwhile
+#define SESSION_MERGED_AWAY_TEXT "This Pokedex was merged into another one. No changes made.\n"
+
+static void outBufferReserve(OutBuffer *out, size_t extra)
+{
+    if (out->len + extra <= out->cap)
+    {
+        return;
+    }
+    size_t cap = out->cap ? out->cap : 1024;
+    while (cap < out->len + extra)
+    {
+        cap *= 2;
+    }
+    char *temp = (char *)memRealloc(MEM_SESSIONS, out->data, cap);
+    if (temp == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed for session output.\n");
+        exit(EXIT_FAILURE);
+    }
+    out->data = temp;
+    out->cap = cap;
+}
+
+static void sessionPrintf(Session *session, const char *fmt, ...)
+{
+    if (session->quiet)
+    {
+        return;
+    }
+
+    va_list args;
+    va_start(args, fmt);
+    int needed = vsnprintf(NULL, 0, fmt, args);
+    va_end(args);
+    if (needed <= 0)
+    {
+        return;
+    }
+
+    OutBuffer *out = &session->out;
+    outBufferReserve(out, (size_t)needed + 1);
+    va_start(args, fmt);
+    vsnprintf(out->data + out->len, (size_t)needed + 1, fmt, args);
+    va_end(args);
+    out->len += (size_t)needed;
+}
+
+static void sessionMainMenu(Session *session)
+{
+    session->state = SESSION_MAIN_MENU;
+    sessionPrintf(session, "\n=== Main Menu ===\n"
+                           "1. New Pokedex\n"
+                           "2. Existing Pokedex\n"
+                           "3. Delete a Pokedex\n"
+                           "4. Merge Pokedexes\n"
+                           "5. Sort Owners by Name\n"
+                           "6. Print Owners in a direction X times\n"
+                           "7. Exit\n"
+                           "8. Clone a Pokedex\n"
+                           "Your choice: ");
+}
+
+static void sessionOwnerMenu(Session *session)
+{
+    session->state = SESSION_OWNER_MENU;
+    sessionPrintf(session, "\n-- %s's Pokedex Menu --\n"
+                           "1. Add Pokemon\n"
+                           "2. Display Pokedex\n"
+                           "3. Release Pokemon (by ID)\n"
+                           "4. Pokemon Fight!\n"
+                           "5. Evolve Pokemon\n"
+                           "6. Back to Main\n"
+                           "7. Add Multiple Pokemon\n"
+                           "Your choice: ",
+                  session->owner->ownerName);
+}
+
+// Lists the ring like the menus do; returns how many owners were shown.
+static int sessionListOwners(Session *session)
+{
+    epochEnter();
+    const OwnerRingView *view = currentRingView();
+    int count = (view != NULL) ? view->count : 0;
+    for (int i = 0; i < count; i++)
+    {
+        sessionPrintf(session, "%d. %s\n", i + 1, view->owners[i]->ownerName);
+    }
+    epochExit();
+    return count;
+}
+
+static void sessionDropPending(Session *session)
+{
+    releaseOwner(session->pendingOwner);
+    session->pendingOwner = NULL;
+}
+
+static void sessionEndPrint(Session *session)
+{
+    if (session->printCycle != NULL)
+    {
+        freeOwnerCycle(session->printCycle, MEM_SESSIONS);
+        memFree(MEM_SESSIONS, session->printCycle);
+        session->printCycle = NULL;
+    }
+}
+
+void sessionInit(Session *session)
+{
+    memset(session, 0, sizeof(*session));
+    sessionMainMenu(session);
+}
+
+void sessionFree(Session *session)
+{
+    sessionDropPending(session);
+    releaseOwner(session->owner);
+    session->owner = NULL;
+    sessionEndPrint(session);
+    memFree(MEM_SESSIONS, session->out.data);
+    session->out.data = NULL;
+    session->out.len = session->out.cap = 0;
+}
+
+int sessionStreaming(const Session *session)
+{
+    return session->printCycle != NULL;
+}
+
+/**
+ * Produces up to SESSION_CHUNK bytes of a pending "print owners" request.
+ * The names were copied when the request started, so the lap stays
+ * consistent even if the ring changes while we stream.
+ */
+void sessionPump(Session *session)
+{
+    if (!sessionStreaming(session))
+    {
+        return;
+    }
+
+    const OwnerCycle *cycle = session->printCycle;
+    OutBuffer *out = &session->out;
+    outBufferReserve(out, SESSION_CHUNK);
+    size_t used = formatOwnerCycle(cycle, &session->printDone, session->printTotal, out->data + out->len,
+                                   SESSION_CHUNK);
+    if (used == 0 && session->printDone < session->printTotal)
+    {
+        // A name longer than the whole chunk goes out on its own
+        int step = (int)(session->printDone % cycle->count);
+        size_t lineLength = 24 + 3 + (cycle->offsets[step + 1] - cycle->offsets[step]);
+        outBufferReserve(out, lineLength);
+        used = formatOwnerCycle(cycle, &session->printDone, session->printDone + 1, out->data + out->len,
+                                lineLength);
+    }
+    out->len += used;
+
+    if (session->printDone >= session->printTotal)
+    {
+        sessionEndPrint(session);
+        sessionMainMenu(session);
+    }
+}
+
+static void sessionStartPrint(Session *session, long long total)
+{
+    if (session->quiet)
+    {
+        // Nothing to stream: the listing is all this command produces
+        sessionMainMenu(session);
+        return;
+    }
+
+    epochEnter();
+    const OwnerRingView *view = currentRingView();
+    if (view != NULL && view->count > 0 && total > 0)
+    {
+        session->printCycle = (OwnerCycle *)memAlloc(MEM_SESSIONS, sizeof(OwnerCycle));
+        if (session->printCycle == NULL || !renderOwnerCycle(view, session->printForward, session->printCycle,
+                                                             MEM_SESSIONS))
+        {
+            fprintf(stderr, "Memory allocation failed for session print.\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    epochExit();
+
+    if (session->printCycle == NULL)
+    {
+        sessionMainMenu(session);
+        return;
+    }
+    session->printTotal = total;
+    session->printDone = 0;
+    sessionPump(session);
+}
+
+static void sessionDisplay(Session *session, int choice)
+{
+    if (choice < TRAVERSAL_BFS || choice > TRAVERSAL_ALPHABETICAL)
+    {
+        sessionPrintf(session, "Invalid choice.\n");
+        return;
+    }
+
+    NodeArray nodes;
+    initNodeArray(&nodes, 16);
+    unsigned long long start = metricsStart(METRIC_DISPLAY);
+    lockOwnerRead(session->owner);
+    collectTraversal(session->owner->pokedexRoot, (TraversalOrder)choice, &nodes);
+    for (int i = 0; i < nodes.size; i++)
+    {
+        const PokemonData *data = nodeData(nodes.nodes[i]);
+        sessionPrintf(session, POKEMON_LINE_FORMAT, data->id, data->name, getTypeName(data->TYPE),
+                      data->hp, data->attack, (data->CAN_EVOLVE == CAN_EVOLVE) ? "Yes" : "No");
+    }
+    unlockOwner(session->owner);
+    metricsStop(METRIC_DISPLAY, start, (unsigned long)nodes.size);
+    memFree(MEM_SCRATCH, nodes.nodes);
+}
+
+// Hidden option 9: the server's metrics, as text in this session's reply
+static void sessionDumpMetrics(Session *session)
+{
+    if (session->quiet)
+    {
+        return;
+    }
+
+    char *text = NULL;
+    size_t length = 0;
+    FILE *stream = open_memstream(&text, &length);
+    if (stream == NULL)
+    {
+        return;
+    }
+    metricsDump(stream);
+    memoryReport(stream, 10);
+    fclose(stream);
+    sessionPrintf(session, "%s", text);
+    free(text);
+}
+
+static void sessionMainChoice(Session *session, int choice)
+{
+    switch (choice)
+    {
+    case 1:
+        session->state = SESSION_NEW_NAME;
+        sessionPrintf(session, "Your name: ");
+        return;
+    case 2:
+        if (currentRingSize() == 0)
+        {
+            sessionPrintf(session, "No existing Pokedexes.\n");
+            break;
+        }
+        sessionPrintf(session, "\nExisting Pokedexes:\n");
+        sessionListOwners(session);
+        session->state = SESSION_CHOOSE_OWNER;
+        sessionPrintf(session, "Choose a Pokedex by number: ");
+        return;
+    case 3:
+        if (currentRingSize() == 0)
+        {
+            sessionPrintf(session, "No existing Pokedexes to delete.\n");
+            break;
+        }
+        sessionPrintf(session, "\n=== Delete a Pokedex ===\n");
+        session->pendingCount = sessionListOwners(session);
+        session->state = SESSION_DELETE_CHOICE;
+        sessionPrintf(session, "Choose a Pokedex to delete by number: ");
+        return;
+    case 4:
+        if (currentRingSize() < 2)
+        {
+            sessionPrintf(session, "Not enough owners to merge.\n");
+            break;
+        }
+        session->state = SESSION_MERGE_FIRST;
+        sessionPrintf(session, "\n=== Merge Pokedexes ===\nEnter name of first owner: ");
+        return;
+    case 5:
+    {
+        int result = sortOwnerRing();
+        sessionPrintf(session, result > 0 ? "Owners sorted by name.\n"
+                               : result == 0 ? "0 or 1 owners only => no need to sort.\n"
+                                             : "Memory allocation failed.\n");
+        break;
+    }
+    case 6:
+        if (currentRingSize() == 0)
+        {
+            sessionPrintf(session, "No owners.\n");
+            break;
+        }
+        session->state = SESSION_PRINT_DIRECTION;
+        sessionPrintf(session, "Enter direction (F or B): ");
+        return;
+    case 7:
+        sessionPrintf(session, "Goodbye!\n");
+        session->state = SESSION_CLOSED;
+        return;
+    case 8:
+        if (currentRingSize() == 0)
+        {
+            sessionPrintf(session, "No existing Pokedexes to clone.\n");
+            break;
+        }
+        session->state = SESSION_CLONE_SOURCE;
+        sessionPrintf(session, "Enter name of owner to clone: ");
+        return;
+    case 9:
+        sessionDumpMetrics(session);
+        break;
+    default:
+        sessionPrintf(session, "Invalid.\n");
+    }
+    sessionMainMenu(session);
+}
+
+static void sessionOwnerChoice(Session *session, int choice)
+{
+    OwnerNode *owner = session->owner;
+    switch (choice)
+    {
+    case 1:
+        session->state = SESSION_ADD_ID;
+        sessionPrintf(session, "Enter ID to add: ");
+        return;
+    case 2:
+        if (pokedexIsEmpty(owner))
+        {
+            sessionPrintf(session, "Pokedex is empty.\n");
+            break;
+        }
+        session->state = SESSION_DISPLAY_CHOICE;
+        sessionPrintf(session, "Display:\n1. BFS (Level-Order)\n2. Pre-Order\n3. In-Order\n"
+                               "4. Post-Order\n5. Alphabetical (by name)\nYour choice: ");
+        return;
+    case 3:
+        if (pokedexIsEmpty(owner))
+        {
+            sessionPrintf(session, "No Pokemon to release.\n");
+            break;
+        }
+        session->state = SESSION_RELEASE_ID;
+        sessionPrintf(session, "Enter Pokemon ID to release: ");
+        return;
+    case 4:
+        if (pokedexIsEmpty(owner))
+        {
+            sessionPrintf(session, "Pokedex is empty.\n");
+            break;
+        }
+        session->state = SESSION_FIGHT_FIRST;
+        sessionPrintf(session, "Enter ID of the first Pokemon: ");
+        return;
+    case 5:
+        if (pokedexIsEmpty(owner))
+        {
+            sessionPrintf(session, "Cannot evolve. Pokedex empty.\n");
+            break;
+        }
+        session->state = SESSION_EVOLVE_ID;
+        sessionPrintf(session, "Enter ID of Pokemon to evolve: ");
+        return;
+    case 6:
+        sessionPrintf(session, "Back to Main Menu.\n");
+        releaseOwner(session->owner);
+        session->owner = NULL;
+        sessionMainMenu(session);
+        return;
+    case 7:
+        session->state = SESSION_BULK_IDS;
+        sessionPrintf(session, "Enter IDs to add (separated by spaces or commas): ");
+        return;
+    default:
+        sessionPrintf(session, "Invalid choice.\n");
+    }
+    sessionOwnerMenu(session);
+}
+
+// Prompt text to repeat after "Invalid input." for states that expect a number
+static const char *sessionNumberPrompt(SessionState state)
+{
+    switch (state)
+    {
+    case SESSION_NEW_STARTER:
+        return "your choice: ";
+    case SESSION_CHOOSE_OWNER:
+        return "Choose a Pokedex by number: ";
+    case SESSION_ADD_ID:
+        return "Enter ID to add: ";
+    case SESSION_RELEASE_ID:
+        return "Enter Pokemon ID to release: ";
+    case SESSION_FIGHT_FIRST:
+        return "Enter ID of the first Pokemon: ";
+    case SESSION_FIGHT_SECOND:
+        return "Enter ID of the second Pokemon: ";
+    case SESSION_EVOLVE_ID:
+        return "Enter ID of Pokemon to evolve: ";
+    case SESSION_DELETE_CHOICE:
+        return "Choose a Pokedex to delete by number: ";
+    case SESSION_PRINT_COUNT:
+        return "How many prints? ";
+    default:
+        return "Your choice: ";
+    }
+}
+
+// States whose number is a species ID, so a species name works too
+static int sessionTakesSpecies(SessionState state)
+{
+    return state == SESSION_ADD_ID || state == SESSION_RELEASE_ID || state == SESSION_EVOLVE_ID ||
+           state == SESSION_FIGHT_FIRST || state == SESSION_FIGHT_SECOND;
+}
+
+static int sessionExpectsNumber(SessionState state)
+{
+    switch (state)
+    {
+    case SESSION_NEW_NAME:
+    case SESSION_MERGE_FIRST:
+    case SESSION_MERGE_SECOND:
+    case SESSION_PRINT_DIRECTION:
+    case SESSION_CLONE_SOURCE:
+    case SESSION_CLONE_NAME:
+    case SESSION_BULK_IDS:
+    case SESSION_CLOSED:
+        return 0;
+    default:
+        return 1;
+    }
+}
+
+/**
+ * Advances the session by one input line (without its '\n').
+ * The line is only read, so it may point into a read-only mapping.
+ */
+void sessionHandleLine(Session *session, const char *line, size_t length)
+{
+    int number = 0;
+    // Trim spaces/tabs/\r by moving the ends, not the bytes
+    while (length > 0 && (*line == ' ' || *line == '\t' || *line == '\r'))
+    {
+        line++;
+        length--;
+    }
+    while (length > 0 && (line[length - 1] == ' ' || line[length - 1] == '\t' || line[length - 1] == '\r'))
+    {
+        length--;
+    }
+    int nameLength = (int)length; // For "%.*s"
+
+    if (sessionExpectsNumber(session->state) && !parseIntSlice(line, length, &number) &&
+        !(sessionTakesSpecies(session->state) && (number = speciesIdBySlice(line, length)) != 0))
+    {
+        sessionPrintf(session, "Invalid input.\n%s", sessionNumberPrompt(session->state));
+        return;
+    }
+
+    switch (session->state)
+    {
+    case SESSION_MAIN_MENU:
+        sessionMainChoice(session, number);
+        return;
+
+    case SESSION_NEW_NAME:
+        if (findOwnerBySlice(line, length) != NULL)
+        {
+            sessionPrintf(session, "Owner '%.*s' already exists. Not creating a new Pokedex.\n", nameLength, line);
+            sessionMainMenu(session);
+            return;
+        }
+        // The owner keeps its own copy of the name; the line is gone after this call
+        session->pendingOwner = createOwnerFromSlice(line, length, NULL);
+        if (session->pendingOwner == NULL)
+        {
+            sessionMainMenu(session);
+            return;
+        }
+        session->state = SESSION_NEW_STARTER;
+        sessionPrintf(session, "\nCOOSE YOUR STARTER:\n1. Bulbasaur\n2. Charmander\n3. Squirtle\nyour choice: ");
+        return;
+
+    case SESSION_NEW_STARTER:
+    {
+        int starterId = (number == 1) ? 1 : (number == 2) ? 4 : (number == 3) ? 7 : 0;
+        if (starterId == 0)
+        {
+            sessionPrintf(session, "Invalid choice.\n");
+        }
+        else
+        {
+            OwnerNode *newOwner = session->pendingOwner;
+            newOwner->pokedexRoot = createPokemonNode(&pokedex[starterId - 1]);
+            if (linkOwnerIfNameFree(newOwner))
+            {
+                sessionPrintf(session, "New Pokedex created for %s with starter %s.\n\n",
+                              newOwner->ownerName, pokedex[starterId - 1].name);
+                // The ring now holds the creator's reference
+                session->pendingOwner = NULL;
+            }
+            else
+            {
+                sessionPrintf(session, "Owner '%s' already exists. Not creating a new Pokedex.\n",
+                              newOwner->ownerName);
+            }
+        }
+        sessionDropPending(session);
+        sessionMainMenu(session);
+        return;
+    }
+
+    case SESSION_CHOOSE_OWNER:
+    {
+        session->owner = acquireOwnerByNumber(number, 1);
+        if (session->owner == NULL)
+        {
+            sessionPrintf(session, "No existing Pokedexes.\n");
+            sessionMainMenu(session);
+            return;
+        }
+        sessionPrintf(session, "\nEntering %s's Pokedex...\n", session->owner->ownerName);
+        sessionOwnerMenu(session);
+        return;
+    }
+
+    case SESSION_OWNER_MENU:
+        sessionOwnerChoice(session, number);
+        return;
+
+    case SESSION_ADD_ID:
+        switch (pokedexAddPokemon(session->owner, number))
+        {
+        case POKEDEX_OK:
+            sessionPrintf(session, "Pokemon %s (ID %d) added.\n", pokedex[number - 1].name, number);
+            break;
+        case POKEDEX_INVALID_ID:
+            sessionPrintf(session, "Invalid Pokémon ID. Please enter a valid ID.\n");
+            break;
+        case POKEDEX_DUPLICATE:
+            sessionPrintf(session, "Pokemon with ID %d is already in the Pokedex. No changes made.\n", number);
+            break;
+        case POKEDEX_MERGED_AWAY:
+            sessionPrintf(session, SESSION_MERGED_AWAY_TEXT);
+            break;
+        default:
+            sessionPrintf(session, "Memory allocation failed for PokemonNode.\n");
+        }
+        break;
+
+    case SESSION_DISPLAY_CHOICE:
+        sessionDisplay(session, number);
+        break;
+
+    case SESSION_RELEASE_ID:
+        switch (pokedexReleasePokemon(session->owner, number))
+        {
+        case POKEDEX_OK:
+            sessionPrintf(session, "Removing Pokemon %s (ID %d).\n", pokedex[number - 1].name, number);
+            break;
+        case POKEDEX_MERGED_AWAY:
+            sessionPrintf(session, SESSION_MERGED_AWAY_TEXT);
+            break;
+        default:
+            sessionPrintf(session, "Pokemon with ID %d not found in the Pokedex.\n", number);
+        }
+        break;
+
+    case SESSION_FIGHT_FIRST:
+        session->pendingId = number;
+        session->state = SESSION_FIGHT_SECOND;
+        sessionPrintf(session, "Enter ID of the second Pokemon: ");
+        return;
+
+    case SESSION_FIGHT_SECOND:
+    {
+        int id1 = session->pendingId, id2 = number;
+        double score1, score2;
+        if (pokedexFight(session->owner, id1, id2, &score1, &score2) != POKEDEX_OK)
+        {
+            sessionPrintf(session, "One or both Pokemon IDs not found.\n");
+            break;
+        }
+        sessionPrintf(session, "Pokemon 1: %s (Score = %.2f)\n", pokedex[id1 - 1].name, score1);
+        sessionPrintf(session, "Pokemon 2: %s (Score = %.2f)\n", pokedex[id2 - 1].name, score2);
+        if (score1 > score2)
+            sessionPrintf(session, "%s wins!\n", pokedex[id1 - 1].name);
+        else if (score1 < score2)
+            sessionPrintf(session, "%s wins!\n", pokedex[id2 - 1].name);
+        else
+            sessionPrintf(session, "It's a tie!\n");
+        break;
+    }
+
+    case SESSION_EVOLVE_ID:
+    {
+        int oldID = number, newID = number + 1;
+        switch (pokedexEvolvePokemon(session->owner, oldID))
+        {
+        case POKEDEX_NOT_FOUND:
+            sessionPrintf(session, "No Pokemon with ID %d found.\n", oldID);
+            break;
+        case POKEDEX_CANNOT_EVOLVE:
+            sessionPrintf(session, "%s (ID %d) cannot evolve.\n", pokedex[oldID - 1].name, oldID);
+            break;
+        case POKEDEX_EVOLUTION_OWNED:
+            sessionPrintf(session, "Evolution ID %d (%s) already in the Pokedex. Releasing %s (ID %d).\n",
+                          newID, pokedex[newID - 1].name, pokedex[oldID - 1].name, oldID);
+            break;
+        case POKEDEX_OK:
+            sessionPrintf(session, "Pokemon evolved from %s (ID %d) to %s (ID %d).\n",
+                          pokedex[oldID - 1].name, oldID, pokedex[newID - 1].name, newID);
+            break;
+        case POKEDEX_MERGED_AWAY:
+            sessionPrintf(session, SESSION_MERGED_AWAY_TEXT);
+            break;
+        default:
+            sessionPrintf(session, "Memory allocation failed for PokemonNode.\n");
+        }
+        break;
+    }
+
+    case SESSION_BULK_IDS:
+    {
+        int ids[POKEDEX_SIZE];
+        int given;
+        int count = collectDistinctIds(line, line + length, ids, &given);
+        int added = addPokemonBulk(session->owner, ids, count);
+        if (added == -POKEDEX_MERGED_AWAY)
+        {
+            sessionPrintf(session, SESSION_MERGED_AWAY_TEXT);
+            break;
+        }
+        if (added < 0)
+        {
+            sessionPrintf(session, "Memory allocation failed for PokemonNode. No changes made.\n");
+            break;
+        }
+        sessionPrintf(session, "%d new Pokemon added (%d IDs given).\n", added, given);
+        break;
+    }
+
+    case SESSION_DELETE_CHOICE:
+    {
+        OwnerNode *victim = NULL;
+        if (number >= 1 && number <= session->pendingCount)
+        {
+            victim = acquireOwnerByNumber(number, 0);
+        }
+        if (victim == NULL)
+        {
+            sessionPrintf(session, "Invalid choice.\n");
+        }
+        else
+        {
+            sessionPrintf(session, "Deleting %s's entire Pokedex...\n", victim->ownerName);
+            deleteOwnerFromList(victim);
+            releaseOwner(victim);
+            sessionPrintf(session, "Pokedex deleted.\n");
+        }
+        sessionMainMenu(session);
+        return;
+    }
+
+    case SESSION_MERGE_FIRST:
+        // Looked up now, like the menu does; may be NULL until the second name is in
+        session->pendingOwner = acquireOwnerBySlice(line, length);
+        session->state = SESSION_MERGE_SECOND;
+        sessionPrintf(session, "Enter name of second owner: ");
+        return;
+
+    case SESSION_MERGE_SECOND:
+    {
+        OwnerNode *firstOwner = session->pendingOwner;
+        OwnerNode *secondOwner = acquireOwnerBySlice(line, length);
+        session->pendingOwner = NULL;
+        if (firstOwner == NULL || secondOwner == NULL)
+        {
+            sessionPrintf(session, "One or both owners not found.\n");
+        }
+        else
+        {
+            sessionPrintf(session, "Merging %s and %s...\n", firstOwner->ownerName, secondOwner->ownerName);
+            switch (mergeOwners(firstOwner, secondOwner))
+            {
+            case POKEDEX_OK:
+                sessionPrintf(session, "Merge completed.\nOwner '%.*s' has been removed after merging.\n",
+                              nameLength, line);
+                break;
+            case POKEDEX_SAME_OWNER:
+                sessionPrintf(session, "Cannot merge an owner with itself.\n");
+                break;
+            case POKEDEX_MERGED_AWAY:
+                sessionPrintf(session, "One of these owners was just merged into another one. No changes made.\n");
+                break;
+            default:
+                sessionPrintf(session, "Memory allocation failed.\n");
+            }
+        }
+        releaseOwner(firstOwner);
+        releaseOwner(secondOwner);
+        sessionDropPending(session);
+        sessionMainMenu(session);
+        return;
+    }
+
+    case SESSION_PRINT_DIRECTION:
+    {
+        char direction = (length > 0) ? line[0] : '\0';
+        if (direction == 'f' || direction == 'F' || direction == 'b' || direction == 'B')
+        {
+            session->printForward = (direction == 'f' || direction == 'F');
+            session->state = SESSION_PRINT_COUNT;
+            sessionPrintf(session, "How many prints? ");
+        }
+        else
+        {
+            sessionPrintf(session, "Invalid direction, must be F or B.\nEnter direction (F or B): ");
+        }
+        return;
+    }
+
+    case SESSION_PRINT_COUNT:
+        sessionStartPrint(session, number);
+        return;
+
+    case SESSION_CLONE_SOURCE:
+        session->pendingOwner = acquireOwnerBySlice(line, length);
+        if (session->pendingOwner == NULL)
+        {
+            sessionPrintf(session, "Owner not found.\n");
+            sessionMainMenu(session);
+            return;
+        }
+        session->state = SESSION_CLONE_NAME;
+        sessionPrintf(session, "Enter name for the new owner: ");
+        return;
+
+    case SESSION_CLONE_NAME:
+        if (clonePokedex(session->pendingOwner, line, length) != NULL)
+        {
+            sessionPrintf(session, "Pokedex of %s cloned into %.*s.\n", session->pendingOwner->ownerName,
+                          nameLength, line);
+        }
+        else
+        {
+            sessionPrintf(session, "Owner '%.*s' already exists. Not creating a new Pokedex.\n", nameLength, line);
+        }
+        sessionDropPending(session);
+        sessionMainMenu(session);
+        return;
+
+    case SESSION_CLOSED:
+        return;
+    }
+
+    // Every Pokedex action ends back at the owner's sub-menu
+    sessionOwnerMenu(session);
+}
+
+//========================================
+// Multi-Session Server
+// One thread, one epoll set, a non-blocking Unix socket per trainer.
+// Lines are fed to each connection's Session; output is written back as
+// the socket accepts it. Long "print owners" replies are generated in
+// chunks only when the previous chunk has been sent. While a reply is
+// backed up, the connection is not read at all: a pipelining client
+// waits in its own socket buffer, not in ours.
+//========================================
+
+#define SERVER_MAX_EVENTS 256
+#define SERVER_READ_CHUNK 16384
+#define SERVER_MAX_LINE (1 << 20)     // A partial line longer than this closes the connection
+#define SERVER_OUTPUT_HIGH (1 << 18)  // Stop reading requests while this much is queued
+
+typedef struct ServerConnection
+{
+    int fd;
+    Session session;
+    char *in;
+    size_t inLen;
+    size_t inCap;
+    unsigned int events;           // Events currently registered with epoll
+    struct ServerConnection *prev; // All live connections, for shutdown
+    struct ServerConnection *next;
+} ServerConnection;
+
+static volatile sig_atomic_t serverStopRequested = 0;
+
+static void serverHandleSignal(int sig)
+{
+    (void)sig;
+    serverStopRequested = 1;
+}
+
+static void serverCloseConnection(int epollFd, ServerConnection **list, ServerConnection *conn)
+{
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, conn->fd, NULL);
+    close(conn->fd);
+    if (conn->prev != NULL)
+        conn->prev->next = conn->next;
+    else
+        *list = conn->next;
+    if (conn->next != NULL)
+        conn->next->prev = conn->prev;
+    sessionFree(&conn->session);
+    memFree(MEM_SESSIONS, conn->in);
+    memFree(MEM_SESSIONS, conn);
+}
+
+// Whether the session may take another request now
+static int serverTakesInput(const ServerConnection *conn)
+{
+    const Session *session = &conn->session;
+    return session->state != SESSION_CLOSED && !sessionStreaming(session) && session->out.len < SERVER_OUTPUT_HIGH;
+}
+
+// Feeds every complete buffered line to the session, as long as it may take more.
+static void serverProcessInput(ServerConnection *conn, LatencyHistogram *latency)
+{
+    size_t start = 0;
+    while (serverTakesInput(conn))
+    {
+        char *newline = memchr(conn->in + start, '\n', conn->inLen - start);
+        if (newline == NULL)
+        {
+            break;
+        }
+        unsigned long long began = monotonicNanos();
+        sessionHandleLine(&conn->session, conn->in + start, (size_t)(newline - (conn->in + start)));
+        latencyRecord(latency, monotonicNanos() - began);
+        start = (size_t)(newline - conn->in) + 1;
+    }
+    if (start > 0)
+    {
+        memmove(conn->in, conn->in + start, conn->inLen - start);
+        conn->inLen -= start;
+    }
+}
+
+// Writes as much queued output as the socket takes. Returns 0 if the peer is gone.
+static int serverFlush(ServerConnection *conn)
+{
+    OutBuffer *out = &conn->session.out;
+    while (1)
+    {
+        while (out->sent < out->len)
+        {
+            ssize_t written = write(conn->fd, out->data + out->sent, out->len - out->sent);
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                return (errno == EAGAIN || errno == EWOULDBLOCK);
+            }
+            out->sent += (size_t)written;
+        }
+        out->len = out->sent = 0;
+
+        if (!sessionStreaming(&conn->session))
+        {
+            return 1;
+        }
+        sessionPump(&conn->session);
+    }
+}
+
+// Readable only while the session takes requests; writable while output is queued
+static int serverUpdateInterest(int epollFd, ServerConnection *conn)
+{
+    unsigned int events = (serverTakesInput(conn) ? EPOLLIN | EPOLLRDHUP : 0) |
+                          (conn->session.out.sent < conn->session.out.len ? EPOLLOUT : 0);
+    if (events == conn->events)
+    {
+        return 0;
+    }
+    struct epoll_event ev;
+    ev.events = events;
+    ev.data.ptr = conn;
+    conn->events = events;
+    return epoll_ctl(epollFd, EPOLL_CTL_MOD, conn->fd, &ev);
+}
+
+/**
+ * Reads and answers requests for as long as the session takes them.
+ * Returns 0 on EOF/error, or when an unfinished line grows past
+ * SERVER_MAX_LINE.
+ */
+static int serverReadAvailable(ServerConnection *conn, LatencyHistogram *latency)
+{
+    while (serverTakesInput(conn))
+    {
+        if (conn->inCap - conn->inLen < SERVER_READ_CHUNK)
+        {
+            size_t cap = conn->inCap ? conn->inCap * 2 : SERVER_READ_CHUNK * 2;
+            char *temp = (char *)memRealloc(MEM_SESSIONS, conn->in, cap);
+            if (temp == NULL)
+            {
+                return 0;
+            }
+            conn->in = temp;
+            conn->inCap = cap;
+        }
+        ssize_t got = read(conn->fd, conn->in + conn->inLen, conn->inCap - conn->inLen);
+        if (got > 0)
+        {
+            conn->inLen += (size_t)got;
+            serverProcessInput(conn, latency);
+            // Still taking input, so what is left is one unfinished line
+            if (serverTakesInput(conn) && conn->inLen > SERVER_MAX_LINE)
+            {
+                return 0;
+            }
+            continue;
+        }
+        if (got == 0)
+        {
+            return 0;
+        }
+        if (errno == EINTR)
+        {
+            continue;
+        }
+        return (errno == EAGAIN || errno == EWOULDBLOCK);
+    }
+    return 1;
+}
+
+int runServer(const char *socketPath)
+{
+    struct sockaddr_un addr;
+    if (strlen(socketPath) >= sizeof(addr.sun_path))
+    {
+        fprintf(stderr, "Socket path too long: %s\n", socketPath);
+        return 1;
+    }
+
+    int listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd < 0)
+    {
+        perror("socket");
+        return 1;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, socketPath);
+    unlink(socketPath);
+    if (bind(listenFd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(listenFd, SOMAXCONN) < 0)
+    {
+        perror("bind/listen");
+        close(listenFd);
+        return 1;
+    }
+
+    int epollFd = epoll_create1(EPOLL_CLOEXEC);
+    struct epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.ptr = NULL; // NULL marks the listening socket
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &ev);
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = serverHandleSignal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    ServerConnection *connections = NULL;
+    LatencyHistogram latency;
+    memset(&latency, 0, sizeof(latency));
+    long accepted = 0, live = 0, peak = 0;
+    struct epoll_event events[SERVER_MAX_EVENTS];
+
+    fprintf(stderr, "Serving Pokedex sessions on %s (Ctrl-C to stop)\n", socketPath);
+    while (!serverStopRequested)
+    {
+        int ready = epoll_wait(epollFd, events, SERVER_MAX_EVENTS, -1);
+        if (ready < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            perror("epoll_wait");
+            break;
+        }
+
+        for (int i = 0; i < ready; i++)
+        {
+            ServerConnection *conn = (ServerConnection *)events[i].data.ptr;
+            if (conn == NULL)
+            {
+                // New trainers: accept everything pending
+                int fd;
+                while ((fd = accept4(listenFd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0)
+                {
+                    ServerConnection *fresh = (ServerConnection *)memCalloc(MEM_SESSIONS, 1, sizeof(ServerConnection));
+                    if (fresh == NULL)
+                    {
+                        close(fd);
+                        continue;
+                    }
+                    fresh->fd = fd;
+                    sessionInit(&fresh->session);
+                    fresh->next = connections;
+                    if (connections != NULL)
+                        connections->prev = fresh;
+                    connections = fresh;
+                    accepted++;
+                    if (++live > peak)
+                        peak = live;
+
+                    struct epoll_event cev;
+                    cev.events = fresh->events = EPOLLIN | EPOLLRDHUP;
+                    cev.data.ptr = fresh;
+                    epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &cev);
+                    if (!serverFlush(fresh) || serverUpdateInterest(epollFd, fresh) < 0)
+                    {
+                        serverCloseConnection(epollFd, &connections, fresh);
+                        live--;
+                    }
+                }
+                continue;
+            }
+
+            int alive = 1;
+            if (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))
+            {
+                // Lines that arrived with the hang-up still get answered
+                alive = serverReadAvailable(conn, &latency);
+            }
+            if (!serverFlush(conn))
+            {
+                alive = 0;
+            }
+            // Output drained: requests held back by back-pressure can run now.
+            // Repeat while that makes progress; no event would wake them later.
+            while (alive)
+            {
+                size_t buffered = conn->inLen;
+                serverProcessInput(conn, &latency);
+                alive = serverFlush(conn);
+                if (conn->inLen == buffered)
+                {
+                    break;
+                }
+            }
+            if (conn->session.state == SESSION_CLOSED && conn->session.out.sent == conn->session.out.len)
+            {
+                alive = 0;
+            }
+            if (!alive || serverUpdateInterest(epollFd, conn) < 0)
+            {
+                serverCloseConnection(epollFd, &connections, conn);
+                live--;
+            }
+        }
+    }
+
+    while (connections != NULL)
+    {
+        serverCloseConnection(epollFd, &connections, connections);
+    }
+    close(epollFd);
+    close(listenFd);
+    unlink(socketPath);
+
+    fprintf(stderr, "Sessions: %ld accepted, %ld peak concurrent\n", accepted, peak);
+    fprintf(stderr, "Requests: %llu, mean %.1f us, p50 <= %.1f us, p99 <= %.1f us, p999 <= %.1f us, max %.1f us\n",
+            latency.total, latency.total ? latency.sumNanos / 1000.0 / latency.total : 0.0,
+            latencyPercentile(&latency, 50) / 1000.0, latencyPercentile(&latency, 99) / 1000.0,
+            latencyPercentile(&latency, 99.9) / 1000.0, latency.maxNanos / 1000.0);
+    return 0;
+}
+
+//========================================
+// Trace Replay
+// A command file is mapped read-only and walked line by line; each line
+// goes to one quiet Session as a slice of the mapping. Nothing is copied
+// except names that become owners, and no reply text is formatted.
+//========================================
+
+int replayCommandFile(const char *path)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        fprintf(stderr, "replay: cannot open %s: %s\n", path, strerror(errno));
+        return 1;
+    }
+    struct stat info;
+    if (fstat(fd, &info) < 0)
+    {
+        fprintf(stderr, "replay: cannot stat %s: %s\n", path, strerror(errno));
+        close(fd);
+        return 1;
+    }
+    size_t size = (size_t)info.st_size;
+    const char *data = NULL;
+    if (size > 0)
+    {
+        void *mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED)
+        {
+            fprintf(stderr, "replay: cannot map %s: %s\n", path, strerror(errno));
+            close(fd);
+            return 1;
+        }
+        // One forward pass: read ahead aggressively, drop pages behind us
+        madvise(mapping, size, MADV_SEQUENTIAL);
+        data = (const char *)mapping;
+    }
+    close(fd);
+
+    Session session;
+    sessionInit(&session);
+    session.quiet = 1;
+
+    unsigned long long began = monotonicNanos();
+    unsigned long long lines = 0;
+    const char *cursor = data;
+    const char *end = data + size;
+    while (cursor < end && session.state != SESSION_CLOSED)
+    {
+        const char *newline = memchr(cursor, '\n', (size_t)(end - cursor));
+        const char *lineEnd = (newline != NULL) ? newline : end;
+        sessionHandleLine(&session, cursor, (size_t)(lineEnd - cursor));
+        lines++;
+        cursor = (newline != NULL) ? newline + 1 : end;
+    }
+    double seconds = (double)(monotonicNanos() - began) / 1e9;
+    size_t consumed = (size_t)(cursor - data);
+
+    sessionFree(&session);
+    if (size > 0)
+    {
+        munmap((void *)data, size);
+    }
+
+    double megabytes = (double)consumed / (1024.0 * 1024.0);
+    fprintf(stderr, "replay: %llu lines, %.1f MB in %.3f s (%.0f lines/s, %.1f MB/s)\n", lines, megabytes,
+            seconds, seconds > 0 ? (double)lines / seconds : 0.0, seconds > 0 ? megabytes / seconds : 0.0);
+    return 0;
+}
+
+//========================================
+// Console
+// The interactive game is one Session fed from stdin by a LineReader,
+// with its replies written to stdout. Running out of input ends it like
+// "Exit" (minus the goodbye), so main's cleanup runs either way.
+//========================================
+
+void runConsoleSession(void)
+{
+    LineReader reader;
+    lineReaderInit(&reader, STDIN_FILENO);
+    Session session;
+    sessionInit(&session);
+    while (1)
+    {
+        fwrite(session.out.data, 1, session.out.len, stdout);
+        session.out.len = 0;
+        if (sessionStreaming(&session))
+        {
+            sessionPump(&session);
+            continue;
+        }
+        if (session.state == SESSION_CLOSED)
+        {
+            break;
+        }
+        // lineReaderNext flushes stdout before it blocks, so the prompt shows
+        size_t length;
+        const char *line = lineReaderNext(&reader, &length);
+        if (line == NULL)
+        {
+            break;
+        }
+        sessionHandleLine(&session, line, length);
+    }
+    fflush(stdout);
+    sessionFree(&session);
+    lineReaderFree(&reader);
+}
@@ -1,618 +1,1472 @@
-#ifndef pokemon_H
-#define pokemon_H
-
-#include <ctype.h>
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-
-
-typedef enum
-{
-    GRASS,
-    FIRE,
-    WATER,
-    BUG,
-    NORMAL,
-    POISON,
-    ELECTRIC,
-    GROUND,
-    FAIRY,
-    FIGHTING,
-    PSYCHIC,
-    ROCK,
-    GHOST,
-    DRAGON,
-    ICE
-} PokemonType;
-
-typedef enum
-{
-    CANNOT_EVOLVE,
-    CAN_EVOLVE
-} EvolutionStatus;
-
-typedef struct PokemonData
-{
-    int id;
-    char *name;
-    PokemonType TYPE;
-    int hp;
-    int attack;
-    EvolutionStatus CAN_EVOLVE;
-} PokemonData;
-
-// Binary Tree Node (for Pokédex)
-typedef struct PokemonNode
-{
-    PokemonData *data;
-    struct PokemonNode *left;
-    struct PokemonNode *right;
-} PokemonNode;
-
-// Linked List Node (for Owners)
-typedef struct OwnerNode
-{
-    char *ownerName;          // Owner's name
-    PokemonNode *pokedexRoot; // Pointer to the root of the owner's Pokédex
-    struct OwnerNode *next;   // Next owner in the linked list
-    struct OwnerNode *prev;   // Previous owner in the linked list
-} OwnerNode;
-
-// Global head pointer for the linked list of owners
-OwnerNode *ownerHead = NULL;
-
-/* ------------------------------------------------------------
-   1) Safe Input + Utility
-   ------------------------------------------------------------ */
-
-/**
- * @brief Remove leading/trailing whitespace (including '\r').
- * @param str modifiable string
- * Why we made it: We must handle CR/LF or random spaces in user input.
- */
-void trimWhitespace(char *str);
-
-/**
- * @brief C99-friendly strdup replacement.
- * @param src source string
- * @return newly allocated copy of src
- * Why we made it: Some old systems lack strdup; we do it ourselves.
- */
-char *myStrdup(const char *src);
-
-/**
- * @brief Read an integer safely, re-prompt if invalid.
- * @param prompt text to display
- * @return valid integer from user
- * Why we made it: We want robust menu/ID input handling.
- */
-int readIntSafe(const char *prompt);
-
-/**
- * @brief Read a line from stdin, store in malloc'd buffer, trim whitespace.
- * @return pointer to the newly allocated string (caller frees)
- * Why we made it: We need flexible name input that handles CR/LF etc.
- */
-char *getDynamicInput(void);
-
-/**
- * @brief Return a string for a given PokemonType enum.
- * @param type the enum
- * @return string like "GRASS", "FIRE", etc.
- * Why we made it: So we can print readable type names.
- */
-const char *getTypeName(PokemonType type);
-
-/* ------------------------------------------------------------
-   2) Creating & Freeing Nodes
-   ------------------------------------------------------------ */
-
-/**
- * @brief Create a BST node with a copy of the given PokemonData.
- * @param data pointer to PokemonData (like from the global pokedex)
- * @return newly allocated PokemonNode*
- * Why we made it: We need a standard way to allocate BST nodes.
- */
-PokemonNode *createPokemonNode(const PokemonData *data);
-
-/**
- * @brief Create an OwnerNode for the circular owners list.
- * @param ownerName the dynamically allocated name
- * @param starter BST root for the starter Pokemon
- * @return newly allocated OwnerNode*
- * Why we made it: Each user is represented as an OwnerNode.
- */
-OwnerNode *createOwner(char *ownerName, PokemonNode *starter);
-
-/**
- * @brief Free one PokemonNode (including name).
- * @param node pointer to node
- * Why we made it: Avoid memory leaks for single nodes.
- */
-void freePokemonNode(PokemonNode *node);
-
-/**
- * @brief Recursively free a BST of PokemonNodes.
- * @param root BST root
- * Why we made it: Clearing a user’s entire Pokedex means freeing a tree.
- */
-void freePokemonTree(PokemonNode *root);
-
-/**
- * @brief Free an OwnerNode (including name and entire Pokedex BST).
- * @param owner pointer to the owner
- * Why we made it: Deleting an owner also frees their Pokedex & name.
- */
-void freeOwnerNode(OwnerNode *owner);
-
-/* ------------------------------------------------------------
-   3) BST Insert, Search, Remove
-   ------------------------------------------------------------ */
-// Comparator for sorting Pokémon by their names
-/**
- * @brief Insert a PokemonNode into BST by ID; duplicates freed.
- * @param root pointer to BST root
- * @param newNode node to insert
- * @return updated BST root
- * Why we made it: Standard BST insertion ignoring duplicates.
- */
-PokemonNode *insertPokemonNode(PokemonNode *root, PokemonNode *newNode);
-
-/**
- * @brief BFS search for a Pokemon by ID in the BST.
- * @param root BST root
- * @param id ID to find
- * @return pointer to found node or NULL
- * Why we made it: BFS ensures we find nodes even in an unbalanced tree.
- */
-
-
-/**
- * @brief Remove node from BST by ID if found (BST removal logic).
- * @param root BST root
- * @param id ID to remove
- * @return updated BST root
- * Why we made it: We handle special cases of a BST remove (0,1,2 children).
- */
-PokemonNode *removeNodeBST(PokemonNode *root, int id);
-
-void deleteOwnerFromList(OwnerNode* target);
-/**
- * @brief Combine BFS search + BST removal to remove Pokemon by ID.
- * @param root BST root
- * @param id the ID to remove
- * @return updated BST root
- * Why we made it: BFS confirms existence, then removeNodeBST does the removal.
- */
-PokemonNode *removePokemonByID(PokemonNode *root, int id);
-
-/* ------------------------------------------------------------
-   4) Generic BST Traversals (Function Pointers)
-   ------------------------------------------------------------ */
-
-// Please notice, it's not really generic, it's just a demonstration of function pointers.
-// so don't be confused by the name, but please remember that you must use it.
-
-typedef void (*VisitNodeFunc)(PokemonNode *);
-
-/**
- * @brief Generic BFS traversal: call visit() on each node (level-order).
- * @param root BST root
- * @param visit function pointer for what to do with each node
- * Why we made it: BFS plus function pointers => flexible traversal.
- */
-void BFSGeneric(PokemonNode *root, VisitNodeFunc visit);
-
-/**
- * @brief A generic pre-order traversal (Root-Left-Right).
- * @param root BST root
- * @param visit function pointer
- * Why we made it: Another demonstration of function-pointer-based traversal.
- */
-void preOrderGeneric(PokemonNode *root, VisitNodeFunc visit);
-
-/**
- * @brief A generic in-order traversal (Left-Root-Right).
- * @param root BST root
- * @param visit function pointer
- * Why we made it: Great for seeing sorted order if BST is sorted by ID.
- */
-void inOrderGeneric(PokemonNode *root, VisitNodeFunc visit);
-
-/**
- * @brief A generic post-order traversal (Left-Right-Root).
- * @param root BST root
- * @param visit function pointer
- * Why we made it: Another standard traversal pattern.
- */
-void postOrderGeneric(PokemonNode *root, VisitNodeFunc visit);
-
-/**
- * @brief Print one PokemonNode’s data: ID, Name, Type, HP, Attack, Evolve?
- * @param node pointer to the node
- * Why we made it: We can pass this to BFSGeneric or others to quickly print.
- */
-void printPokemonNode(PokemonNode *node);
-
-/* ------------------------------------------------------------
-   5) Display Methods (BFS, Pre, In, Post, Alphabetical)
-   ------------------------------------------------------------ */
-
-typedef struct
-{
-    PokemonNode **nodes;
-    int size;
-    int capacity;
-} NodeArray;
-
-/**
- * @brief Initialize a NodeArray with given capacity.
- * @param na pointer to NodeArray
- * @param cap initial capacity
- * Why we made it: We store pointers to PokemonNodes for alphabetical sorting.
- */
-void initNodeArray(NodeArray *na, int cap);
-
-/**
- * @brief Add a PokemonNode pointer to NodeArray, realloc if needed.
- * @param na pointer to NodeArray
- * @param node pointer to the node
- * Why we made it: We want a dynamic list of BST nodes for sorting.
- */
-void addNode(NodeArray *na, PokemonNode *node);
-
-/**
- * @brief Recursively collect all nodes from the BST into a NodeArray.
- * @param root BST root
- * @param na pointer to NodeArray
- * Why we made it: We gather everything for qsort.
- */
-void collectAll(PokemonNode *root, NodeArray *na);
-
-/**
- * @brief Compare function for qsort (alphabetical by node->data->name).
- * @param a pointer to a pointer to PokemonNode
- * @param b pointer to a pointer to PokemonNode
- * @return -1, 0, or +1
- * Why we made it: Sorting by name for alphabetical display.
- */
-int compareByNameNode(const void *a, const void *b);
-
-/**
- * @brief BFS is nice, but alphabetical means we gather all nodes, sort by name, then print.
- * @param root BST root
- * Why we made it: Provide user the option to see Pokemon sorted by name.
- */
-void displayAlphabetical(PokemonNode *root);
-
-/**
- * @brief BFS user-friendly display (level-order).
- * @param root BST root
- * Why we made it: Quick listing in BFS order.
- */
-void displayBFS(PokemonNode *root);
-
-/**
- * @brief Pre-order user-friendly display (Root->Left->Right).
- * @param root BST root
- * Why we made it: Another standard traversal for demonstration.
- */
-void preOrderTraversal(PokemonNode *root);
-
-/**
- * @brief In-order user-friendly display (Left->Root->Right).
- * @param root BST root
- * Why we made it: Good for sorted output by ID if the tree is a BST.
- */
-void inOrderTraversal(PokemonNode *root);
-
-/**
- * @brief Post-order user-friendly display (Left->Right->Root).
- * @param root BST root
- * Why we made it: Another standard traversal pattern.
- */
-void postOrderTraversal(PokemonNode *root);
-
-/* ------------------------------------------------------------
-   6) Pokemon-Specific
-   ------------------------------------------------------------ */
-PokemonNode* deletePokemonNode(PokemonNode* root, int id);
-PokemonNode* findMin(PokemonNode* node);
-/**
- * @brief Let user pick two Pokemon by ID in the same Pokedex to fight.
- * @param owner pointer to the Owner
- * Why we made it: Fun demonstration of BFS and custom formula for battles.
- */
-void pokemonFight(OwnerNode *owner);
-
-/**
- * @brief Evolve a Pokemon (ID -> ID+1) if allowed.
- * @param owner pointer to the Owner
- * Why we made it: Demonstrates removing an old ID, inserting the next ID.
- */
-void evolvePokemon(OwnerNode *owner);
-
-/**
- * @brief Prompt for an ID, BFS-check duplicates, then insert into BST.
- * @param owner pointer to the Owner
- * Why we made it: Primary user function for adding new Pokemon to an owner’s Pokedex.
- */
-void addPokemon(OwnerNode *owner);
-
-/**
- * @brief Prompt for ID, remove that Pokemon from BST by ID.
- * @param owner pointer to the Owner
- * Why we made it: Another user function for releasing a Pokemon.
- */
-void freePokemon(OwnerNode *owner);
-
-/* ------------------------------------------------------------
-   7) Display Menu for a Pokedex
-   ------------------------------------------------------------ */
-
-/**
- * @brief Show sub-menu to let user pick BFS, Pre, In, Post, or alphabetical.
- * @param owner pointer to Owner
- * Why we made it: We want a simple menu that picks from various traversals.
- */
-void displayMenu(OwnerNode *owner);
-
-/* ------------------------------------------------------------
-   8) Sorting Owners (Bubble Sort on Circular List)
-   ------------------------------------------------------------ */
-
-/**
- * @brief Sort the circular owners list by name.
- * Why we made it: Another demonstration of pointer manipulation + sorting logic.
- */
-void sortOwners(void);
-
-/**
- * @brief Helper to swap name & pokedexRoot in two OwnerNode.
- * @param a pointer to first owner
- * @param b pointer to second owner
- * Why we made it: Used internally by bubble sort to swap data.
- */
-void swapOwnerData(OwnerNode *a, OwnerNode *b);
-
-/* ------------------------------------------------------------
-   9) Circular List Linking & Searching
-   ------------------------------------------------------------ */
-
-/**
- * @brief Insert a new owner into the circular list. If none exist, it's alone.
- * @param newOwner pointer to newly created OwnerNode
- * Why we made it: We need a standard approach to keep the list circular.
- */
-void linkOwnerInCircularList(OwnerNode *newOwner);
-
-/**
- * @brief Remove a specific OwnerNode from the circular list, possibly updating head.
- * @param target pointer to the OwnerNode
- * Why we made it: Deleting or merging owners requires removing them from the ring.
- */
-void removeOwnerFromCircularList(OwnerNode *target);
-
-/**
- * @brief Find an owner by name in the circular list.
- * @param name string to match
- * @return pointer to the matching OwnerNode or NULL
- * Why we made it: We often need to locate an owner quickly.
- */
-OwnerNode *findOwnerByName(const char *name);
-
-/* ------------------------------------------------------------
-   10) Owner Menus
-   ------------------------------------------------------------ */
-
-/**
- * @brief Let user pick an existing Pokedex (owner) by number, then sub-menu.
- * Why we made it: This is the main interface for adding/fighting/evolving, etc.
- */
-void enterExistingPokedexMenu(void);
-
-/**
- * @brief Creates a new Pokedex (prompt for name, check uniqueness, choose starter).
- * Why we made it: The main entry for building a brand-new Pokedex.
- */
-void openPokedexMenu(void);
-
-/**
- * @brief Delete an entire Pokedex (owner) from the list.
- * Why we made it: Let user pick which Pokedex to remove and free everything.
- */
-void deletePokedex(void);
-
-/**
- * @brief Merge the second owner's Pokedex into the first, then remove the second owner.
- * Why we made it: BFS copy demonstration plus removing an owner.
- */
-void mergePokedexMenu(void);
-
-/* ------------------------------------------------------------
-   11) Printing Owners in a Circle
-   ------------------------------------------------------------ */
-
-/**
- * @brief Print owners left or right from head, repeating as many times as user wants.
- * Why we made it: Demonstrates stepping through a circular list in a chosen direction.
- */
-void printOwnersCircular(void);
-
-/* ------------------------------------------------------------
-   12) Cleanup All Owners at Program End
-   ------------------------------------------------------------ */
-
-/**
- * @brief Frees every remaining owner in the circular list, setting ownerHead = NULL.
- * Why we made it: Ensures a squeaky-clean exit with no leftover memory.
- */
-void freeAllOwners(void);
-
-/* ------------------------------------------------------------
-   13) The Main Menu
-   ------------------------------------------------------------ */
-
-/**
- * @brief The main driver loop for the program (new pokedex, merge, fight, etc.).
- * Why we made it: Our top-level UI that keeps the user engaged until they exit.
- */
-void mainMenu(void);
-
-// Array of Pokemon data
-static const PokemonData pokedex[] = {
-    {1, "Bulbasaur", GRASS, 45, 49, CAN_EVOLVE},
-    {2, "Ivysaur", GRASS, 60, 62, CAN_EVOLVE},
-    {3, "Venusaur", GRASS, 80, 82, CANNOT_EVOLVE},
-    {4, "Charmander", FIRE, 39, 52, CAN_EVOLVE},
-    {5, "Charmeleon", FIRE, 58, 64, CAN_EVOLVE},
-    {6, "Charizard", FIRE, 78, 84, CANNOT_EVOLVE},
-    {7, "Squirtle", WATER, 44, 48, CAN_EVOLVE},
-    {8, "Wartortle", WATER, 59, 63, CAN_EVOLVE},
-    {9, "Blastoise", WATER, 79, 83, CANNOT_EVOLVE},
-    {10, "Caterpie", BUG, 45, 30, CAN_EVOLVE},
-    {11, "Metapod", BUG, 50, 20, CAN_EVOLVE},
-    {12, "Butterfree", BUG, 60, 45, CANNOT_EVOLVE},
-    {13, "Weedle", BUG, 40, 35, CAN_EVOLVE},
-    {14, "Kakuna", BUG, 45, 25, CAN_EVOLVE},
-    {15, "Beedrill", BUG, 65, 90, CANNOT_EVOLVE},
-    {16, "Pidgey", NORMAL, 40, 45, CAN_EVOLVE},
-    {17, "Pidgeotto", NORMAL, 63, 60, CAN_EVOLVE},
-    {18, "Pidgeot", NORMAL, 83, 80, CANNOT_EVOLVE},
-    {19, "Rattata", NORMAL, 30, 56, CAN_EVOLVE},
-    {20, "Raticate", NORMAL, 55, 81, CANNOT_EVOLVE},
-    {21, "Spearow", NORMAL, 40, 60, CAN_EVOLVE},
-    {22, "Fearow", NORMAL, 65, 90, CANNOT_EVOLVE},
-    {23, "Ekans", POISON, 35, 60, CAN_EVOLVE},
-    {24, "Arbok", POISON, 60, 85, CANNOT_EVOLVE},
-    {25, "Pikachu", ELECTRIC, 35, 55, CAN_EVOLVE},
-    {26, "Raichu", ELECTRIC, 60, 90, CANNOT_EVOLVE},
-    {27, "Sandshrew", GROUND, 50, 75, CAN_EVOLVE},
-    {28, "Sandslash", GROUND, 75, 100, CANNOT_EVOLVE},
-    {29, "NidoranF", POISON, 55, 47, CAN_EVOLVE},
-    {30, "Nidorina", POISON, 70, 62, CAN_EVOLVE},
-    {31, "Nidoqueen", POISON, 90, 92, CANNOT_EVOLVE},
-    {32, "NidoranM", POISON, 46, 57, CAN_EVOLVE},
-    {33, "Nidorino", POISON, 61, 72, CAN_EVOLVE},
-    {34, "Nidoking", POISON, 81, 102, CANNOT_EVOLVE},
-    {35, "Clefairy", FAIRY, 70, 45, CAN_EVOLVE},
-    {36, "Clefable", FAIRY, 95, 70, CANNOT_EVOLVE},
-    {37, "Vulpix", FIRE, 38, 41, CAN_EVOLVE},
-    {38, "Ninetales", FIRE, 73, 76, CANNOT_EVOLVE},
-    {39, "Jigglypuff", NORMAL, 115, 45, CAN_EVOLVE},
-    {40, "Wigglytuff", NORMAL, 140, 70, CANNOT_EVOLVE},
-    {41, "Zubat", POISON, 40, 45, CAN_EVOLVE},
-    {42, "Golbat", POISON, 75, 80, CAN_EVOLVE},
-    {43, "Oddish", GRASS, 45, 50, CAN_EVOLVE},
-    {44, "Gloom", GRASS, 60, 65, CAN_EVOLVE},
-    {45, "Vileplume", GRASS, 75, 80, CANNOT_EVOLVE},
-    {46, "Paras", BUG, 35, 70, CAN_EVOLVE},
-    {47, "Parasect", BUG, 60, 95, CANNOT_EVOLVE},
-    {48, "Venonat", BUG, 60, 55, CAN_EVOLVE},
-    {49, "Venomoth", BUG, 70, 65, CANNOT_EVOLVE},
-    {50, "Diglett", GROUND, 10, 55, CAN_EVOLVE},
-    {51, "Dugtrio", GROUND, 35, 80, CANNOT_EVOLVE},
-    {52, "Meowth", NORMAL, 40, 45, CAN_EVOLVE},
-    {53, "Persian", NORMAL, 65, 70, CANNOT_EVOLVE},
-    {54, "Psyduck", WATER, 50, 52, CAN_EVOLVE},
-    {55, "Golduck", WATER, 80, 82, CANNOT_EVOLVE},
-    {56, "Mankey", FIGHTING, 40, 80, CAN_EVOLVE},
-    {57, "Primeape", FIGHTING, 65, 105, CANNOT_EVOLVE},
-    {58, "Growlithe", FIRE, 55, 70, CAN_EVOLVE},
-    {59, "Arcanine", FIRE, 90, 110, CANNOT_EVOLVE},
-    {60, "Poliwag", WATER, 40, 50, CAN_EVOLVE},
-    {61, "Poliwhirl", WATER, 65, 65, CAN_EVOLVE},
-    {62, "Poliwrath", WATER, 90, 95, CANNOT_EVOLVE},
-    {63, "Abra", PSYCHIC, 25, 20, CAN_EVOLVE},
-    {64, "Kadabra", PSYCHIC, 40, 35, CAN_EVOLVE},
-    {65, "Alakazam", PSYCHIC, 55, 50, CANNOT_EVOLVE},
-    {66, "Machop", FIGHTING, 70, 80, CAN_EVOLVE},
-    {67, "Machoke", FIGHTING, 80, 100, CAN_EVOLVE},
-    {68, "Machamp", FIGHTING, 90, 130, CANNOT_EVOLVE},
-    {69, "Bellsprout", GRASS, 50, 75, CAN_EVOLVE},
-    {70, "Weepinbell", GRASS, 65, 90, CAN_EVOLVE},
-    {71, "Victreebel", GRASS, 80, 105, CANNOT_EVOLVE},
-    {72, "Tentacool", WATER, 40, 40, CAN_EVOLVE},
-    {73, "Tentacruel", WATER, 80, 70, CANNOT_EVOLVE},
-    {74, "Geodude", ROCK, 40, 80, CAN_EVOLVE},
-    {75, "Graveler", ROCK, 55, 95, CAN_EVOLVE},
-    {76, "Golem", ROCK, 80, 120, CANNOT_EVOLVE},
-    {77, "Ponyta", FIRE, 50, 85, CAN_EVOLVE},
-    {78, "Rapidash", FIRE, 65, 100, CANNOT_EVOLVE},
-    {79, "Slowpoke", WATER, 90, 65, CAN_EVOLVE},
-    {80, "Slowbro", WATER, 95, 75, CANNOT_EVOLVE},
-    {81, "Magnemite", ELECTRIC, 25, 35, CAN_EVOLVE},
-    {82, "Magneton", ELECTRIC, 50, 60, CANNOT_EVOLVE},
-    {83, "Farfetch'd", NORMAL, 52, 65, CANNOT_EVOLVE},
-    {84, "Doduo", NORMAL, 35, 85, CAN_EVOLVE},
-    {85, "Dodrio", NORMAL, 60, 110, CANNOT_EVOLVE},
-    {86, "Seel", WATER, 65, 45, CAN_EVOLVE},
-    {87, "Dewgong", WATER, 90, 70, CANNOT_EVOLVE},
-    {88, "Grimer", POISON, 80, 80, CAN_EVOLVE},
-    {89, "Muk", POISON, 105, 105, CANNOT_EVOLVE},
-    {90, "Shellder", WATER, 30, 65, CAN_EVOLVE},
-    {91, "Cloyster", WATER, 50, 95, CANNOT_EVOLVE},
-    {92, "Gastly", GHOST, 30, 35, CAN_EVOLVE},
-    {93, "Haunter", GHOST, 45, 50, CAN_EVOLVE},
-    {94, "Gengar", GHOST, 60, 65, CANNOT_EVOLVE},
-    {95, "Onix", ROCK, 35, 45, CANNOT_EVOLVE},
-    {96, "Drowzee", PSYCHIC, 60, 48, CAN_EVOLVE},
-    {97, "Hypno", PSYCHIC, 85, 73, CANNOT_EVOLVE},
-    {98, "Krabby", WATER, 30, 105, CAN_EVOLVE},
-    {99, "Kingler", WATER, 55, 130, CANNOT_EVOLVE},
-    {100, "Voltorb", ELECTRIC, 40, 30, CAN_EVOLVE},
-    {101, "Electrode", ELECTRIC, 60, 50, CANNOT_EVOLVE},
-    {102, "Exeggcute", GRASS, 60, 40, CAN_EVOLVE},
-    {103, "Exeggutor", GRASS, 95, 95, CANNOT_EVOLVE},
-    {104, "Cubone", GROUND, 50, 50, CAN_EVOLVE},
-    {105, "Marowak", GROUND, 60, 80, CANNOT_EVOLVE},
-    {106, "Hitmonlee", FIGHTING, 50, 120, CANNOT_EVOLVE},
-    {107, "Hitmonchan", FIGHTING, 50, 105, CANNOT_EVOLVE},
-    {108, "Lickitung", NORMAL, 90, 55, CANNOT_EVOLVE},
-    {109, "Koffing", POISON, 40, 65, CAN_EVOLVE},
-    {110, "Weezing", POISON, 65, 90, CANNOT_EVOLVE},
-    {111, "Rhyhorn", GROUND, 80, 85, CAN_EVOLVE},
-    {112, "Rhydon", GROUND, 105, 130, CANNOT_EVOLVE},
-    {113, "Chansey", NORMAL, 250, 5, CANNOT_EVOLVE},
-    {114, "Tangela", GRASS, 65, 55, CANNOT_EVOLVE},
-    {115, "Kangaskhan", NORMAL, 105, 95, CANNOT_EVOLVE},
-    {116, "Horsea", WATER, 30, 40, CAN_EVOLVE},
-    {117, "Seadra", WATER, 55, 65, CANNOT_EVOLVE},
-    {118, "Goldeen", WATER, 45, 67, CAN_EVOLVE},
-    {119, "Seaking", WATER, 80, 92, CANNOT_EVOLVE},
-    {120, "Staryu", WATER, 30, 45, CAN_EVOLVE},
-    {121, "Starmie", WATER, 60, 75, CANNOT_EVOLVE},
-    {122, "Mr. Mime", PSYCHIC, 40, 45, CANNOT_EVOLVE},
-    {123, "Scyther", BUG, 70, 110, CANNOT_EVOLVE},
-    {124, "Jynx", ICE, 65, 50, CANNOT_EVOLVE},
-    {125, "Electabuzz", ELECTRIC, 65, 83, CANNOT_EVOLVE},
-    {126, "Magmar", FIRE, 65, 95, CANNOT_EVOLVE},
-    {127, "Pinsir", BUG, 65, 125, CANNOT_EVOLVE},
-    {128, "Tauros", NORMAL, 75, 100, CANNOT_EVOLVE},
-    {129, "Magikarp", WATER, 20, 10, CAN_EVOLVE},
-    {130, "Gyarados", WATER, 95, 125, CANNOT_EVOLVE},
-    {131, "Lapras", WATER, 130, 85, CANNOT_EVOLVE},
-    {132, "Ditto", NORMAL, 48, 48, CANNOT_EVOLVE},
-    {133, "Eevee", NORMAL, 55, 55, CAN_EVOLVE},
-    {134, "Vaporeon", WATER, 130, 65, CANNOT_EVOLVE},
-    {135, "Jolteon", ELECTRIC, 65, 65, CANNOT_EVOLVE},
-    {136, "Flareon", FIRE, 65, 130, CANNOT_EVOLVE},
-    {137, "Porygon", NORMAL, 65, 60, CANNOT_EVOLVE},
-    {138, "Omanyte", ROCK, 35, 40, CAN_EVOLVE},
-    {139, "Omastar", ROCK, 70, 60, CANNOT_EVOLVE},
-    {140, "Kabuto", ROCK, 30, 80, CAN_EVOLVE},
-    {141, "Kabutops", ROCK, 60, 115, CANNOT_EVOLVE},
-    {142, "Aerodactyl", ROCK, 80, 105, CANNOT_EVOLVE},
-    {143, "Snorlax", NORMAL, 160, 110, CANNOT_EVOLVE},
-    {144, "Articuno", ICE, 90, 85, CANNOT_EVOLVE},
-    {145, "Zapdos", ELECTRIC, 90, 90, CANNOT_EVOLVE},
-    {146, "Moltres", FIRE, 90, 100, CANNOT_EVOLVE},
-    {147, "Dratini", DRAGON, 41, 64, CAN_EVOLVE},
-    {148, "Dragonair", DRAGON, 61, 84, CAN_EVOLVE},
-    {149, "Dragonite", DRAGON, 91, 134, CANNOT_EVOLVE},
-    {150, "Mewtwo", PSYCHIC, 106, 110, CANNOT_EVOLVE},
-    {151, "Mew", PSYCHIC, 100, 100, CANNOT_EVOLVE}};
-
-#endif // pokemon_H
-
+#ifndef pokemon_H
+#define pokemon_H
+
+// Expose POSIX rwlocks even when built with a strict -std=c11
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <ctype.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Number of species in the static pokedex[] table (IDs run 1..POKEDEX_SIZE)
+#define POKEDEX_SIZE 151
+
+typedef enum
+{
+    GRASS,
+    FIRE,
+    WATER,
+    BUG,
+    NORMAL,
+    POISON,
+    ELECTRIC,
+    GROUND,
+    FAIRY,
+    FIGHTING,
+    PSYCHIC,
+    ROCK,
+    GHOST,
+    DRAGON,
+    ICE,
+    POKEMON_TYPE_COUNT
+} PokemonType;
+
+typedef enum
+{
+    CANNOT_EVOLVE,
+    CAN_EVOLVE
+} EvolutionStatus;
+
+typedef struct PokemonData
+{
+    int id;
+    char *name;
+    PokemonType TYPE;
+    int hp;
+    int attack;
+    EvolutionStatus CAN_EVOLVE;
+} PokemonData;
+
+// Binary Tree Node (for Pokédex)
+// Nodes are reference counted so trees can be shared (copy-on-write) between
+// owners, clones and snapshots. refCount is the number of parents/roots
+// pointing at the node; only a node with refCount == 1 may be modified in place.
+// 16 bytes: nodes live in one global pool and children are 32-bit pool
+// indices (0 = no child), the species is its pokedex ID. Use the
+// pokemonNodeData/Left/Right accessors to read them.
+typedef struct PokemonNode
+{
+    atomic_int refCount;
+    uint32_t left;
+    uint32_t right;
+    uint8_t speciesId; // 1..POKEDEX_SIZE
+} PokemonNode;
+
+// Linked List Node (for Owners)
+typedef struct OwnerNode
+{
+    char *ownerName;          // Owner's name
+    PokemonNode *pokedexRoot; // Pointer to the root of the owner's Pokédex
+    struct OwnerNode *next;   // Next owner in the linked list (NULL once unlinked)
+    struct OwnerNode *prev;   // Previous owner in the linked list
+    pthread_rwlock_t dexLock; // Guards pokedexRoot: shared for reads, exclusive for edits
+    atomic_int refCount;      // The ring's link + every acquireOwner() pin; freed at 0
+    atomic_ulong nodeAllocations; // Tree nodes allocated while this owner was write-locked
+    _Atomic(struct FrozenDex *) frozenDex; // Read-only sorted copy of the tree; dropped by every write lock
+    atomic_uint treeReads;    // Lookups that walked the tree since the last write lock
+    int *speciesSlots;        // Position in each species' owner list (-1: not owned); NULL while unlinked
+    int bitsRow;              // Row in the collection bitset table; -1 while unlinked
+    long strength;            // Sum of pokemonScore over its species, in tenths of a point
+    struct LeaderboardNode *boardEntry; // Place on the strength leaderboard; NULL while unlinked
+    int mergedAway;           // Set under dexLock when merged into another owner; edits are refused after
+} OwnerNode;
+
+// Global head pointer for the linked list of owners (defined in pokemon.c)
+extern OwnerNode *ownerHead;
+
+// Serializes ring writers (ownerHead, next/prev); taken before any dexLock.
+// Readers don't lock: they walk the published OwnerRingView inside an epoch.
+extern pthread_mutex_t ownerRingLock;
+
+// Immutable ring-order array of owners (owners[0] is ownerHead) for lock-free readers
+typedef struct
+{
+    int count;
+    OwnerNode *owners[];
+} OwnerRingView;
+
+/* ------------------------------------------------------------
+   1) Safe Input + Utility
+   ------------------------------------------------------------ */
+
+/**
+ * @brief Remove leading/trailing whitespace (including '\r').
+ * @param str modifiable string
+ * Why we made it: We must handle CR/LF or random spaces in user input.
+ */
+void trimWhitespace(char *str);
+
+/**
+ * @brief C99-friendly strdup replacement.
+ * @param src source string
+ * @return newly allocated copy of src
+ * Why we made it: Some old systems lack strdup; we do it ourselves.
+ */
+char *myStrdup(const char *src);
+
+/**
+ * @brief Parse a whole line as a single integer.
+ * @param line NUL-terminated line (trailing CR/LF allowed)
+ * @param value receives the number
+ * @return 1 if the line is exactly one integer, else 0
+ * Why we made it: Same rule for the stdin menus and for network sessions.
+ */
+int parseIntLine(const char *line, int *value);
+
+/**
+ * @brief Parse a slice as a single integer without copying it.
+ * @param text start of the digits (need not be NUL-terminated)
+ * @param length bytes in the slice (a trailing CR/LF is ignored)
+ * @param value receives the number
+ * @return 1 if the slice is exactly one int, else 0
+ * Why we made it: strtol needs a terminated copy and checks locale; menus only need digits.
+ */
+int parseIntSlice(const char *text, size_t length, int *value);
+
+// Chunked reader that returns lines as slices of its own buffer
+typedef struct
+{
+    int fd;
+    char *buffer;
+    size_t capacity;
+    size_t head;    // Start of the first unread line
+    size_t tail;    // End of the bytes read so far
+    size_t scanned; // Bytes before this hold no '\n' (avoids rescanning)
+    int eof;
+} LineReader;
+
+/**
+ * @brief Start reading lines from a file descriptor (buffer comes on first read).
+ * @param reader reader to set up
+ * @param fd descriptor to read from
+ * Why we made it: One read(2) per 64 KB instead of one getchar() per byte.
+ */
+void lineReaderInit(LineReader *reader, int fd);
+
+/**
+ * @brief Next line, NUL-terminated in place, without its '\n' or '\r'.
+ * @param reader the reader
+ * @param length receives the line length (may be NULL)
+ * @return the line, valid until the next call; NULL at end of input
+ * Why we made it: Multi-megabyte command streams with no allocation per line.
+ */
+char *lineReaderNext(LineReader *reader, size_t *length);
+
+/**
+ * @brief Release the reader's buffer.
+ * @param reader the reader
+ * Why we made it: Readers for files/sockets are closed before exit.
+ */
+void lineReaderFree(LineReader *reader);
+
+/**
+ * @brief Return a string for a given PokemonType enum.
+ * @param type the enum
+ * @return string like "GRASS", "FIRE", etc.
+ * Why we made it: So we can print readable type names.
+ */
+const char *getTypeName(PokemonType type);
+
+/* ------------------------------------------------------------
+   2) Creating & Freeing Nodes
+   ------------------------------------------------------------ */
+
+/**
+ * @brief Create a BST node holding the given species.
+ * @param data entry of the global pokedex (only its id is kept)
+ * @return newly allocated PokemonNode* (from the node pool), or NULL if the pool is exhausted
+ * Why we made it: We need a standard way to allocate BST nodes.
+ */
+PokemonNode *createPokemonNode(const PokemonData *data);
+
+/**
+ * @brief Create an OwnerNode for the circular owners list.
+ * @param ownerName the dynamically allocated name
+ * @param starter BST root for the starter Pokemon
+ * @return newly allocated OwnerNode*
+ * Why we made it: Each user is represented as an OwnerNode.
+ */
+OwnerNode *createOwner(char *ownerName, PokemonNode *starter);
+
+/**
+ * @brief Create an OwnerNode named by a length-delimited slice.
+ * @param name first byte of the name (need not be NUL-terminated)
+ * @param length name length in bytes
+ * @param starter BST root for the starter Pokemon
+ * @return newly allocated OwnerNode*
+ * Why we made it: Replayed traces name owners straight out of the mapped file.
+ */
+OwnerNode *createOwnerFromSlice(const char *name, size_t length, PokemonNode *starter);
+
+/**
+ * @brief Free one PokemonNode (its slot goes back to the node pool).
+ * @param node pointer to node
+ * Why we made it: Avoid memory leaks for single nodes.
+ */
+void freePokemonNode(PokemonNode *node);
+
+/**
+ * @brief The species a node holds: its entry in the static pokedex[].
+ * @param node non-NULL node
+ * @return pointer into pokedex[]
+ * Why we made it: Nodes store a one-byte species ID, not a PokemonData pointer.
+ */
+const PokemonData *pokemonNodeData(const PokemonNode *node);
+
+/**
+ * @brief Left / right child of a node.
+ * @param node non-NULL node
+ * @return the child, or NULL if there is none
+ * Why we made it: Children are stored as 32-bit node pool indices.
+ */
+PokemonNode *pokemonNodeLeft(const PokemonNode *node);
+PokemonNode *pokemonNodeRight(const PokemonNode *node);
+
+/**
+ * @brief Drop one reference to a BST; free the nodes no other tree shares.
+ * @param root BST root
+ * Why we made it: Clearing a user’s entire Pokedex means freeing a tree.
+ */
+void freePokemonTree(PokemonNode *root);
+
+/**
+ * @brief Free an OwnerNode (including name and entire Pokedex BST).
+ * @param owner pointer to the owner
+ * Why we made it: Deleting an owner also frees their Pokedex & name.
+ */
+void freeOwnerNode(OwnerNode *owner);
+
+/* ------------------------------------------------------------
+   3) BST Insert, Search, Remove
+   ------------------------------------------------------------ */
+// Comparator for sorting Pokémon by their names
+/**
+ * @brief Insert a PokemonNode into BST by ID; duplicates freed.
+ * @param root pointer to BST root
+ * @param newNode node to insert
+ * @return updated BST root
+ * Why we made it: Standard BST insertion ignoring duplicates.
+ */
+PokemonNode *insertPokemonNode(PokemonNode *root, PokemonNode *newNode);
+
+/**
+ * @brief BFS search for a Pokemon by ID in the BST.
+ * @param root BST root
+ * @param id ID to find
+ * @return pointer to found node or NULL
+ * Why we made it: BFS ensures we find nodes even in an unbalanced tree.
+ */
+PokemonNode *searchPokemonBFS(PokemonNode *root, int id);
+
+/**
+ * @brief Plain BST search for a Pokemon by ID (walks one root-to-leaf path).
+ * @param root BST root
+ * @param id ID to find
+ * @return pointer to found node or NULL
+ * Why we made it: Mutations check for the ID first so a shared tree is never copied for nothing.
+ */
+PokemonNode *findPokemonBST(PokemonNode *root, int id);
+
+
+/**
+ * @brief Remove node from BST by ID if found (BST removal logic).
+ * @param root BST root
+ * @param id ID to remove
+ * @return updated BST root
+ * Why we made it: We handle special cases of a BST remove (0,1,2 children).
+ */
+PokemonNode *removeNodeBST(PokemonNode *root, int id);
+
+/**
+ * @brief Unlink an owner from the ring and drop the ring's reference.
+ * @param target pointer to the OwnerNode
+ * Why we made it: Deleting or merging owners; the node is freed by the last releaseOwner.
+ */
+void deleteOwnerFromList(OwnerNode* target);
+/**
+ * @brief Combine BFS search + BST removal to remove Pokemon by ID.
+ * @param root BST root
+ * @param id the ID to remove
+ * @return updated BST root
+ * Why we made it: BFS confirms existence, then removeNodeBST does the removal.
+ */
+PokemonNode *removePokemonByID(PokemonNode *root, int id);
+
+/* ------------------------------------------------------------
+   4) Generic BST Traversals (Function Pointers)
+   ------------------------------------------------------------ */
+
+// Please notice, it's not really generic, it's just a demonstration of function pointers.
+// so don't be confused by the name, but please remember that you must use it.
+
+typedef void (*VisitNodeFunc)(PokemonNode *);
+
+/**
+ * @brief Generic BFS traversal: call visit() on each node (level-order).
+ * @param root BST root
+ * @param visit function pointer for what to do with each node
+ * Why we made it: BFS plus function pointers => flexible traversal.
+ */
+void BFSGeneric(PokemonNode *root, VisitNodeFunc visit);
+
+/**
+ * @brief A generic pre-order traversal (Root-Left-Right).
+ * @param root BST root
+ * @param visit function pointer
+ * Why we made it: Another demonstration of function-pointer-based traversal.
+ */
+void preOrderGeneric(PokemonNode *root, VisitNodeFunc visit);
+
+/**
+ * @brief A generic in-order traversal (Left-Root-Right).
+ * @param root BST root
+ * @param visit function pointer
+ * Why we made it: Great for seeing sorted order if BST is sorted by ID.
+ */
+void inOrderGeneric(PokemonNode *root, VisitNodeFunc visit);
+
+/**
+ * @brief A generic post-order traversal (Left-Right-Root).
+ * @param root BST root
+ * @param visit function pointer
+ * Why we made it: Another standard traversal pattern.
+ */
+void postOrderGeneric(PokemonNode *root, VisitNodeFunc visit);
+
+// One line of Pokemon details; shared by stdout printing and session output
+#define POKEMON_LINE_FORMAT "ID: %d, Name: %s, Type: %s, HP: %d, Attack: %d, Can Evolve: %s\n"
+
+/**
+ * @brief Print one PokemonNode’s data: ID, Name, Type, HP, Attack, Evolve?
+ * @param node pointer to the node
+ * Why we made it: We can pass this to BFSGeneric or others to quickly print.
+ */
+void printPokemonNode(PokemonNode *node);
+
+/* ------------------------------------------------------------
+   5) Display Methods (BFS, Pre, In, Post, Alphabetical)
+   ------------------------------------------------------------ */
+
+typedef struct
+{
+    PokemonNode **nodes;
+    int size;
+    int capacity;
+} NodeArray;
+
+/**
+ * @brief Initialize a NodeArray with given capacity.
+ * @param na pointer to NodeArray
+ * @param cap initial capacity
+ * Why we made it: We store pointers to PokemonNodes for alphabetical sorting.
+ */
+void initNodeArray(NodeArray *na, int cap);
+
+/**
+ * @brief Add a PokemonNode pointer to NodeArray, realloc if needed.
+ * @param na pointer to NodeArray
+ * @param node pointer to the node
+ * Why we made it: We want a dynamic list of BST nodes for sorting.
+ */
+void addNode(NodeArray *na, PokemonNode *node);
+
+/**
+ * @brief Recursively collect all nodes from the BST into a NodeArray.
+ * @param root BST root
+ * @param na pointer to NodeArray
+ * Why we made it: We gather everything for qsort.
+ */
+void collectAll(PokemonNode *root, NodeArray *na);
+
+// The five display orders offered by the display menu
+typedef enum
+{
+    TRAVERSAL_BFS = 1,
+    TRAVERSAL_PRE_ORDER,
+    TRAVERSAL_IN_ORDER,
+    TRAVERSAL_POST_ORDER,
+    TRAVERSAL_ALPHABETICAL
+} TraversalOrder;
+
+/**
+ * @brief Append the tree's nodes to a NodeArray in one of the display orders.
+ * @param root BST root
+ * @param order BFS, pre/in/post-order or alphabetical
+ * @param na pointer to an initialized NodeArray
+ * Why we made it: Sessions format nodes into a buffer instead of printing them.
+ */
+void collectTraversal(PokemonNode *root, TraversalOrder order, NodeArray *na);
+
+/**
+ * @brief Compare function for qsort (alphabetical by species name).
+ * @param a pointer to a pointer to PokemonNode
+ * @param b pointer to a pointer to PokemonNode
+ * @return -1, 0, or +1
+ * Why we made it: Sorting by name for alphabetical display.
+ */
+int compareByNameNode(const void *a, const void *b);
+
+/**
+ * @brief BFS is nice, but alphabetical means we gather all nodes, sort by name, then print.
+ * @param root BST root
+ * Why we made it: Provide user the option to see Pokemon sorted by name.
+ */
+void displayAlphabetical(PokemonNode *root);
+
+/**
+ * @brief BFS user-friendly display (level-order).
+ * @param root BST root
+ * Why we made it: Quick listing in BFS order.
+ */
+void displayBFS(PokemonNode *root);
+
+/**
+ * @brief Pre-order user-friendly display (Root->Left->Right).
+ * @param root BST root
+ * Why we made it: Another standard traversal for demonstration.
+ */
+void preOrderTraversal(PokemonNode *root);
+
+/**
+ * @brief In-order user-friendly display (Left->Root->Right).
+ * @param root BST root
+ * Why we made it: Good for sorted output by ID if the tree is a BST.
+ */
+void inOrderTraversal(PokemonNode *root);
+
+/**
+ * @brief Post-order user-friendly display (Left->Right->Root).
+ * @param root BST root
+ * Why we made it: Another standard traversal pattern.
+ */
+void postOrderTraversal(PokemonNode *root);
+
+/* ------------------------------------------------------------
+   6) Pokemon-Specific
+   ------------------------------------------------------------ */
+
+// Result of the thread-safe core operations (menus turn these into messages)
+typedef enum
+{
+    POKEDEX_OK,
+    POKEDEX_INVALID_ID,
+    POKEDEX_DUPLICATE,
+    POKEDEX_NOT_FOUND,
+    POKEDEX_CANNOT_EVOLVE,
+    POKEDEX_EVOLUTION_OWNED,
+    POKEDEX_SAME_OWNER,
+    POKEDEX_NO_MEMORY,
+    POKEDEX_MERGED_AWAY // The owner was merged into another one and is leaving the ring
+} PokedexStatus;
+
+PokemonNode* deletePokemonNode(PokemonNode* root, int id);
+PokemonNode* findMin(PokemonNode* node);
+
+/**
+ * @brief Add many IDs at once: counting-sort + dedupe, then rebuild a balanced BST.
+ * @param owner pointer to the Owner
+ * @param ids array of IDs (invalid or duplicate IDs are skipped)
+ * @param count number of entries in ids
+ * @return how many new Pokemon were actually added, or -POKEDEX_NO_MEMORY (nothing changed
+ *         when a species shared with a clone could not be copied) or -POKEDEX_MERGED_AWAY
+ * Why we made it: Onboarding a trainer with an existing collection one ID at a time is slow
+ *                 and leaves a degenerate tree when the IDs arrive sorted.
+ */
+int addPokemonBulk(OwnerNode *owner, const int *ids, int count);
+
+/**
+ * @brief Build a height-balanced BST from an ID-sorted array of nodes.
+ * @param nodes nodes sorted by ID
+ * @param lo first index (inclusive)
+ * @param hi last index (inclusive)
+ * @return root of the rebuilt subtree
+ * Why we made it: Bulk insert relinks the merged sorted run in O(n) instead of n inserts.
+ */
+PokemonNode *buildBalancedFromSorted(PokemonNode **nodes, int lo, int hi);
+
+/**
+ * @brief Parse a line of IDs separated by spaces/commas into a malloc'd array.
+ * @param line the input line
+ * @param outCount receives the number of parsed IDs
+ * @return array of IDs (caller frees) or NULL on allocation failure
+ * Why we made it: The bulk-add prompt takes a whole list on one line.
+ */
+int *parseIdList(const char *line, int *outCount);
+
+/**
+ * @brief Scan the next ID out of a free-form list ("1, 4 Pikachu,Mr. Mime 25").
+ * Names (any case, longest match first) are resolved with speciesIdBySlice;
+ * an unknown word counts as one invalid ID.
+ * @param cursor position in the list, advanced past the ID
+ * @param end end of the list
+ * @param id receives the ID (0 if negative, above POKEDEX_SIZE or an unknown name)
+ * @return 1 if an ID was found, 0 at the end of the list
+ * Why we made it: The bulk-add menu parses straight from the input buffer.
+ */
+int nextIdInList(const char **cursor, const char *end, int *id);
+
+/* ------------------------------------------------------------
+   6b) Thread-Safe Core Operations
+   Each call locks what it touches and never does I/O.
+   ------------------------------------------------------------ */
+
+/**
+ * @brief Take / drop the owner's Pokedex lock (shared or exclusive).
+ * @param owner pointer to the Owner
+ * Why we made it: Many sessions may read one Pokedex while one edits it.
+ */
+void lockOwnerRead(OwnerNode *owner);
+void lockOwnerWrite(OwnerNode *owner);
+void unlockOwner(OwnerNode *owner);
+
+/**
+ * @brief Check under the read lock whether the owner's Pokedex is empty.
+ * @param owner pointer to the Owner
+ * @return 1 if empty, 0 otherwise
+ * Why we made it: Menus check emptiness before prompting.
+ */
+int pokedexIsEmpty(OwnerNode *owner);
+
+/**
+ * @brief Check under the read lock whether the owner has a species.
+ * After enough lookups with no edit in between, the owner's tree is frozen
+ * into a sorted array in Eytzinger (BFS) order and searched branch-free.
+ * The next write lock throws the frozen copy away.
+ * @param owner pointer to the Owner
+ * @param id species ID
+ * @return 1 if owned, 0 otherwise
+ * Why we made it: Read-mostly Pokedexes shouldn't chase a pointer per tree level.
+ */
+int pokedexHasPokemon(OwnerNode *owner, int id);
+
+/**
+ * @brief How many tree lookups in a row (no edits) freeze an owner's Pokedex.
+ * @param reads threshold; 0 never freezes (and lookups always walk the tree)
+ * Why we made it: Benchmarks compare both layouts; write-heavy setups can opt out.
+ */
+void setFrozenDexThreshold(int reads);
+int getFrozenDexThreshold(void);
+
+/**
+ * @brief Fight score of one Pokemon: attack * 1.5 + hp * 1.2.
+ * @param data species record
+ * @return the score
+ * Why we made it: One place for the battle formula.
+ */
+double pokemonScore(const PokemonData *data);
+
+// How fights are scored
+typedef enum
+{
+    BATTLE_CLASSIC, // pokemonScore alone (the original rule)
+    BATTLE_TYPED,   // pokemonScore times the attacker's type effectiveness
+    BATTLE_MODE_COUNT
+} BattleMode;
+
+/**
+ * @brief Type effectiveness of an attack: 0, 0.5, 1 or 2.
+ * @param attacker attacking type
+ * @param defender defending type
+ * @return the multiplier
+ * Why we made it: Types used to be only a label.
+ */
+double typeMultiplier(PokemonType attacker, PokemonType defender);
+
+/**
+ * @brief Fight score of attacker against defender under a battle mode.
+ * One table lookup and one multiply; no branches.
+ * @param attacker species scoring
+ * @param defender species it faces
+ * @param mode BATTLE_CLASSIC or BATTLE_TYPED
+ * @return the score (BATTLE_CLASSIC: exactly pokemonScore(attacker))
+ * Why we made it: Type-aware battles fast enough to run millions per second.
+ */
+double battleScore(const PokemonData *attacker, const PokemonData *defender, BattleMode mode);
+
+/**
+ * @brief Case-insensitive FNV-1a hash of a species name.
+ * @param name first byte of the name
+ * @param length name length in bytes
+ * @param seed hash seed
+ * @return 64-bit hash
+ * Why we made it: Shared by speciesIdBySlice and the generator of its table.
+ */
+unsigned long long speciesNameHash(const char *name, size_t length, unsigned long long seed);
+
+/**
+ * @brief Species ID for a name, through a perfect hash over pokedex[] (any case).
+ * @param name first byte of the name (need not be NUL-terminated)
+ * @param length name length in bytes
+ * @return the ID, or 0 if no species has that name
+ * Why we made it: One hash and one compare instead of a strcmp scan of all 151 names.
+ */
+int speciesIdBySlice(const char *name, size_t length);
+
+/**
+ * @brief speciesIdBySlice for a NUL-terminated name.
+ * @param name the name
+ * @return the ID, or 0 if unknown
+ * Why we made it: Convenience for callers holding C strings.
+ */
+int speciesIdByName(const char *name);
+
+/**
+ * @brief Choose how pokedexFight scores (process-wide, default BATTLE_CLASSIC).
+ * @param mode the battle mode
+ * Why we made it: The type-aware rule sits beside the original one instead of replacing it.
+ */
+void setBattleMode(BattleMode mode);
+
+/**
+ * @brief The battle mode pokedexFight uses.
+ * @return the current mode
+ * Why we made it: Callers report which rule decided a fight.
+ */
+BattleMode getBattleMode(void);
+
+/**
+ * @brief Add one species to the owner's Pokedex.
+ * @param owner pointer to the Owner
+ * @param id species ID
+ * @return POKEDEX_OK, POKEDEX_INVALID_ID, POKEDEX_DUPLICATE, POKEDEX_NO_MEMORY or POKEDEX_MERGED_AWAY
+ * Why we made it: The menu's "Add Pokemon", safe to call from any thread.
+ */
+PokedexStatus pokedexAddPokemon(OwnerNode *owner, int id);
+
+/**
+ * @brief Release one species from the owner's Pokedex.
+ * @param owner pointer to the Owner
+ * @param id species ID
+ * @return POKEDEX_OK, POKEDEX_NOT_FOUND or POKEDEX_MERGED_AWAY
+ * Why we made it: The menu's "Release Pokemon", safe to call from any thread.
+ */
+PokedexStatus pokedexReleasePokemon(OwnerNode *owner, int id);
+
+/**
+ * @brief Evolve oldId into oldId + 1 (or just release it if the evolution is owned).
+ * @param owner pointer to the Owner
+ * @param oldId species to evolve
+ * The released node is reused for the evolved form, so nothing is allocated
+ * unless the tree is shared with a clone or snapshot.
+ * @return POKEDEX_OK, POKEDEX_NOT_FOUND, POKEDEX_CANNOT_EVOLVE, POKEDEX_EVOLUTION_OWNED or POKEDEX_MERGED_AWAY
+ * Why we made it: The menu's "Evolve Pokemon", safe to call from any thread.
+ */
+PokedexStatus pokedexEvolvePokemon(OwnerNode *owner, int oldId);
+
+/**
+ * @brief Score two Pokemon of the same Pokedex against each other.
+ * @param owner pointer to the Owner
+ * @param id1 first species
+ * @param id2 second species
+ * @param score1 receives the first score
+ * @param score2 receives the second score
+ * @return POKEDEX_OK or POKEDEX_NOT_FOUND
+ * Scores come from battleScore under the current battle mode.
+ * Why we made it: The menu's "Pokemon Fight!" under a read lock only.
+ */
+PokedexStatus pokedexFight(OwnerNode *owner, int id1, int id2, double *score1, double *score2);
+
+/**
+ * @brief Copy source's Pokemon into target, then delete source from the ring.
+ * Source is marked merged away before its lock is dropped, so an edit that
+ * races with the unlink fails with POKEDEX_MERGED_AWAY instead of being lost.
+ * @param target owner that keeps everything
+ * @param source owner that is removed afterwards
+ * @return POKEDEX_OK, POKEDEX_SAME_OWNER, POKEDEX_NO_MEMORY or POKEDEX_MERGED_AWAY (either owner)
+ * Why we made it: Both owners are locked in a fixed (address) order, so
+ *                 concurrent merges cannot deadlock.
+ */
+PokedexStatus mergeOwners(OwnerNode *target, OwnerNode *source);
+
+/* ------------------------------------------------------------
+   8) Sorting Owners (Bubble Sort on Circular List)
+   ------------------------------------------------------------ */
+
+/**
+ * @brief Relink the circular owners list in name order (no printing).
+ * The order is read off the owner name index, so no sort pass runs.
+ * @return 1 if sorted, 0 if fewer than two owners, -1 on allocation failure
+ * Why we made it: Sessions and menus share the sort but print differently.
+ */
+int sortOwnerRing(void);
+
+/**
+ * @brief Owners with from <= name < to (strcmp order), in name order.
+ * The ring order is untouched; this reads the skip-list name index.
+ * @param from lower bound, inclusive (NULL: from the first name)
+ * @param to upper bound, exclusive (NULL: to the last name)
+ * @param owners receives up to limit pinned owners (caller must releaseOwner each)
+ * @param limit how many owners to return at most
+ * @return number of owners stored
+ * Why we made it: "Owners between A and M" without sorting or scanning the ring.
+ */
+int listOwnersInRange(const char *from, const char *to, OwnerNode **owners, int limit);
+
+/**
+ * @brief Helper to swap name & pokedexRoot in two OwnerNode.
+ * @param a pointer to first owner
+ * @param b pointer to second owner
+ * Why we made it: Used internally by bubble sort to swap data.
+ */
+void swapOwnerData(OwnerNode *a, OwnerNode *b);
+
+/* ------------------------------------------------------------
+   9) Circular List Linking & Searching
+   ------------------------------------------------------------ */
+
+/**
+ * @brief Insert a new owner into the circular list. If none exist, it's alone.
+ * @param newOwner pointer to newly created OwnerNode
+ * Why we made it: We need a standard approach to keep the list circular.
+ */
+void linkOwnerInCircularList(OwnerNode *newOwner);
+
+/**
+ * @brief Link newOwner only if no owner with the same name exists (atomic check+link).
+ * @param newOwner pointer to newly created OwnerNode
+ * @return 1 if linked, 0 if the name was taken
+ * Why we made it: Two sessions creating the same name must not both succeed.
+ */
+int linkOwnerIfNameFree(OwnerNode *newOwner);
+
+/**
+ * @brief Remove a specific OwnerNode from the circular list, possibly updating head.
+ * @param target pointer to the OwnerNode
+ * Why we made it: Deleting or merging owners requires removing them from the ring.
+ */
+void removeOwnerFromCircularList(OwnerNode *target);
+
+/**
+ * @brief Find an owner by name in the circular list.
+ * @param name string to match
+ * @return pointer to the matching OwnerNode or NULL
+ * Why we made it: We often need to locate an owner quickly.
+ *                 Not pinned: use acquireOwnerByName when other threads may delete it.
+ */
+OwnerNode *findOwnerByName(const char *name);
+
+/**
+ * @brief Find an owner by name and pin it (caller must releaseOwner).
+ * @param name string to match
+ * @return pinned OwnerNode or NULL
+ * Why we made it: A pinned owner stays valid even if another session deletes it.
+ */
+OwnerNode *acquireOwnerByName(const char *name);
+
+/**
+ * @brief findOwnerByName for a length-delimited name.
+ * @param name first byte of the name (need not be NUL-terminated)
+ * @param length name length in bytes
+ * @return pointer to the matching OwnerNode or NULL
+ * Why we made it: Sessions look names up without copying the input line.
+ */
+OwnerNode *findOwnerBySlice(const char *name, size_t length);
+
+/**
+ * @brief acquireOwnerByName for a length-delimited name.
+ * @param name first byte of the name (need not be NUL-terminated)
+ * @param length name length in bytes
+ * @return pinned OwnerNode or NULL
+ * Why we made it: Sessions look names up without copying the input line.
+ */
+OwnerNode *acquireOwnerBySlice(const char *name, size_t length);
+
+/**
+ * @brief Pin the owner listed as number (1-based, ring order) in the current view.
+ * @param number position as shown in the menus
+ * @param wrap 1: numbers below 1 pick the first owner and numbers past the end
+ *             keep counting around the circle; 0: out of range gives NULL
+ * @return pinned OwnerNode (caller must releaseOwner) or NULL
+ * Why we made it: The menus and sessions pick owners by number; the view makes it O(1).
+ */
+OwnerNode *acquireOwnerByNumber(int number, int wrap);
+
+/**
+ * @brief Pin / unpin an owner; the last unpin retires it (freed after the epoch).
+ * @param owner pointer to the Owner
+ * Why we made it: Owners are freed only when neither the ring nor a session uses them.
+ */
+void acquireOwner(OwnerNode *owner);
+void releaseOwner(OwnerNode *owner);
+
+/**
+ * @brief Pin an owner found through the ring view, unless it is already dying.
+ * @param owner owner seen inside an epoch section
+ * @return 1 if pinned, 0 if its last reference is already gone
+ * Why we made it: A lock-free reader can meet an owner whose count just hit zero.
+ */
+int tryAcquireOwner(OwnerNode *owner);
+
+/* ------------------------------------------------------------
+   11) Printing Owners in a Circle
+   ------------------------------------------------------------ */
+
+/**
+ * @brief Write "[k] name" lines stepping around the ring from head, like menu option 6.
+ * The names are rendered once in stepping order and the lines go out in large writes.
+ * @param out stream to write to
+ * @param forward 1 to step clockwise (F), 0 counter-clockwise (B)
+ * @param prints number of lines
+ * @return lines written (0 if there are no owners)
+ * Why we made it: Printing millions of laps shouldn't cost a printf and a lookup per line.
+ */
+long long writeOwnerCycle(FILE *out, int forward, long long prints);
+
+/* ------------------------------------------------------------
+   12) Cleanup All Owners at Program End
+   ------------------------------------------------------------ */
+
+/**
+ * @brief Frees every remaining owner in the circular list, setting ownerHead = NULL.
+ * The trees are freed by the background reclaimer; epochReclaimAll() waits for it.
+ * After shutdownOwnerReclaimer(1) this only empties the ring.
+ * Why we made it: Ensures a squeaky-clean exit with no leftover memory.
+ */
+void freeAllOwners(void);
+
+/**
+ * @brief Stop the background thread that frees deleted owners and their trees.
+ * Owners released afterwards are freed by the releasing thread.
+ * @param exiting 0: free everything still queued first. 1: the process is
+ *        about to exit, so queued and later owners, and freeAllOwners(), skip
+ *        their per-node frees and leave the memory to the OS.
+ * Why we made it: Exiting with millions of nodes shouldn't free them one at a time.
+ */
+void shutdownOwnerReclaimer(int exiting);
+
+/* ------------------------------------------------------------
+   13) Persistent (Copy-on-Write) Pokedex Trees
+   ------------------------------------------------------------ */
+
+// One owner inside a ring snapshot: its own name copy + a reference to the tree
+typedef struct
+{
+    char *ownerName;
+    PokemonNode *pokedexRoot;
+} OwnerSnapshotEntry;
+
+typedef struct
+{
+    OwnerSnapshotEntry *entries;
+    int count;
+} OwnerRingSnapshot;
+
+/**
+ * @brief Take one more reference to a node (and so to its whole subtree).
+ * @param node the node (may be NULL)
+ * @return the same node
+ * Why we made it: Sharing a tree is just bumping the root's count.
+ */
+PokemonNode *retainPokemonNode(PokemonNode *node);
+
+/**
+ * @brief Return a private version of node: itself if unshared, else a copy.
+ * @param node node the caller holds one reference to
+ * @return node that may be modified in place (replaces the caller's reference)
+ * Why we made it: Path copying — a write copies only the nodes it walks through.
+ */
+PokemonNode *makeNodeWritable(PokemonNode *node);
+
+/**
+ * @brief Create a new owner sharing the source owner's Pokedex, in O(1).
+ * @param source owner to clone
+ * @param newOwnerName name for the clone (copied; need not be NUL-terminated)
+ * @param nameLength length of newOwnerName in bytes
+ * @return the new OwnerNode, already linked into the ring, or NULL if the name is taken
+ * Why we made it: Cloning used to mean re-inserting every Pokemon.
+ */
+OwnerNode *clonePokedex(OwnerNode *source, const char *newOwnerName, size_t nameLength);
+
+/**
+ * @brief Take a read-only snapshot of every owner's name and Pokedex.
+ * @return snapshot (free with freeOwnerSnapshot) or NULL
+ * Why we made it: Readers get a stable view while writers keep editing the live trees.
+ */
+OwnerRingSnapshot *snapshotOwners(void);
+
+/**
+ * @brief Release a snapshot and its tree references.
+ * @param snap snapshot from snapshotOwners
+ * Why we made it: Shared nodes are only freed once no snapshot points at them.
+ */
+void freeOwnerSnapshot(OwnerRingSnapshot *snap);
+
+/* ------------------------------------------------------------
+   14) Lock-Free Owner Ring Reads (Epoch-Based Reclamation)
+   ------------------------------------------------------------ */
+
+/**
+ * @brief Begin / end a read-side section; may nest.
+ * Why we made it: Anything reached from the ring view stays allocated until
+ *                 every thread has left the section it started in.
+ */
+void epochEnter(void);
+void epochExit(void);
+
+/**
+ * @brief Free ptr with freeFn once no reader can still hold it.
+ * @param ptr memory unlinked from every shared structure
+ * @param freeFn how to free it
+ * Why we made it: Deleting an owner must not free memory a lock-free reader is printing.
+ */
+void epochRetire(void *ptr, void (*freeFn)(void *));
+
+/**
+ * @brief Wait for readers to drain and free everything still retired,
+ *        including owners waiting for the background reclaimer.
+ * Why we made it: Clean exit with no leftover memory.
+ */
+void epochReclaimAll(void);
+
+/**
+ * @brief Current published ring view (NULL when there are no owners).
+ * @return the view; only valid until the matching epochExit()
+ * Why we made it: Listing, selection and lookup walk the ring without any lock.
+ */
+const OwnerRingView *currentRingView(void);
+
+/**
+ * @brief Number of owners in the current ring view.
+ * @return owner count (0 if none)
+ * Why we made it: Cheap emptiness checks for menus.
+ */
+int currentRingSize(void);
+
+/**
+ * @brief Rebuild the ring view from ownerHead and publish it atomically.
+ * Why we made it: Every ring writer calls this (holding ownerRingLock) after relinking.
+ */
+void publishRingViewLocked(void);
+
+/* ------------------------------------------------------------
+   15) Multi-Session Server
+   ------------------------------------------------------------ */
+
+typedef enum
+{
+    SESSION_MAIN_MENU,
+    SESSION_NEW_NAME,
+    SESSION_NEW_STARTER,
+    SESSION_CHOOSE_OWNER,
+    SESSION_OWNER_MENU,
+    SESSION_ADD_ID,
+    SESSION_DISPLAY_CHOICE,
+    SESSION_RELEASE_ID,
+    SESSION_FIGHT_FIRST,
+    SESSION_FIGHT_SECOND,
+    SESSION_EVOLVE_ID,
+    SESSION_BULK_IDS,
+    SESSION_DELETE_CHOICE,
+    SESSION_MERGE_FIRST,
+    SESSION_MERGE_SECOND,
+    SESSION_PRINT_DIRECTION,
+    SESSION_PRINT_COUNT,
+    SESSION_CLONE_SOURCE,
+    SESSION_CLONE_NAME,
+    SESSION_CLOSED
+} SessionState;
+
+// Growable output buffer; bytes [sent, len) are still waiting to go out
+typedef struct
+{
+    char *data;
+    size_t len;
+    size_t cap;
+    size_t sent;
+} OutBuffer;
+
+// One trainer's place in the menus, kept between input lines
+typedef struct
+{
+    SessionState state;
+    OwnerNode *owner;        // Pokedex being edited (holds a reference)
+    OwnerNode *pendingOwner; // New owner / first merge owner / clone source between prompts (holds a reference)
+    int pendingId;           // First fight ID
+    int pendingCount;        // Owners listed by the delete prompt
+    struct OwnerCycle *printCycle; // Copied names while "print owners" output streams
+    int printForward;
+    long long printTotal;
+    long long printDone;
+    OutBuffer out;
+    int quiet;               // Replay: apply commands without formatting replies
+} Session;
+
+/**
+ * @brief Start a session at the main menu (its prompt is queued in session->out).
+ * @param session session to initialize
+ * Why we made it: Many trainers can be in different menus at the same time.
+ */
+void sessionInit(Session *session);
+
+/**
+ * @brief Advance a session by one input line, queueing the reply.
+ * @param session the session
+ * @param line one line of input without its newline (not modified, need not be NUL-terminated)
+ * @param length line length in bytes
+ * Why we made it: The menu flow without blocking reads, so one thread serves everyone.
+ */
+void sessionHandleLine(Session *session, const char *line, size_t length);
+
+/**
+ * @brief Whether a long "print owners" reply is still being produced.
+ * @param session the session
+ * @return 1 if sessionPump() has more to add, 0 otherwise
+ * Why we made it: Drivers stop feeding input until the reply is complete.
+ */
+int sessionStreaming(const Session *session);
+
+/**
+ * @brief Queue the next chunk of a streaming reply.
+ * @param session the session
+ * Why we made it: Huge print counts go out piece by piece instead of all in memory.
+ */
+void sessionPump(Session *session);
+
+/**
+ * @brief Drop the session's owner references and buffers.
+ * @param session the session
+ * Why we made it: Disconnecting trainers must not leak or pin owners.
+ */
+void sessionFree(Session *session);
+
+/**
+ * @brief Serve sessions on a Unix domain socket until SIGINT/SIGTERM.
+ * @param socketPath filesystem path of the socket
+ * @return 0 on clean shutdown, 1 if the socket could not be set up
+ * Why we made it: Many trainers share one live Pokedex world.
+ */
+int runServer(const char *socketPath);
+
+/**
+ * @brief Apply a command file (the same lines the menus read) through a quiet session.
+ * The file is memory-mapped and parsed in place; stops at its end or at "exit".
+ * Throughput is reported on stderr.
+ * @param path command file
+ * @return 0 on success, 1 if the file could not be mapped
+ * Why we made it: Multi-gigabyte production traces replay at parsing speed, not stdio speed.
+ */
+int replayCommandFile(const char *path);
+
+/**
+ * @brief Play the menus on stdin/stdout through one session until "Exit" or end of input.
+ * Input is read in large chunks by a LineReader; replies go out with fwrite.
+ * Why we made it: The console runs the same menu flow as the server and replay, not a second copy.
+ */
+void runConsoleSession(void);
+
+/* ------------------------------------------------------------
+   16) Instrumentation
+   ------------------------------------------------------------ */
+
+#define LATENCY_SUB_BITS 4                    // 16 linear steps per power of two (~6% error)
+#define LATENCY_SUB_COUNT (1 << LATENCY_SUB_BITS)
+#define LATENCY_MAX_SHIFT 36                  // Samples above ~2^40 ns land in the last bucket
+#define LATENCY_BUCKETS ((LATENCY_MAX_SHIFT + 2) * LATENCY_SUB_COUNT)
+
+// HDR-style latency histogram in nanoseconds. One thread records into it;
+// any thread may read it meanwhile (counts are relaxed atomics).
+typedef struct
+{
+    atomic_ullong counts[LATENCY_BUCKETS];
+    atomic_ullong total;
+    atomic_ullong sumNanos;
+    atomic_ullong maxNanos;
+} LatencyHistogram;
+
+// Core paths that keep per-thread counters
+typedef enum
+{
+    METRIC_SEARCH,
+    METRIC_INSERT,
+    METRIC_DELETE,
+    METRIC_EVOLVE,
+    METRIC_MERGE,
+    METRIC_OWNER_LOOKUP,
+    METRIC_DISPLAY,
+    METRIC_COUNT
+} MetricOp;
+
+/**
+ * @brief Current CLOCK_MONOTONIC time.
+ * @return nanoseconds
+ * Why we made it: One timestamp source for metrics, the server and benchmarks.
+ */
+unsigned long long monotonicNanos(void);
+
+/**
+ * @brief Record one latency sample (single writer per histogram).
+ * @param hist histogram
+ * @param nanos sample in nanoseconds
+ * Why we made it: Constant-time recording with no allocation on hot paths.
+ */
+void latencyRecord(LatencyHistogram *hist, unsigned long long nanos);
+
+/**
+ * @brief Add every sample of src into dst.
+ * @param dst histogram being built (owned by the caller)
+ * @param src histogram that may still be recording
+ * Why we made it: Per-thread histograms are combined only when someone asks.
+ */
+void latencyMerge(LatencyHistogram *dst, const LatencyHistogram *src);
+
+/**
+ * @brief Upper bound of the bucket holding the given percentile.
+ * @param hist histogram
+ * @param percentile 0..100
+ * @return nanoseconds (never more than the slowest sample)
+ * Why we made it: p50/p99/p999 reporting without storing every sample.
+ */
+unsigned long long latencyPercentile(const LatencyHistogram *hist, double percentile);
+
+/**
+ * @brief Begin timing one core operation on this thread.
+ * @param op which operation
+ * @return start timestamp, or 0 when this call is not sampled for latency
+ * Why we made it: Sub-microsecond tree ops are timed 1 call in 16 (a clock read is ~25-70 ns).
+ */
+unsigned long long metricsStart(MetricOp op);
+
+/**
+ * @brief Finish one core operation: count it and record what it touched.
+ * @param op which operation
+ * @param start value returned by metricsStart()
+ * @param visited tree depth walked (search/insert/delete/evolve), nodes
+ *        moved or shown (merge/display) or owners scanned (lookup)
+ * Why we made it: Call counts and depths tell us which menu action is slow and why.
+ */
+void metricsStop(MetricOp op, unsigned long long start, unsigned long visited);
+
+/**
+ * @brief Print all threads' counters and latency percentiles.
+ * @param out destination stream
+ * Why we made it: Hidden main-menu option 9 and SIGUSR1 show it on demand.
+ */
+void metricsDump(FILE *out);
+
+/**
+ * @brief Dump metrics and the memory report to stderr whenever the process gets SIGUSR1.
+ * Call before creating other threads; a helper thread waits for the signal.
+ * Why we made it: Inspect a running game or server without touching its input.
+ */
+void metricsDumpOnSignal(void);
+
+/* ------------------------------------------------------------
+   17) Memory Accounting
+   ------------------------------------------------------------ */
+
+// Who asked for the memory (every tracked allocation names one)
+typedef enum
+{
+    MEM_POKEMON_NODES, // Pokedex tree nodes, including copy-on-write copies
+    MEM_OWNERS,        // OwnerNode records and their names
+    MEM_RING_VIEWS,    // Published OwnerRingViews
+    MEM_EPOCH,         // Retire-list entries waiting for reclamation
+    MEM_SCRATCH,       // Per-call queues, node arrays, input lines, ID lists, snapshots
+    MEM_SESSIONS,      // Server connections and their buffers
+    MEM_INDEXES,       // Name tries and other lookup indexes
+    MEM_CATEGORY_COUNT
+} MemCategory;
+
+/**
+ * @brief malloc() that charges the block to a category (and, for tree
+ *        nodes, to the owner currently write-locked by this thread).
+ * @param category subsystem paying for it
+ * @param size bytes
+ * @return the block or NULL
+ * Why we made it: Know where every byte goes without a header on each block.
+ */
+void *memAlloc(MemCategory category, size_t size);
+
+/**
+ * @brief calloc() counterpart of memAlloc().
+ * @param category subsystem paying for it
+ * @param count element count
+ * @param size element size
+ * @return zeroed block or NULL
+ * Why we made it: Same accounting for zero-initialized records.
+ */
+void *memCalloc(MemCategory category, size_t count, size_t size);
+
+/**
+ * @brief realloc() counterpart of memAlloc() (category must match the original).
+ * @param category subsystem paying for it
+ * @param ptr block to grow or shrink (may be NULL)
+ * @param size new size in bytes
+ * @return the moved block, or NULL with ptr left intact
+ * Why we made it: Growing buffers stay accounted.
+ */
+void *memRealloc(MemCategory category, void *ptr, size_t size);
+
+/**
+ * @brief strdup() charged to a category.
+ * @param category subsystem paying for it
+ * @param src string to copy
+ * @return copy, or NULL if allocation failed
+ * Why we made it: Names are the most common small allocation.
+ */
+char *memStrdup(MemCategory category, const char *src);
+
+/**
+ * @brief free() a block from memAlloc/memCalloc/memRealloc/memStrdup.
+ * @param category the category it was allocated under
+ * @param ptr block (NULL is fine)
+ * Why we made it: Sizes come from the allocator, so callers never pass them.
+ */
+void memFree(MemCategory category, void *ptr);
+
+/**
+ * @brief Allocations charged to a category so far, summed over all threads.
+ * @param category subsystem to count
+ * @return number of blocks ever allocated (tree nodes count one each)
+ * Why we made it: Lets a benchmark prove a path never allocates.
+ */
+unsigned long long memAllocationCount(MemCategory category);
+
+/**
+ * @brief Print live bytes per subsystem and the owners costing the most.
+ * @param out destination stream
+ * @param topOwners how many owners to list
+ * Why we made it: Find the biggest consumers on a running game or server.
+ */
+void memoryReport(FILE *out, int topOwners);
+
+/* ------------------------------------------------------------
+   18) Monte-Carlo Battle Simulation and Team Matchups
+   ------------------------------------------------------------ */
+
+// Outcome counts of a simulation run
+typedef struct
+{
+    unsigned long long simulations;
+    unsigned long long firstWins;
+    unsigned long long secondWins;
+    unsigned long long draws;
+    double seconds;
+} SimulationResult;
+
+/**
+ * @brief Estimate who wins between two owners' rosters under random damage rolls.
+ * Each battle sends the rosters out in ID order. Every exchange, a coin flip picks
+ * who strikes first, and each hit deals attack x type multiplier (typed mode) x a
+ * 0.85-1.0 roll. A team loses when its last Pokemon faints.
+ * Battles are split over threads. Each thread has its own xoshiro256** stream, and
+ * results are folded into shared atomic counters.
+ * @param first first owner (rosters are copied under read locks first)
+ * @param second second owner
+ * @param simulations number of battles
+ * @param threads worker threads (at least 1)
+ * @param seed RNG seed; the same seed and thread count repeat a run exactly
+ * @param mode BATTLE_CLASSIC or BATTLE_TYPED
+ * @param progress if not NULL, receives the running estimate and its 95% interval
+ * @param result receives the counts and the wall time
+ * @return POKEDEX_OK, POKEDEX_NOT_FOUND (an empty roster) or POKEDEX_NO_MEMORY
+ * Why we made it: Win probabilities between rosters, not a single deterministic score.
+ */
+PokedexStatus simulateRosterBattles(OwnerNode *first, OwnerNode *second, unsigned long long simulations,
+                                    int threads, unsigned long long seed, BattleMode mode, FILE *progress,
+                                    SimulationResult *result);
+
+// One pairing of an optimal matchup; outcome is for the first owner's Pokemon
+typedef struct
+{
+    int firstId;
+    int secondId;
+    int outcome; // 1 win, 0 tie, -1 loss
+} MatchupPair;
+
+typedef struct
+{
+    MatchupPair *pairs; // min(roster sizes) pairs, in the first owner's ID order
+    int count;
+    int wins;
+    int ties;
+    int losses;
+} Matchup;
+
+/**
+ * @brief Pair each Pokemon of one owner with a different Pokemon of the other
+ *        so that the first owner wins as many fights as possible.
+ * Among pairings with equally many wins, the one with the most ties is
+ * chosen. Solves the assignment problem over the win matrix with the
+ * Hungarian algorithm in O(n^3); the larger roster leaves some Pokemon unpaired.
+ * @param first owner whose wins are maximized
+ * @param second opposing owner
+ * @param mode how each pairing is scored (see battleScore)
+ * @param matchup receives the pairs; release with freeMatchup
+ * @return POKEDEX_OK, POKEDEX_NOT_FOUND (an empty roster) or POKEDEX_NO_MEMORY
+ * Why we made it: Trying every pairing is factorial in the roster size.
+ */
+PokedexStatus bestMatchup(OwnerNode *first, OwnerNode *second, BattleMode mode, Matchup *matchup);
+
+/**
+ * @brief Release the pairs of a matchup.
+ * @param matchup matchup filled by bestMatchup
+ * Why we made it: Callers own the result array.
+ */
+void freeMatchup(Matchup *matchup);
+
+/* ------------------------------------------------------------
+   19) Name Completion
+   ------------------------------------------------------------ */
+
+/**
+ * @brief Species whose names start with a prefix (any case), alphabetically.
+ * @param prefix typed text (need not be NUL-terminated)
+ * @param length prefix length in bytes
+ * @param ids receives up to limit species IDs
+ * @param limit how many completions to return at most
+ * @return number of IDs stored
+ * Why we made it: As-you-type completion; the cost depends on the prefix and
+ *                 the completions returned, never on the size of the Pokedex.
+ */
+int completeSpeciesNames(const char *prefix, size_t length, int *ids, int limit);
+
+/**
+ * @brief Owners whose names start with a prefix (any case), alphabetically.
+ * The owner trie is kept up to date as owners are linked and deleted.
+ * @param prefix typed text (need not be NUL-terminated)
+ * @param length prefix length in bytes
+ * @param owners receives up to limit pinned owners (caller must releaseOwner each)
+ * @param limit how many completions to return at most
+ * @return number of owners stored
+ * Why we made it: Completion time must not grow with the number of owners.
+ */
+int completeOwnerNames(const char *prefix, size_t length, OwnerNode **owners, int limit);
+
+/* ------------------------------------------------------------
+   20) Species Index
+   ------------------------------------------------------------ */
+
+/**
+ * @brief Number of linked owners that have a species.
+ * @param id species ID
+ * @return owner count (0 for an invalid ID)
+ * Why we made it: Species popularity without touching any Pokedex.
+ */
+int countOwnersWithSpecies(int id);
+
+/**
+ * @brief Linked owners that have a species, in no particular order.
+ * The index is updated by every add, release, evolve, merge, link and delete.
+ * @param id species ID
+ * @param owners receives up to limit pinned owners (caller must releaseOwner each)
+ * @param limit how many owners to return at most
+ * @return number of owners stored
+ * Why we made it: "Who owns Pikachu?" shouldn't scan every owner's tree.
+ */
+int ownersWithSpecies(int id, OwnerNode **owners, int limit);
+
+/**
+ * @brief Linked owners that have every one of the given species.
+ * Walks the shortest of the species' owner lists and checks the rest in O(1) each.
+ * @param ids species IDs (repeats are ignored)
+ * @param count number of IDs
+ * @param owners receives up to limit pinned owners (caller must releaseOwner each)
+ * @param limit how many owners to return at most
+ * @return number of owners stored (0 if count is 0 or any ID is invalid)
+ * Why we made it: Questions like "owners with both Mew and Mewtwo".
+ */
+int ownersWithAllSpecies(const int *ids, int count, OwnerNode **owners, int limit);
+
+typedef enum
+{
+    SIMILARITY_JACCARD, // shared / species in either collection
+    SIMILARITY_OVERLAP  // shared / size of the smaller collection
+} SimilarityMetric;
+
+/**
+ * @brief The owners whose collections are most like this owner's, best first.
+ * Every linked owner's species set is kept as a 151-bit row of one packed
+ * table, so the scan is three AND + popcount per owner over contiguous memory.
+ * @param owner the owner to match (must be linked)
+ * @param metric how to score two collections
+ * @param owners receives up to limit pinned owners (caller must releaseOwner each)
+ * @param scores receives each owner's score in [0, 1] (may be NULL)
+ * @param limit how many owners to return at most
+ * @return number of owners stored; owners with nothing in common are left out
+ * Why we made it: Matchmaking by collection, over millions of owners, in milliseconds.
+ */
+int mostSimilarOwners(OwnerNode *owner, SimilarityMetric metric, OwnerNode **owners, double *scores, int limit);
+
+/* ------------------------------------------------------------
+   21) Strength Leaderboard
+   ------------------------------------------------------------ */
+
+/**
+ * @brief An owner's team strength: pokemonScore summed over its species.
+ * Kept as a running total by every add, release, evolve and merge.
+ * @param owner the owner
+ * @return the total (0 for an empty Pokedex)
+ * Why we made it: Strength without walking the tree.
+ */
+double ownerStrength(OwnerNode *owner);
+
+/**
+ * @brief Where an owner stands on the leaderboard, strongest first.
+ * Ties are broken by name. O(log n).
+ * @param owner the owner
+ * @return its 1-based rank, or 0 if it isn't linked
+ * Why we made it: "Rank of owner X" among millions, without sorting anyone.
+ */
+int ownerStrengthRank(OwnerNode *owner);
+
+/**
+ * @brief A page of the leaderboard, strongest first.
+ * Finding the first rank is O(log n); each further owner is one step.
+ * @param firstRank 1-based rank of the first owner to return (1 for the top)
+ * @param owners receives up to limit pinned owners (caller must releaseOwner each)
+ * @param strengths receives each owner's ownerStrength (may be NULL)
+ * @param limit how many owners to return at most
+ * @return number of owners stored (0 past the end of the board)
+ * Why we made it: Top-N tables and paging through the rankings.
+ */
+int strongestOwners(int firstRank, OwnerNode **owners, double *strengths, int limit);
+
+/* ------------------------------------------------------------
+   22) Streaming Export
+   ------------------------------------------------------------ */
+
+typedef enum
+{
+    EXPORT_CSV,       // Header line, then owner,id,name,type,hp,attack,can_evolve per Pokemon
+    EXPORT_JSON_LINES // {"owner":...,"pokemon":[{...},...]} per owner, one per line
+} ExportFormat;
+
+/**
+ * @brief Write every owner's Pokedex, in ring order and ID order within each.
+ * The ring is pinned as it stands at the start; each tree is walked from a
+ * root retained under the owner's read lock, so no lock or epoch is held
+ * while formatting or writing. Rows go into one 1 MB buffer that goes out in
+ * whole-buffer writes. Owners with an empty Pokedex have no CSV rows.
+ * @param out stream to write to
+ * @param format CSV or JSON Lines
+ * @return number of Pokemon written, or -1 if a write failed or memory ran out
+ * Why we made it: Nightly analytics dumps of millions of collections at disk speed.
+ */
+long long exportOwners(FILE *out, ExportFormat format);
+
+/* ------------------------------------------------------------
+   23) Species Table
+   ------------------------------------------------------------ */
+
+// Array of Pokemon data (the one static species table, defined in pokemon.c)
+extern const PokemonData pokedex[POKEDEX_SIZE];
+
+#endif // pokemon_H
+
@@ -0,0 +1,1567 @@
+// ================================================
+// Pokedex benchmarks
+// Drives the thread-safe core operations directly (no menus).
+//
+// Build (the game's main() is compiled out):
+//   gcc -O2 -pthread -DPOKEMON_NO_MAIN pokemon.c pokemon_bench.c -o pokemon_bench
+// Run:
+//   ./pokemon_bench stress [owners] [opsPerThread] [maxThreads]
+//   ./pokemon_bench ring [owners] [seconds] [readers]
+//   ./pokemon_bench suite [owners] [ops] [seed] [seq|random] [mix]
+//   ./pokemon_bench battles [rounds]
+//   ./pokemon_bench simulate [battles] [threads] [seed] [classic|typed]
+//   ./pokemon_bench matchup [rounds]
+//   ./pokemon_bench complete [owners] [queries]
+//   ./pokemon_bench sorted [owners] [rounds]
+//   ./pokemon_bench cycle [owners] [prints]
+//   ./pokemon_bench frozen [owners] [lookups]
+//   ./pokemon_bench species [owners] [queries]
+//   ./pokemon_bench similar [owners] [queries]
+//   ./pokemon_bench leaderboard [owners] [queries]
+//   ./pokemon_bench release [owners] [rounds]
+//   ./pokemon_bench reclaim [owners]
+//   ./pokemon_bench export [owners] [csv|jsonl]
+// ================================================
+
+#include "pokemon.h"
+#include <time.h>
+#include <unistd.h>
+
+// --------------------------------------------------------------
+// Small helpers: timing and a per-thread RNG (no shared state)
+// --------------------------------------------------------------
+
+static double nowSeconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// xorshift64*: tiny, fast, good enough to pick owners and IDs
+static unsigned long long nextRandom(unsigned long long *state)
+{
+    unsigned long long x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 2685821657736338717ULL;
+}
+
+// Links count owners named Trainer0, Trainer1, ... and gives each one fill
+// random adds (1 + a random number below fill when varied is set).
+// owners, when not NULL, receives them in ring order.
+static void makeOwners(int count, int fill, int varied, unsigned long long *rng, OwnerNode **owners)
+{
+    char name[32];
+    for (int i = 0; i < count; i++)
+    {
+        snprintf(name, sizeof(name), "Trainer%d", i);
+        OwnerNode *owner = createOwner(name, NULL);
+        linkOwnerInCircularList(owner);
+        if (owners != NULL)
+        {
+            owners[i] = owner;
+        }
+        int size = varied ? 1 + (int)(nextRandom(rng) % fill) : fill;
+        for (int k = 0; k < size; k++)
+        {
+            pokedexAddPokemon(owner, (int)(nextRandom(rng) % POKEDEX_SIZE) + 1);
+        }
+    }
+}
+
+// --------------------------------------------------------------
+// Multi-threaded stress: add / release / fight on shared owners
+// --------------------------------------------------------------
+
+typedef struct
+{
+    OwnerNode **owners;
+    int ownerCount;
+    long ops;
+    unsigned long long seed;
+} StressArgs;
+
+static void *stressWorker(void *arg)
+{
+    StressArgs *args = (StressArgs *)arg;
+    unsigned long long rng = args->seed;
+    double score1, score2;
+
+    for (long i = 0; i < args->ops; i++)
+    {
+        OwnerNode *owner = args->owners[nextRandom(&rng) % args->ownerCount];
+        int id = (int)(nextRandom(&rng) % POKEDEX_SIZE) + 1;
+        int op = (int)(nextRandom(&rng) % 10);
+
+        // 40% add, 30% release, 30% fight
+        if (op < 4)
+        {
+            pokedexAddPokemon(owner, id);
+        }
+        else if (op < 7)
+        {
+            pokedexReleasePokemon(owner, id);
+        }
+        else
+        {
+            int other = (int)(nextRandom(&rng) % POKEDEX_SIZE) + 1;
+            pokedexFight(owner, id, other, &score1, &score2);
+        }
+    }
+    return NULL;
+}
+
+static double runStress(OwnerNode **owners, int ownerCount, int threads, long opsPerThread)
+{
+    pthread_t *tids = (pthread_t *)malloc(sizeof(pthread_t) * threads);
+    StressArgs *args = (StressArgs *)malloc(sizeof(StressArgs) * threads);
+    if (tids == NULL || args == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    double start = nowSeconds();
+    for (int t = 0; t < threads; t++)
+    {
+        args[t].owners = owners;
+        args[t].ownerCount = ownerCount;
+        args[t].ops = opsPerThread;
+        args[t].seed = 0x9E3779B97F4A7C15ULL * (unsigned long long)(t + 1);
+        pthread_create(&tids[t], NULL, stressWorker, &args[t]);
+    }
+    for (int t = 0; t < threads; t++)
+    {
+        pthread_join(tids[t], NULL);
+    }
+    double elapsed = nowSeconds() - start;
+
+    free(tids);
+    free(args);
+    return elapsed;
+}
+
+static int benchStress(int ownerCount, long opsPerThread, int maxThreads)
+{
+    OwnerNode **owners = (OwnerNode **)malloc(sizeof(OwnerNode *) * ownerCount);
+    if (owners == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed.\n");
+        return 1;
+    }
+
+    char name[32];
+    for (int i = 0; i < ownerCount; i++)
+    {
+        snprintf(name, sizeof(name), "trainer%d", i);
+        owners[i] = createOwner(name, createPokemonNode(&pokedex[(i % 3) * 3]));
+        linkOwnerInCircularList(owners[i]);
+    }
+
+    printf("stress: %d owners, %ld ops/thread (40%% add, 30%% release, 30%% fight)\n",
+           ownerCount, opsPerThread);
+    printf("%8s %12s %14s %8s\n", "threads", "seconds", "ops/sec", "speedup");
+
+    double baseRate = 0;
+    for (int threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        double elapsed = runStress(owners, ownerCount, threads, opsPerThread);
+        double rate = (double)threads * opsPerThread / elapsed;
+        if (threads == 1)
+        {
+            baseRate = rate;
+        }
+        printf("%8d %12.3f %14.0f %7.2fx\n", threads, elapsed, rate, rate / baseRate);
+    }
+
+    free(owners);
+    freeAllOwners();
+    epochReclaimAll();
+    return 0;
+}
+
+// --------------------------------------------------------------
+// Ring churn: lock-free readers vs. a writer creating/deleting owners
+// --------------------------------------------------------------
+
+typedef struct
+{
+    int ownerCount;
+    atomic_int *stop;
+    long lookups;
+    unsigned long long seed;
+} RingReaderArgs;
+
+static void *ringReader(void *arg)
+{
+    RingReaderArgs *args = (RingReaderArgs *)arg;
+    unsigned long long rng = args->seed;
+    char name[32];
+
+    while (!atomic_load(args->stop))
+    {
+        snprintf(name, sizeof(name), "trainer%d", (int)(nextRandom(&rng) % args->ownerCount));
+        OwnerNode *owner = acquireOwnerByName(name);
+        if (owner != NULL)
+        {
+            pokedexIsEmpty(owner);
+            releaseOwner(owner);
+        }
+
+        // A full lap over the ring, as listing menus do
+        epochEnter();
+        const OwnerRingView *view = currentRingView();
+        size_t total = 0;
+        for (int i = 0; view != NULL && i < view->count; i++)
+        {
+            total += strlen(view->owners[i]->ownerName);
+        }
+        epochExit();
+        (void)total;
+        args->lookups++;
+    }
+    return NULL;
+}
+
+static int benchRing(int ownerCount, double seconds, int readers)
+{
+    char name[32];
+    for (int i = 0; i < ownerCount; i++)
+    {
+        snprintf(name, sizeof(name), "trainer%d", i);
+        linkOwnerInCircularList(createOwner(name, createPokemonNode(&pokedex[0])));
+    }
+
+    atomic_int stop;
+    atomic_init(&stop, 0);
+    pthread_t *tids = (pthread_t *)malloc(sizeof(pthread_t) * readers);
+    RingReaderArgs *args = (RingReaderArgs *)calloc(readers, sizeof(RingReaderArgs));
+    if (tids == NULL || args == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed.\n");
+        return 1;
+    }
+    for (int t = 0; t < readers; t++)
+    {
+        args[t].ownerCount = ownerCount;
+        args[t].stop = &stop;
+        args[t].seed = 0xD1B54A32D192ED03ULL * (unsigned long long)(t + 1);
+        pthread_create(&tids[t], NULL, ringReader, &args[t]);
+    }
+
+    // Writer: delete a random owner and recreate it, over and over
+    unsigned long long rng = 42;
+    long churns = 0;
+    double start = nowSeconds();
+    while (nowSeconds() - start < seconds)
+    {
+        snprintf(name, sizeof(name), "trainer%d", (int)(nextRandom(&rng) % ownerCount));
+        OwnerNode *victim = acquireOwnerByName(name);
+        if (victim != NULL)
+        {
+            deleteOwnerFromList(victim);
+            releaseOwner(victim);
+        }
+        OwnerNode *fresh = createOwner(name, createPokemonNode(&pokedex[3]));
+        if (!linkOwnerIfNameFree(fresh))
+        {
+            releaseOwner(fresh);
+        }
+        churns++;
+    }
+    atomic_store(&stop, 1);
+
+    long lookups = 0;
+    for (int t = 0; t < readers; t++)
+    {
+        pthread_join(tids[t], NULL);
+        lookups += args[t].lookups;
+    }
+    double elapsed = nowSeconds() - start;
+
+    printf("ring: %d owners, %d readers, %.1fs\n", ownerCount, readers, elapsed);
+    printf("  reader lookups+laps/sec: %.0f\n", lookups / elapsed);
+    printf("  writer delete+create/sec: %.0f\n", churns / elapsed);
+
+    free(tids);
+    free(args);
+    freeAllOwners();
+    epochReclaimAll();
+    return 0;
+}
+
+// --------------------------------------------------------------
+// Workload suite: a seeded, single-threaded mix of every operation
+// with per-operation throughput and latency percentiles
+// --------------------------------------------------------------
+
+typedef enum
+{
+    SUITE_ADD,
+    SUITE_RELEASE,
+    SUITE_EVOLVE,
+    SUITE_FIGHT,
+    SUITE_BULK,
+    SUITE_MERGE,
+    SUITE_SORT,
+    SUITE_FIND,
+    SUITE_OP_COUNT
+} SuiteOp;
+
+static const char *suiteOpNames[SUITE_OP_COUNT] = {"add", "release", "evolve", "fight",
+                                                   "bulk", "merge", "sort", "find"};
+
+// Default mix, in percent-like weights
+static const int suiteDefaultMix[SUITE_OP_COUNT] = {35, 20, 10, 15, 3, 1, 1, 15};
+
+typedef struct
+{
+    LatencyHistogram latency;
+    unsigned long long ok; // Calls that changed/found something
+} SuiteStats;
+
+static unsigned long long nowNanos(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + (unsigned long long)ts.tv_nsec;
+}
+
+// "add:40,release:20,find:40" -> weights (ops not named get 0). Returns 0 on a bad spec.
+static int parseSuiteMix(const char *spec, int *weights)
+{
+    char *copy = myStrdup(spec);
+    memset(weights, 0, sizeof(int) * SUITE_OP_COUNT);
+    int total = 0;
+    for (char *item = strtok(copy, ","); item != NULL; item = strtok(NULL, ","))
+    {
+        char *colon = strchr(item, ':');
+        if (colon == NULL)
+        {
+            memFree(MEM_SCRATCH, copy);
+            return 0;
+        }
+        *colon = '\0';
+        int op = 0;
+        while (op < SUITE_OP_COUNT && strcmp(item, suiteOpNames[op]) != 0)
+        {
+            op++;
+        }
+        int weight = atoi(colon + 1);
+        if (op == SUITE_OP_COUNT || weight < 0)
+        {
+            memFree(MEM_SCRATCH, copy);
+            return 0;
+        }
+        weights[op] = weight;
+        total += weight;
+    }
+    memFree(MEM_SCRATCH, copy);
+    return total > 0;
+}
+
+static OwnerNode *suiteCreateOwner(int index)
+{
+    char name[32];
+    snprintf(name, sizeof(name), "trainer%d", index);
+    OwnerNode *owner = createOwner(name, createPokemonNode(&pokedex[(index % 3) * 3]));
+    linkOwnerInCircularList(owner);
+    return owner;
+}
+
+static int benchSuite(int ownerCount, long ops, unsigned long long seed, int sequential, const int *weights)
+{
+    OwnerNode **owners = (OwnerNode **)malloc(sizeof(OwnerNode *) * ownerCount);
+    int *cursor = (int *)calloc(ownerCount, sizeof(int)); // next ID per owner in sequential mode
+    if (owners == NULL || cursor == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed.\n");
+        return 1;
+    }
+    for (int i = 0; i < ownerCount; i++)
+    {
+        owners[i] = suiteCreateOwner(i);
+    }
+
+    int totalWeight = 0;
+    for (int op = 0; op < SUITE_OP_COUNT; op++)
+    {
+        totalWeight += weights[op];
+    }
+
+    SuiteStats stats[SUITE_OP_COUNT];
+    memset(stats, 0, sizeof(stats));
+    unsigned long long rng = seed ? seed : 1;
+    int bulkIds[16];
+    char name[32];
+    double score1, score2;
+
+    unsigned long long suiteStart = nowNanos();
+    for (long i = 0; i < ops; i++)
+    {
+        int pick = (int)(nextRandom(&rng) % (unsigned long long)totalWeight);
+        int op = 0;
+        while (pick >= weights[op])
+        {
+            pick -= weights[op];
+            op++;
+        }
+
+        int ownerIndex = (int)(nextRandom(&rng) % ownerCount);
+        OwnerNode *owner = owners[ownerIndex];
+        int id;
+        if (sequential)
+        {
+            // Each owner sees ascending IDs: the worst case for an unbalanced BST
+            id = cursor[ownerIndex] + 1;
+            cursor[ownerIndex] = (cursor[ownerIndex] + 1) % POKEDEX_SIZE;
+        }
+        else
+        {
+            id = (int)(nextRandom(&rng) % POKEDEX_SIZE) + 1;
+        }
+
+        // Inputs are generated before the clock starts
+        int other = (int)(nextRandom(&rng) % ownerCount);
+        if (op == SUITE_BULK)
+        {
+            for (int k = 0; k < 16; k++)
+            {
+                bulkIds[k] = sequential ? (id + k - 1) % POKEDEX_SIZE + 1 : (int)(nextRandom(&rng) % POKEDEX_SIZE) + 1;
+            }
+        }
+        if (op == SUITE_FIND)
+        {
+            snprintf(name, sizeof(name), "trainer%d", other);
+        }
+
+        int ok = 0;
+        unsigned long long began = nowNanos();
+        switch (op)
+        {
+        case SUITE_ADD:
+            ok = (pokedexAddPokemon(owner, id) == POKEDEX_OK);
+            break;
+        case SUITE_RELEASE:
+            ok = (pokedexReleasePokemon(owner, id) == POKEDEX_OK);
+            break;
+        case SUITE_EVOLVE:
+            ok = (pokedexEvolvePokemon(owner, id) == POKEDEX_OK);
+            break;
+        case SUITE_FIGHT:
+            ok = (pokedexFight(owner, id, (id % POKEDEX_SIZE) + 1, &score1, &score2) == POKEDEX_OK);
+            break;
+        case SUITE_BULK:
+            ok = (addPokemonBulk(owner, bulkIds, 16) > 0);
+            break;
+        case SUITE_MERGE:
+            ok = (other != ownerIndex && mergeOwners(owner, owners[other]) == POKEDEX_OK);
+            break;
+        case SUITE_SORT:
+            ok = (sortOwnerRing() > 0);
+            break;
+        case SUITE_FIND:
+            ok = (findOwnerByName(name) != NULL);
+            break;
+        }
+        latencyRecord(&stats[op].latency, nowNanos() - began);
+        stats[op].ok += ok;
+
+        if (op == SUITE_MERGE && ok)
+        {
+            // Keep the population constant: the merged-away owner comes back with a starter
+            owners[other] = suiteCreateOwner(other);
+            cursor[other] = 0;
+        }
+    }
+    double elapsed = (nowNanos() - suiteStart) / 1e9;
+
+    printf("suite: %d owners, %ld ops, seed %llu, %s IDs\n", ownerCount, ops, seed,
+           sequential ? "sequential" : "random");
+    printf("%-8s %10s %6s %12s %10s %10s %10s %10s\n", "op", "count", "ok%", "ops/sec", "p50 us", "p99 us",
+           "p999 us", "max us");
+    for (int op = 0; op < SUITE_OP_COUNT; op++)
+    {
+        const LatencyHistogram *hist = &stats[op].latency;
+        if (hist->total == 0)
+        {
+            continue;
+        }
+        printf("%-8s %10llu %5.1f%% %12.0f %10.2f %10.2f %10.2f %10.2f\n", suiteOpNames[op], hist->total,
+               100.0 * stats[op].ok / hist->total, hist->total / (hist->sumNanos / 1e9),
+               latencyPercentile(hist, 50) / 1000.0, latencyPercentile(hist, 99) / 1000.0,
+               latencyPercentile(hist, 99.9) / 1000.0, hist->maxNanos / 1000.0);
+    }
+    printf("total: %.3fs, %.0f ops/sec\n", elapsed, ops / elapsed);
+
+    free(owners);
+    free(cursor);
+    freeAllOwners();
+    epochReclaimAll();
+    return 0;
+}
+
+// --------------------------------------------------------------
+// Battle scoring: every species against every species, per mode
+// --------------------------------------------------------------
+
+static int benchBattles(long rounds)
+{
+    static const char *modeNames[BATTLE_MODE_COUNT] = {"classic", "typed"};
+    for (int mode = 0; mode < BATTLE_MODE_COUNT; mode++)
+    {
+        long wins = 0;
+        double start = nowSeconds();
+        for (long r = 0; r < rounds; r++)
+        {
+            for (int i = 0; i < POKEDEX_SIZE; i++)
+            {
+                for (int j = 0; j < POKEDEX_SIZE; j++)
+                {
+                    double first = battleScore(&pokedex[i], &pokedex[j], (BattleMode)mode);
+                    double second = battleScore(&pokedex[j], &pokedex[i], (BattleMode)mode);
+                    wins += (first > second);
+                }
+            }
+        }
+        double elapsed = nowSeconds() - start;
+        double battles = (double)rounds * POKEDEX_SIZE * POKEDEX_SIZE;
+        printf("%-8s %.0f battles in %.3fs: %.1f M battles/sec (first wins %.1f%%)\n", modeNames[mode], battles,
+               elapsed, battles / elapsed / 1e6, 100.0 * wins / battles);
+    }
+    return 0;
+}
+
+// --------------------------------------------------------------
+// Monte-Carlo simulation: the starters' final forms against
+// Nidoqueen, Nidoking and Alakazam (close to even in classic mode)
+// --------------------------------------------------------------
+
+static int benchSimulate(unsigned long long battles, int threads, unsigned long long seed, BattleMode mode)
+{
+    static const int firstIds[] = {3, 6, 9};
+    static const int secondIds[] = {31, 34, 65};
+    OwnerNode *first = createOwner("first", NULL);
+    OwnerNode *second = createOwner("second", NULL);
+    for (int i = 0; i < 3; i++)
+    {
+        pokedexAddPokemon(first, firstIds[i]);
+        pokedexAddPokemon(second, secondIds[i]);
+    }
+
+    printf("simulate: IDs 3,6,9 vs 31,34,65, %llu battles, %d threads, %s mode\n", battles, threads,
+           mode == BATTLE_TYPED ? "typed" : "classic");
+    SimulationResult result;
+    if (simulateRosterBattles(first, second, battles, threads, seed, mode, stdout, &result) != POKEDEX_OK)
+    {
+        fprintf(stderr, "simulation failed\n");
+        return 1;
+    }
+    printf("first %llu, second %llu, draws %llu in %.3fs: %.2f M simulations/sec\n", result.firstWins,
+           result.secondWins, result.draws, result.seconds, result.simulations / result.seconds / 1e6);
+
+    releaseOwner(first);
+    releaseOwner(second);
+    epochReclaimAll();
+    return 0;
+}
+
+// --------------------------------------------------------------
+// Optimal team matchup: full Pokedex against full Pokedex, and small
+// random rosters checked against trying every pairing
+// --------------------------------------------------------------
+
+#define MATCHUP_CHECK_MAX 7   // Roster size for the brute-force check (7! pairings)
+#define MATCHUP_CHECK_POOL 24 // Species drawn from; shared species tie, so ties are common
+
+// Steps perm to the next permutation in lexicographic order; 0 after the last one
+static int nextPermutation(int *perm, int n)
+{
+    int i = n - 2;
+    while (i >= 0 && perm[i] >= perm[i + 1])
+    {
+        i--;
+    }
+    if (i < 0)
+    {
+        return 0;
+    }
+    int j = n - 1;
+    while (perm[j] <= perm[i])
+    {
+        j--;
+    }
+    int t = perm[i];
+    perm[i] = perm[j];
+    perm[j] = t;
+    for (int a = i + 1, b = n - 1; a < b; a++, b--)
+    {
+        t = perm[a];
+        perm[a] = perm[b];
+        perm[b] = t;
+    }
+    return 1;
+}
+
+// Most wins, then most ties, over every pairing of the padded square
+static void bruteForceMatchup(const int *firstIds, int firstCount, const int *secondIds, int secondCount,
+                              BattleMode mode, int *bestWins, int *bestTies)
+{
+    int n = firstCount > secondCount ? firstCount : secondCount;
+    int perm[MATCHUP_CHECK_MAX];
+    for (int i = 0; i < n; i++)
+    {
+        perm[i] = i;
+    }
+    *bestWins = *bestTies = -1;
+    do
+    {
+        int wins = 0, ties = 0;
+        for (int i = 0; i < firstCount; i++)
+        {
+            if (perm[i] >= secondCount)
+            {
+                continue; // Paired with a dummy
+            }
+            const PokemonData *a = &pokedex[firstIds[i] - 1];
+            const PokemonData *b = &pokedex[secondIds[perm[i]] - 1];
+            double scoreA = battleScore(a, b, mode);
+            double scoreB = battleScore(b, a, mode);
+            wins += scoreA > scoreB;
+            ties += scoreA == scoreB;
+        }
+        if (wins > *bestWins || (wins == *bestWins && ties > *bestTies))
+        {
+            *bestWins = wins;
+            *bestTies = ties;
+        }
+    } while (nextPermutation(perm, n));
+}
+
+// Fills an unlinked owner with count distinct species from the check pool; ids receives them
+static OwnerNode *randomRoster(const char *name, int *ids, int count, unsigned long long *rng)
+{
+    OwnerNode *owner = createOwner((char *)name, NULL);
+    for (int k = 0; k < count;)
+    {
+        int id = (int)(nextRandom(rng) % MATCHUP_CHECK_POOL) + 1;
+        if (pokedexAddPokemon(owner, id) == POKEDEX_OK)
+        {
+            ids[k++] = id;
+        }
+    }
+    return owner;
+}
+
+static int benchMatchup(int rounds)
+{
+    static const char *modeNames[BATTLE_MODE_COUNT] = {"classic", "typed"};
+    OwnerNode *first = createOwner("first", NULL);
+    OwnerNode *second = createOwner("second", NULL);
+    for (int id = 1; id <= POKEDEX_SIZE; id++)
+    {
+        pokedexAddPokemon(first, id);
+        pokedexAddPokemon(second, id);
+    }
+
+    for (int mode = 0; mode < BATTLE_MODE_COUNT; mode++)
+    {
+        Matchup matchup = {0};
+        double start = nowSeconds();
+        for (int r = 0; r < rounds; r++)
+        {
+            freeMatchup(&matchup);
+            if (bestMatchup(first, second, (BattleMode)mode, &matchup) != POKEDEX_OK)
+            {
+                fprintf(stderr, "matchup failed\n");
+                return 1;
+            }
+        }
+        double elapsed = nowSeconds() - start;
+        printf("%-8s %d vs %d: %d wins, %d ties, %d losses; %.3f ms per assignment\n", modeNames[mode],
+               POKEDEX_SIZE, POKEDEX_SIZE, matchup.wins, matchup.ties, matchup.losses, elapsed * 1000.0 / rounds);
+        freeMatchup(&matchup);
+    }
+    releaseOwner(first);
+    releaseOwner(second);
+
+    // Small rosters of uneven sizes, both modes, against every possible pairing
+    unsigned long long rng = 0x5EEDULL;
+    int checks = 2000, mismatches = 0;
+    for (int c = 0; c < checks; c++)
+    {
+        int firstIds[MATCHUP_CHECK_MAX], secondIds[MATCHUP_CHECK_MAX];
+        int firstCount = 1 + (int)(nextRandom(&rng) % MATCHUP_CHECK_MAX);
+        int secondCount = 1 + (int)(nextRandom(&rng) % MATCHUP_CHECK_MAX);
+        BattleMode mode = (BattleMode)(c % BATTLE_MODE_COUNT);
+        OwnerNode *a = randomRoster("checkFirst", firstIds, firstCount, &rng);
+        OwnerNode *b = randomRoster("checkSecond", secondIds, secondCount, &rng);
+        int bestWins, bestTies;
+        bruteForceMatchup(firstIds, firstCount, secondIds, secondCount, mode, &bestWins, &bestTies);
+        Matchup matchup = {0};
+        int pairCount = firstCount < secondCount ? firstCount : secondCount;
+        if (bestMatchup(a, b, mode, &matchup) != POKEDEX_OK || matchup.count != pairCount ||
+            matchup.wins != bestWins || matchup.ties != bestTies)
+        {
+            mismatches++;
+        }
+        freeMatchup(&matchup);
+        releaseOwner(a);
+        releaseOwner(b);
+    }
+    printf("checked against brute force on %d random rosters of 1-%d: %d mismatches%s\n", checks,
+           MATCHUP_CHECK_MAX, mismatches, mismatches ? "  MISMATCH" : "");
+
+    epochReclaimAll();
+    return mismatches ? 1 : 0;
+}
+
+// --------------------------------------------------------------
+// Name completion: top-10 owners and species for random prefixes
+// --------------------------------------------------------------
+
+static int benchComplete(int ownerCount, long queries)
+{
+    static const char letters[] = "abcdefghijklmnopqrstuvwxyz";
+    unsigned long long rng = 0x5EEDULL;
+    char name[32];
+    for (int i = 0; i < ownerCount; i++)
+    {
+        for (int k = 0; k < 8; k++)
+        {
+            name[k] = letters[nextRandom(&rng) % 26];
+        }
+        snprintf(name + 8, sizeof(name) - 8, "%d", i);
+        linkOwnerInCircularList(createOwner(name, NULL));
+    }
+
+    OwnerNode *found[10];
+    long completions = 0;
+    double start = nowSeconds();
+    for (long q = 0; q < queries; q++)
+    {
+        char prefix[3] = {letters[nextRandom(&rng) % 26], letters[nextRandom(&rng) % 26]};
+        int n = completeOwnerNames(prefix, 1 + (size_t)(q & 1), found, 10);
+        for (int i = 0; i < n; i++)
+        {
+            releaseOwner(found[i]);
+        }
+        completions += n;
+    }
+    double ownerSeconds = nowSeconds() - start;
+
+    int ids[10];
+    long speciesCompletions = 0;
+    start = nowSeconds();
+    for (long q = 0; q < queries; q++)
+    {
+        char prefix[2] = {letters[nextRandom(&rng) % 26]};
+        speciesCompletions += completeSpeciesNames(prefix, 1 + (size_t)(q & 1), ids, 10);
+    }
+    double speciesSeconds = nowSeconds() - start;
+
+    printf("complete: %d owners, %ld queries of 1-2 letters, top 10\n", ownerCount, queries);
+    printf("  owners:  %.0f ns/query (%.1f completions avg)\n", ownerSeconds * 1e9 / queries,
+           (double)completions / queries);
+    printf("  species: %.0f ns/query (%.1f completions avg)\n", speciesSeconds * 1e9 / queries,
+           (double)speciesCompletions / queries);
+    freeAllOwners();
+    epochReclaimAll();
+    return 0;
+}
+
+// --------------------------------------------------------------
+// Sorted owners: ring sort and "A up to M" listings off the name index
+// --------------------------------------------------------------
+
+static int benchSorted(int ownerCount, int rounds)
+{
+    static const char letters[] = "abcdefghijklmnopqrstuvwxyz";
+    unsigned long long rng = 0x5EEDULL;
+    char name[32];
+    for (int i = 0; i < ownerCount; i++)
+    {
+        name[0] = (char)('A' + nextRandom(&rng) % 26);
+        for (int k = 1; k < 8; k++)
+        {
+            name[k] = letters[nextRandom(&rng) % 26];
+        }
+        snprintf(name + 8, sizeof(name) - 8, "%d", i);
+        linkOwnerInCircularList(createOwner(name, NULL));
+    }
+
+    double start = nowSeconds();
+    for (int r = 0; r < rounds; r++)
+    {
+        sortOwnerRing();
+    }
+    double sortSeconds = nowSeconds() - start;
+
+    OwnerNode **owners = (OwnerNode **)malloc((size_t)(ownerCount > 0 ? ownerCount : 1) * sizeof(OwnerNode *));
+    if (owners == NULL)
+    {
+        freeAllOwners();
+        return 1;
+    }
+    long listed = 0;
+    start = nowSeconds();
+    for (int r = 0; r < rounds; r++)
+    {
+        int n = listOwnersInRange("A", "N", owners, ownerCount);
+        for (int i = 0; i < n; i++)
+        {
+            releaseOwner(owners[i]);
+        }
+        listed += n;
+    }
+    double rangeSeconds = nowSeconds() - start;
+    free(owners);
+
+    printf("sorted: %d owners, %d rounds\n", ownerCount, rounds);
+    printf("  sortOwnerRing:            %.3f ms/round\n", sortSeconds * 1e3 / rounds);
+    printf("  listOwnersInRange(A, N):  %.3f ms/round (%ld owners avg)\n", rangeSeconds * 1e3 / rounds,
+           listed / rounds);
+    freeAllOwners();
+    epochReclaimAll();
+    return 0;
+}
+
+// --------------------------------------------------------------
+// Circular printing: "[k] name" lines to /dev/null, both directions
+// --------------------------------------------------------------
+
+static int benchCycle(int ownerCount, long long prints)
+{
+    FILE *sink = fopen("/dev/null", "w");
+    if (sink == NULL)
+    {
+        perror("/dev/null");
+        return 1;
+    }
+    makeOwners(ownerCount, 0, 0, NULL, NULL);
+
+    printf("cycle: %d owners, %lld prints\n", ownerCount, prints);
+    for (int forward = 1; forward >= 0; forward--)
+    {
+        double start = nowSeconds();
+        writeOwnerCycle(sink, forward, prints);
+        fflush(sink);
+        double seconds = nowSeconds() - start;
+        printf("  %s: %.2f M lines/sec (%.2f ns/line)\n", forward ? "F" : "B", prints / seconds / 1e6,
+               seconds * 1e9 / prints);
+    }
+    fclose(sink);
+    freeAllOwners();
+    epochReclaimAll();
+    return 0;
+}
+
+// --------------------------------------------------------------
+// Frozen Pokedexes: species lookups on the tree vs the Eytzinger copy
+// --------------------------------------------------------------
+
+static double timeLookups(OwnerNode **owners, int ownerCount, long lookups, long *hits)
+{
+    unsigned long long rng = 0xF00DULL;
+    long found = 0;
+    double start = nowSeconds();
+    for (long i = 0; i < lookups; i++)
+    {
+        unsigned long long r = nextRandom(&rng);
+        found += pokedexHasPokemon(owners[r % ownerCount], (int)((r >> 32) % POKEDEX_SIZE) + 1);
+    }
+    *hits = found;
+    return nowSeconds() - start;
+}
+
+static int benchFrozen(int ownerCount, long lookups)
+{
+    OwnerNode **owners = (OwnerNode **)malloc(sizeof(OwnerNode *) * ownerCount);
+    if (owners == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed.\n");
+        return 1;
+    }
+    // Half of all species each, added in random order (an unbalanced-ish tree, like real play)
+    unsigned long long rng = 0x5EEDULL;
+    makeOwners(ownerCount, POKEDEX_SIZE / 2, 0, &rng, owners);
+
+    int threshold = getFrozenDexThreshold();
+    long treeHits, frozenHits;
+    setFrozenDexThreshold(0);
+    double treeSeconds = timeLookups(owners, ownerCount, lookups, &treeHits);
+    setFrozenDexThreshold(threshold > 0 ? threshold : 16);
+    timeLookups(owners, ownerCount, lookups, &frozenHits); // Warm-up: freezes every owner
+    double frozenSeconds = timeLookups(owners, ownerCount, lookups, &frozenHits);
+    setFrozenDexThreshold(threshold);
+
+    printf("frozen: %d owners, %ld lookups (%ld hits)\n", ownerCount, lookups, treeHits);
+    printf("  tree:      %.1f ns/lookup\n", treeSeconds * 1e9 / lookups);
+    printf("  eytzinger: %.1f ns/lookup (%.2fx)%s\n", frozenSeconds * 1e9 / lookups, treeSeconds / frozenSeconds,
+           frozenHits == treeHits ? "" : "  MISMATCH");
+    free(owners);
+    freeAllOwners();
+    epochReclaimAll();
+    return frozenHits == treeHits ? 0 : 1;
+}
+
+// --------------------------------------------------------------
+// Species index: "who owns X" and "who owns X and Y" vs scanning every owner
+// --------------------------------------------------------------
+
+static int benchSpecies(int ownerCount, int queries)
+{
+    OwnerNode **found = (OwnerNode **)malloc(sizeof(OwnerNode *) * ownerCount);
+    if (found == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed.\n");
+        return 1;
+    }
+    unsigned long long rng = 0x5EEDULL;
+    // Collections of 1-30 species, so lists and intersections are selective
+    makeOwners(ownerCount, 30, 1, &rng, NULL);
+
+    long indexed[2] = {0, 0}, scanned[2] = {0, 0};
+    double indexSeconds[2] = {0, 0}, scanSeconds[2] = {0, 0};
+    for (int q = 0; q < queries; q++)
+    {
+        int ids[2] = {(int)(nextRandom(&rng) % POKEDEX_SIZE) + 1, (int)(nextRandom(&rng) % POKEDEX_SIZE) + 1};
+        for (int pair = 0; pair < 2; pair++)
+        {
+            double start = nowSeconds();
+            int n = ownersWithAllSpecies(ids, pair + 1, found, ownerCount);
+            indexSeconds[pair] += nowSeconds() - start;
+            for (int i = 0; i < n; i++)
+            {
+                releaseOwner(found[i]);
+            }
+            indexed[pair] += n;
+
+            start = nowSeconds();
+            epochEnter();
+            const OwnerRingView *view = currentRingView();
+            for (int i = 0; view != NULL && i < view->count; i++)
+            {
+                OwnerNode *owner = view->owners[i];
+                scanned[pair] += pokedexHasPokemon(owner, ids[0]) && (pair == 0 || pokedexHasPokemon(owner, ids[1]));
+            }
+            epochExit();
+            scanSeconds[pair] += nowSeconds() - start;
+        }
+    }
+
+    printf("species: %d owners, %d queries\n", ownerCount, queries);
+    for (int pair = 0; pair < 2; pair++)
+    {
+        printf("  %s: index %.2f us, scan %.2f us per query (%.1f owners avg)%s\n",
+               pair ? "X and Y" : "X      ", indexSeconds[pair] * 1e6 / queries, scanSeconds[pair] * 1e6 / queries,
+               (double)indexed[pair] / queries, indexed[pair] == scanned[pair] ? "" : "  MISMATCH");
+    }
+    free(found);
+    freeAllOwners();
+    epochReclaimAll();
+    return indexed[0] == scanned[0] && indexed[1] == scanned[1] ? 0 : 1;
+}
+
+// --------------------------------------------------------------
+// Collection similarity: top 10 owners most like a random owner
+// --------------------------------------------------------------
+
+static int benchSimilar(int ownerCount, int queries)
+{
+    OwnerNode **all = (OwnerNode **)malloc(sizeof(OwnerNode *) * ownerCount);
+    if (all == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed.\n");
+        return 1;
+    }
+    unsigned long long rng = 0x5EEDULL;
+    makeOwners(ownerCount, 60, 1, &rng, all);
+
+    static const char *metricNames[] = {"jaccard", "overlap"};
+    OwnerNode *top[10];
+    double scores[10];
+    printf("similar: %d owners, %d queries, top 10\n", ownerCount, queries);
+    for (int metric = SIMILARITY_JACCARD; metric <= SIMILARITY_OVERLAP; metric++)
+    {
+        double best = 0;
+        double start = nowSeconds();
+        for (int q = 0; q < queries; q++)
+        {
+            int n = mostSimilarOwners(all[nextRandom(&rng) % ownerCount], (SimilarityMetric)metric, top, scores, 10);
+            best += (n > 0) ? scores[0] : 0;
+            for (int i = 0; i < n; i++)
+            {
+                releaseOwner(top[i]);
+            }
+        }
+        double seconds = (nowSeconds() - start) / queries;
+        printf("  %s: %.3f ms/query (%.2f ns/owner, %.1f ms per million owners), best score %.2f avg\n",
+               metricNames[metric], seconds * 1e3, seconds * 1e9 / ownerCount, seconds * 1e9 / ownerCount,
+               best / queries);
+    }
+    free(all);
+    freeAllOwners();
+    epochReclaimAll();
+    return 0;
+}
+
+// --------------------------------------------------------------
+// Strength leaderboard: rank and top 10 from the running totals vs
+// recomputing every owner's strength from its tree
+// --------------------------------------------------------------
+
+static double treeStrength(const PokemonNode *node)
+{
+    if (node == NULL)
+    {
+        return 0;
+    }
+    return pokemonScore(pokemonNodeData(node)) + treeStrength(pokemonNodeLeft(node)) +
+           treeStrength(pokemonNodeRight(node));
+}
+
+// Rank by walking every tree: owners stronger, or as strong with a smaller name, go first
+static int recomputedRank(OwnerNode *target)
+{
+    epochEnter();
+    const OwnerRingView *view = currentRingView();
+    int count = (view != NULL) ? view->count : 0;
+    double *strengths = (double *)malloc(sizeof(double) * (count + 1));
+    int rank = 1;
+    for (int i = 0; strengths != NULL && i < count; i++)
+    {
+        lockOwnerRead(view->owners[i]);
+        // Totals in tenths, like the leaderboard, so ties compare exactly
+        strengths[i] = (double)(long long)(treeStrength(view->owners[i]->pokedexRoot) * 10 + 0.5);
+        unlockOwner(view->owners[i]);
+    }
+    lockOwnerRead(target);
+    double mine = (double)(long long)(treeStrength(target->pokedexRoot) * 10 + 0.5);
+    unlockOwner(target);
+    for (int i = 0; strengths != NULL && i < count; i++)
+    {
+        OwnerNode *owner = view->owners[i];
+        rank += strengths[i] > mine ||
+                (strengths[i] == mine && owner != target && strcmp(owner->ownerName, target->ownerName) < 0);
+    }
+    epochExit();
+    free(strengths);
+    return rank;
+}
+
+static int benchLeaderboard(int ownerCount, int queries)
+{
+    OwnerNode **all = (OwnerNode **)malloc(sizeof(OwnerNode *) * ownerCount);
+    if (all == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed.\n");
+        return 1;
+    }
+    unsigned long long rng = 0x5EEDULL;
+    makeOwners(ownerCount, 30, 1, &rng, all);
+
+    // Each update moves an owner on the board
+    double start = nowSeconds();
+    for (int q = 0; q < queries; q++)
+    {
+        OwnerNode *owner = all[nextRandom(&rng) % ownerCount];
+        int id = (int)(nextRandom(&rng) % POKEDEX_SIZE) + 1;
+        if (pokedexAddPokemon(owner, id) != POKEDEX_OK)
+        {
+            pokedexReleasePokemon(owner, id);
+        }
+    }
+    double updateSeconds = (nowSeconds() - start) / queries;
+
+    long rankSum = 0;
+    start = nowSeconds();
+    for (int q = 0; q < queries; q++)
+    {
+        rankSum += ownerStrengthRank(all[nextRandom(&rng) % ownerCount]);
+    }
+    double rankSeconds = (nowSeconds() - start) / queries;
+
+    OwnerNode *top[10];
+    double strengths[10];
+    start = nowSeconds();
+    for (int q = 0; q < queries; q++)
+    {
+        int n = strongestOwners(1 + (int)(nextRandom(&rng) % ownerCount), top, strengths, 10);
+        for (int i = 0; i < n; i++)
+        {
+            releaseOwner(top[i]);
+        }
+    }
+    double pageSeconds = (nowSeconds() - start) / queries;
+
+    // Recomputing walks every tree, so only a few of those
+    int recomputes = (queries < 20) ? queries : 20;
+    int mismatches = 0;
+    start = nowSeconds();
+    for (int q = 0; q < recomputes; q++)
+    {
+        OwnerNode *owner = all[nextRandom(&rng) % ownerCount];
+        mismatches += recomputedRank(owner) != ownerStrengthRank(owner);
+    }
+    double recomputeSeconds = (nowSeconds() - start) / recomputes;
+
+    int n = strongestOwners(1, top, strengths, 10);
+    printf("leaderboard: %d owners, %d queries\n", ownerCount, queries);
+    printf("  update (add or release): %.2f us\n", updateSeconds * 1e6);
+    printf("  rank: %.2f us (avg rank %.0f), recomputed: %.2f ms (%.0fx)%s\n", rankSeconds * 1e6,
+           (double)rankSum / queries, recomputeSeconds * 1e3, recomputeSeconds / rankSeconds,
+           mismatches ? "  MISMATCH" : "");
+    printf("  page of 10 at a random rank: %.2f us\n", pageSeconds * 1e6);
+    printf("  top:");
+    for (int i = 0; i < n; i++)
+    {
+        printf(" %s (%.1f)", top[i]->ownerName, strengths[i]);
+        releaseOwner(top[i]);
+    }
+    printf("\n");
+    free(all);
+    freeAllOwners();
+    epochReclaimAll();
+    return mismatches ? 1 : 0;
+}
+
+// --------------------------------------------------------------
+// Release and evolve on well-filled Pokedexes, counting every allocation they make
+// --------------------------------------------------------------
+
+static unsigned long long allocationsSoFar(void)
+{
+    unsigned long long total = 0;
+    for (int category = 0; category < MEM_CATEGORY_COUNT; category++)
+    {
+        total += memAllocationCount((MemCategory)category);
+    }
+    return total;
+}
+
+static int benchRelease(int ownerCount, int rounds)
+{
+    OwnerNode **owners = (OwnerNode **)malloc(sizeof(OwnerNode *) * ownerCount);
+    if (owners == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed.\n");
+        return 1;
+    }
+    unsigned long long rng = 0x5EEDULL;
+    // Random order, so the trees have plenty of two-child nodes
+    makeOwners(ownerCount, POKEDEX_SIZE, 0, &rng, owners);
+
+    long released = 0, evolved = 0;
+    unsigned long long releaseNodes = 0, releaseOther = 0, evolveNodes = 0, evolveOther = 0;
+    double releaseSeconds = 0, evolveSeconds = 0;
+    for (int round = 0; round < rounds; round++)
+    {
+        for (int i = 0; i < ownerCount; i++)
+        {
+            OwnerNode *owner = owners[i];
+            int id = (int)(nextRandom(&rng) % POKEDEX_SIZE) + 1;
+
+            // Only the release/evolve call itself is timed and counted
+            unsigned long long nodesBefore = memAllocationCount(MEM_POKEMON_NODES);
+            unsigned long long allBefore = allocationsSoFar();
+            double start = nowSeconds();
+            PokedexStatus status = pokedexReleasePokemon(owner, id);
+            releaseSeconds += nowSeconds() - start;
+            releaseNodes += memAllocationCount(MEM_POKEMON_NODES) - nodesBefore;
+            releaseOther += allocationsSoFar() - allBefore - (memAllocationCount(MEM_POKEMON_NODES) - nodesBefore);
+            released += status == POKEDEX_OK;
+            pokedexAddPokemon(owner, id);
+
+            // An evolvable species whose evolved form is made free first
+            if (pokedex[id - 1].CAN_EVOLVE == CANNOT_EVOLVE)
+            {
+                continue;
+            }
+            pokedexReleasePokemon(owner, id + 1);
+            nodesBefore = memAllocationCount(MEM_POKEMON_NODES);
+            allBefore = allocationsSoFar();
+            start = nowSeconds();
+            status = pokedexEvolvePokemon(owner, id);
+            evolveSeconds += nowSeconds() - start;
+            evolveNodes += memAllocationCount(MEM_POKEMON_NODES) - nodesBefore;
+            evolveOther += allocationsSoFar() - allBefore - (memAllocationCount(MEM_POKEMON_NODES) - nodesBefore);
+            evolved += status == POKEDEX_OK;
+            pokedexAddPokemon(owner, id);
+        }
+    }
+
+    printf("release: %d owners x %d rounds, Pokedexes from 151 random adds\n", ownerCount, rounds);
+    printf("  release: %ld ops, %.1f ns/op, %llu node allocations, %llu other allocations\n", released,
+           releaseSeconds * 1e9 / (released ? released : 1), releaseNodes, releaseOther);
+    printf("  evolve:  %ld ops, %.1f ns/op, %llu node allocations, %llu other allocations\n", evolved,
+           evolveSeconds * 1e9 / (evolved ? evolved : 1), evolveNodes, evolveOther);
+    free(owners);
+    freeAllOwners();
+    epochReclaimAll();
+    return (releaseNodes | releaseOther | evolveNodes | evolveOther) == 0 ? 0 : 1;
+}
+
+// --------------------------------------------------------------
+// Deleting owners: caller latency with background reclamation vs freeing
+// inline, and the exit fast path vs a full cleanup
+// --------------------------------------------------------------
+
+// Deletes every owner, head first, the way deletePokedex does
+static void timeDeletes(const char *label, int ownerCount)
+{
+    double total = 0, worst = 0;
+    for (int i = 0; i < ownerCount; i++)
+    {
+        OwnerNode *owner = acquireOwnerByNumber(1, 0);
+        double start = nowSeconds();
+        deleteOwnerFromList(owner);
+        releaseOwner(owner);
+        double seconds = nowSeconds() - start;
+        total += seconds;
+        worst = (seconds > worst) ? seconds : worst;
+    }
+    double start = nowSeconds();
+    epochReclaimAll();
+    printf("  %s: %.2f us/delete (worst %.1f us), then %.1f ms until everything is freed\n", label,
+           total * 1e6 / ownerCount, worst * 1e6, (nowSeconds() - start) * 1e3);
+}
+
+static int benchReclaim(int ownerCount)
+{
+    unsigned long long rng = 0x5EEDULL;
+    printf("reclaim: %d owners, Pokedexes from 151 random adds\n", ownerCount);
+
+    makeOwners(ownerCount, POKEDEX_SIZE, 0, &rng, NULL);
+    timeDeletes("background", ownerCount);
+
+    makeOwners(ownerCount, POKEDEX_SIZE, 0, &rng, NULL);
+    double start = nowSeconds();
+    freeAllOwners();
+    epochReclaimAll();
+    double cleanSeconds = nowSeconds() - start;
+
+    // From here on the releasing thread frees
+    shutdownOwnerReclaimer(0);
+    makeOwners(ownerCount, POKEDEX_SIZE, 0, &rng, NULL);
+    timeDeletes("inline    ", ownerCount);
+
+    makeOwners(ownerCount, POKEDEX_SIZE, 0, &rng, NULL);
+    start = nowSeconds();
+    shutdownOwnerReclaimer(1);
+    freeAllOwners();
+    epochReclaimAll();
+    double fastSeconds = nowSeconds() - start;
+    printf("  exit: full cleanup %.1f ms, fast path %.3f ms\n", cleanSeconds * 1e3, fastSeconds * 1e3);
+    return 0;
+}
+
+// --------------------------------------------------------------
+// Export: the streaming exporter vs one fprintf per Pokemon, to a file
+// and to /dev/null (formatting alone)
+// --------------------------------------------------------------
+
+static void writeRowPerFprintf(const PokemonNode *node, const char *owner, FILE *out)
+{
+    if (node == NULL)
+    {
+        return;
+    }
+    writeRowPerFprintf(pokemonNodeLeft(node), owner, out);
+    const PokemonData *data = pokemonNodeData(node);
+    fprintf(out, "%s,%d,%s,%s,%d,%d,%s\n", owner, data->id, data->name, getTypeName(data->TYPE), data->hp,
+            data->attack, data->CAN_EVOLVE == CAN_EVOLVE ? "Yes" : "No");
+    writeRowPerFprintf(pokemonNodeRight(node), owner, out);
+}
+
+// CSV only, no quoting (bench names never need it)
+static void exportPerFprintf(FILE *out)
+{
+    fputs("owner,id,name,type,hp,attack,can_evolve\n", out);
+    epochEnter();
+    const OwnerRingView *view = currentRingView();
+    for (int i = 0; view != NULL && i < view->count; i++)
+    {
+        lockOwnerRead(view->owners[i]);
+        writeRowPerFprintf(view->owners[i]->pokedexRoot, view->owners[i]->ownerName, out);
+        unlockOwner(view->owners[i]);
+    }
+    epochExit();
+}
+
+static int benchExport(int ownerCount, ExportFormat format)
+{
+    unsigned long long rng = 0x5EEDULL;
+    makeOwners(ownerCount, POKEDEX_SIZE, 1, &rng, NULL);
+    FILE *file = tmpfile();
+    FILE *devNull = fopen("/dev/null", "w");
+    if (file == NULL || devNull == NULL)
+    {
+        fprintf(stderr, "Could not open the output files.\n");
+        return 1;
+    }
+
+    double start = nowSeconds();
+    long long rows = exportOwners(file, format);
+    fflush(file);
+    double fileSeconds = nowSeconds() - start;
+    double megabytes = ftell(file) / 1e6;
+
+    start = nowSeconds();
+    long long nullRows = exportOwners(devNull, format);
+    double nullSeconds = nowSeconds() - start;
+
+    printf("export: %d owners, %lld Pokemon, %.1f MB of %s\n", ownerCount, rows, megabytes,
+           format == EXPORT_CSV ? "CSV" : "JSON Lines");
+    printf("  streaming, to a file:   %7.1f ms, %7.1f MB/s\n", fileSeconds * 1e3, megabytes / fileSeconds);
+    printf("  streaming, /dev/null:   %7.1f ms, %7.1f MB/s\n", nullSeconds * 1e3, megabytes / nullSeconds);
+    if (format == EXPORT_CSV)
+    {
+        start = nowSeconds();
+        exportPerFprintf(devNull);
+        fflush(devNull);
+        double fprintfSeconds = nowSeconds() - start;
+        printf("  fprintf per row, /dev/null: %.1f ms, %.1f MB/s\n", fprintfSeconds * 1e3, megabytes / fprintfSeconds);
+    }
+    fclose(file);
+    fclose(devNull);
+    freeAllOwners();
+    epochReclaimAll();
+    return (rows >= 0 && rows == nullRows) ? 0 : 1;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr, "usage: %s stress [owners] [opsPerThread] [maxThreads]\n", prog);
+    fprintf(stderr, "       %s ring [owners] [seconds] [readers]\n", prog);
+    fprintf(stderr, "       %s suite [owners] [ops] [seed] [seq|random] [mix]\n", prog);
+    fprintf(stderr, "         mix: op:weight,... over add, release, evolve, fight, bulk, merge, sort, find\n");
+    fprintf(stderr, "       %s battles [rounds]\n", prog);
+    fprintf(stderr, "       %s simulate [battles] [threads] [seed] [classic|typed]\n", prog);
+    fprintf(stderr, "       %s matchup [rounds]\n", prog);
+    fprintf(stderr, "       %s complete [owners] [queries]\n", prog);
+    fprintf(stderr, "       %s sorted [owners] [rounds]\n", prog);
+    fprintf(stderr, "       %s cycle [owners] [prints]\n", prog);
+    fprintf(stderr, "       %s frozen [owners] [lookups]\n", prog);
+    fprintf(stderr, "       %s species [owners] [queries]\n", prog);
+    fprintf(stderr, "       %s similar [owners] [queries]\n", prog);
+    fprintf(stderr, "       %s leaderboard [owners] [queries]\n", prog);
+    fprintf(stderr, "       %s release [owners] [rounds]\n", prog);
+    fprintf(stderr, "       %s reclaim [owners]\n", prog);
+    fprintf(stderr, "       %s export [owners] [csv|jsonl]\n", prog);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    if (strcmp(argv[1], "stress") == 0)
+    {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        int ownerCount = (argc > 2) ? atoi(argv[2]) : 256;
+        long opsPerThread = (argc > 3) ? atol(argv[3]) : 1000000;
+        int maxThreads = (argc > 4) ? atoi(argv[4]) : (int)(cores > 0 ? cores : 1);
+        if (ownerCount <= 0 || opsPerThread <= 0 || maxThreads <= 0)
+        {
+            usage(argv[0]);
+            return 1;
+        }
+        return benchStress(ownerCount, opsPerThread, maxThreads);
+    }
+
+    if (strcmp(argv[1], "ring") == 0)
+    {
+        int ownerCount = (argc > 2) ? atoi(argv[2]) : 1000;
+        double seconds = (argc > 3) ? atof(argv[3]) : 2.0;
+        int readers = (argc > 4) ? atoi(argv[4]) : 4;
+        if (ownerCount <= 0 || seconds <= 0 || readers <= 0)
+        {
+            usage(argv[0]);
+            return 1;
+        }
+        return benchRing(ownerCount, seconds, readers);
+    }
+
+    if (strcmp(argv[1], "suite") == 0)
+    {
+        int ownerCount = (argc > 2) ? atoi(argv[2]) : 1000;
+        long ops = (argc > 3) ? atol(argv[3]) : 1000000;
+        unsigned long long seed = (argc > 4) ? strtoull(argv[4], NULL, 10) : 42;
+        int sequential = (argc > 5) && strcmp(argv[5], "seq") == 0;
+        int weights[SUITE_OP_COUNT];
+        memcpy(weights, suiteDefaultMix, sizeof(weights));
+        if (ownerCount <= 0 || ops <= 0 || (argc > 5 && !sequential && strcmp(argv[5], "random") != 0) ||
+            (argc > 6 && !parseSuiteMix(argv[6], weights)))
+        {
+            usage(argv[0]);
+            return 1;
+        }
+        return benchSuite(ownerCount, ops, seed, sequential, weights);
+    }
+
+    if (strcmp(argv[1], "battles") == 0)
+    {
+        long rounds = (argc > 2) ? atol(argv[2]) : 200;
+        if (rounds <= 0)
+        {
+            usage(argv[0]);
+            return 1;
+        }
+        return benchBattles(rounds);
+    }
+
+    if (strcmp(argv[1], "simulate") == 0)
+    {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        unsigned long long battles = (argc > 2) ? strtoull(argv[2], NULL, 10) : 1000000;
+        int threads = (argc > 3) ? atoi(argv[3]) : (int)(cores > 0 ? cores : 1);
+        unsigned long long seed = (argc > 4) ? strtoull(argv[4], NULL, 10) : 42;
+        int typed = (argc > 5) && strcmp(argv[5], "typed") == 0;
+        if (battles == 0 || threads <= 0 || (argc > 5 && !typed && strcmp(argv[5], "classic") != 0))
+        {
+            usage(argv[0]);
+            return 1;
+        }
+        return benchSimulate(battles, threads, seed, typed ? BATTLE_TYPED : BATTLE_CLASSIC);
+    }
+
+    if (strcmp(argv[1], "matchup") == 0)
+    {
+        int rounds = (argc > 2) ? atoi(argv[2]) : 20;
+        if (rounds <= 0)
+        {
+            usage(argv[0]);
+            return 1;
+        }
+        return benchMatchup(rounds);
+    }
+
+    if (strcmp(argv[1], "complete") == 0)
+    {
+        int ownerCount = (argc > 2) ? atoi(argv[2]) : 20000;
+        long queries = (argc > 3) ? atol(argv[3]) : 1000000;
+        if (ownerCount < 0 || queries <= 0)
+        {
+            usage(argv[0]);
+            return 1;
+        }
+        return benchComplete(ownerCount, queries);
+    }
+
+    if (strcmp(argv[1], "sorted") == 0)
+    {
+        int ownerCount = (argc > 2) ? atoi(argv[2]) : 20000;
+        int rounds = (argc > 3) ? atoi(argv[3]) : 100;
+        if (ownerCount < 0 || rounds <= 0)
+        {
+            usage(argv[0]);
+            return 1;
+        }
+        return benchSorted(ownerCount, rounds);
+    }
+
+    if (strcmp(argv[1], "cycle") == 0)
+    {
+        int ownerCount = (argc > 2) ? atoi(argv[2]) : 1000;
+        long long prints = (argc > 3) ? strtoll(argv[3], NULL, 10) : 100000000;
+        if (ownerCount <= 0 || prints <= 0)
+        {
+            usage(argv[0]);
+            return 1;
+        }
+        return benchCycle(ownerCount, prints);
+    }
+
+    if (strcmp(argv[1], "frozen") == 0)
+    {
+        int ownerCount = (argc > 2) ? atoi(argv[2]) : 20000;
+        long lookups = (argc > 3) ? atol(argv[3]) : 10000000;
+        if (ownerCount <= 0 || lookups <= 0)
+        {
+            usage(argv[0]);
+            return 1;
+        }
+        return benchFrozen(ownerCount, lookups);
+    }
+
+    if (strcmp(argv[1], "species") == 0)
+    {
+        int ownerCount = (argc > 2) ? atoi(argv[2]) : 20000;
+        int queries = (argc > 3) ? atoi(argv[3]) : 1000;
+        if (ownerCount <= 0 || queries <= 0)
+        {
+            usage(argv[0]);
+            return 1;
+        }
+        return benchSpecies(ownerCount, queries);
+    }
+
+    if (strcmp(argv[1], "similar") == 0)
+    {
+        int ownerCount = (argc > 2) ? atoi(argv[2]) : 20000;
+        int queries = (argc > 3) ? atoi(argv[3]) : 1000;
+        if (ownerCount <= 0 || queries <= 0)
+        {
+            usage(argv[0]);
+            return 1;
+        }
+        return benchSimilar(ownerCount, queries);
+    }
+
+    if (strcmp(argv[1], "leaderboard") == 0)
+    {
+        int ownerCount = (argc > 2) ? atoi(argv[2]) : 20000;
+        int queries = (argc > 3) ? atoi(argv[3]) : 10000;
+        if (ownerCount <= 0 || queries <= 0)
+        {
+            usage(argv[0]);
+            return 1;
+        }
+        return benchLeaderboard(ownerCount, queries);
+    }
+
+    if (strcmp(argv[1], "release") == 0)
+    {
+        int ownerCount = (argc > 2) ? atoi(argv[2]) : 2000;
+        int rounds = (argc > 3) ? atoi(argv[3]) : 50;
+        if (ownerCount <= 0 || rounds <= 0)
+        {
+            usage(argv[0]);
+            return 1;
+        }
+        return benchRelease(ownerCount, rounds);
+    }
+
+    if (strcmp(argv[1], "reclaim") == 0)
+    {
+        int ownerCount = (argc > 2) ? atoi(argv[2]) : 5000;
+        if (ownerCount <= 0)
+        {
+            usage(argv[0]);
+            return 1;
+        }
+        return benchReclaim(ownerCount);
+    }
+
+    if (strcmp(argv[1], "export") == 0)
+    {
+        int ownerCount = (argc > 2) ? atoi(argv[2]) : 20000;
+        const char *format = (argc > 3) ? argv[3] : "csv";
+        if (ownerCount <= 0 || (strcmp(format, "csv") != 0 && strcmp(format, "jsonl") != 0))
+        {
+            usage(argv[0]);
+            return 1;
+        }
+        return benchExport(ownerCount, strcmp(format, "csv") == 0 ? EXPORT_CSV : EXPORT_JSON_LINES);
+    }
+
+    usage(argv[0]);
+    return 1;
+}
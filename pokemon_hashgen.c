@@ -0,0 +1,130 @@
+// ================================================
+// Species-name perfect hash generator
+// Writes pokemon_species_hash.h, the tables behind speciesIdBySlice.
+// Re-run whenever pokedex[] names change (a stale table only makes
+// lookups miss; it never returns a wrong species).
+//
+// Build and run (the game's main() is compiled out):
+//   gcc -O2 -pthread -DPOKEMON_NO_MAIN pokemon.c pokemon_hashgen.c -o pokemon_hashgen
+//   ./pokemon_hashgen > pokemon_species_hash.h
+// ================================================
+
+#include "pokemon.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define SLOTS 256  // Power of two, so "% SLOTS" on the xor keeps every slot reachable
+#define BUCKETS 64 // ~2.4 names per bucket
+
+static int bucketOf[POKEDEX_SIZE];
+static unsigned slotBits[POKEDEX_SIZE];
+
+// Bucket indices, largest bucket first (those are the hardest to place)
+static int bucketSizes[BUCKETS];
+static int compareBucketSize(const void *a, const void *b)
+{
+    return bucketSizes[*(const int *)b] - bucketSizes[*(const int *)a];
+}
+
+// Tries one seed; fills displacement/slots and returns 1 if every name got its own slot
+static int tryBuild(unsigned long long seed, unsigned char *displacement, unsigned char *slots)
+{
+    memset(bucketSizes, 0, sizeof(bucketSizes));
+    memset(slots, 0, SLOTS);
+    memset(displacement, 0, BUCKETS);
+    for (int i = 0; i < POKEDEX_SIZE; i++)
+    {
+        const char *name = pokedex[i].name;
+        unsigned long long h = speciesNameHash(name, strlen(name), seed);
+        bucketOf[i] = (int)(h % BUCKETS);
+        slotBits[i] = (unsigned)(h >> 32);
+        bucketSizes[bucketOf[i]]++;
+    }
+
+    int order[BUCKETS];
+    for (int b = 0; b < BUCKETS; b++)
+    {
+        order[b] = b;
+    }
+    qsort(order, BUCKETS, sizeof(int), compareBucketSize);
+
+    for (int k = 0; k < BUCKETS && bucketSizes[order[k]] > 0; k++)
+    {
+        int bucket = order[k];
+        int placed = 0;
+        for (unsigned d = 0; d < SLOTS && !placed; d++)
+        {
+            placed = 1;
+            for (int i = 0; i < POKEDEX_SIZE && placed; i++)
+            {
+                if (bucketOf[i] != bucket)
+                {
+                    continue;
+                }
+                unsigned slot = (slotBits[i] ^ d) % SLOTS;
+                if (slots[slot] != 0)
+                {
+                    placed = 0;
+                }
+                else
+                {
+                    slots[slot] = (unsigned char)(i + 1);
+                }
+            }
+            if (!placed)
+            {
+                // Undo this bucket's partial placement before the next displacement
+                for (int s = 0; s < SLOTS; s++)
+                {
+                    if (slots[s] != 0 && bucketOf[slots[s] - 1] == bucket)
+                    {
+                        slots[s] = 0;
+                    }
+                }
+            }
+            else
+            {
+                displacement[bucket] = (unsigned char)d;
+            }
+        }
+        if (!placed)
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int main(void)
+{
+    unsigned char displacement[BUCKETS];
+    unsigned char slots[SLOTS];
+    unsigned long long seed = 1;
+    while (!tryBuild(seed, displacement, slots))
+    {
+        seed++;
+    }
+
+    printf("// Generated by pokemon_hashgen.c -- do not edit.\n");
+    printf("// Perfect hash over the %d pokedex[] names (see speciesIdBySlice).\n\n", POKEDEX_SIZE);
+    printf("#ifndef POKEMON_SPECIES_HASH_H\n#define POKEMON_SPECIES_HASH_H\n\n");
+    printf("#define SPECIES_HASH_SEED %lluULL\n", seed);
+    printf("#define SPECIES_HASH_BUCKETS %d\n", BUCKETS);
+    printf("#define SPECIES_HASH_SLOTS %d\n\n", SLOTS);
+    printf("// Per bucket: xor applied to the slot bits of its names\n");
+    printf("static const unsigned char speciesHashDisplacement[SPECIES_HASH_BUCKETS] = {");
+    for (int b = 0; b < BUCKETS; b++)
+    {
+        printf("%s%3d,", (b % 16 == 0) ? "\n    " : " ", displacement[b]);
+    }
+    printf("\n};\n\n");
+    printf("// Per slot: species ID, 0 if empty\n");
+    printf("static const unsigned char speciesHashSlots[SPECIES_HASH_SLOTS] = {");
+    for (int s = 0; s < SLOTS; s++)
+    {
+        printf("%s%3d,", (s % 16 == 0) ? "\n    " : " ", slots[s] == 0 ? 0 : pokedex[slots[s] - 1].id);
+    }
+    printf("\n};\n\n#endif\n");
+    fprintf(stderr, "seed %llu: %d names in %d slots, %d buckets\n", seed, POKEDEX_SIZE, SLOTS, BUCKETS);
+    return 0;
+}
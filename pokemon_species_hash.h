@@ -0,0 +1,39 @@
+// Generated by pokemon_hashgen.c -- do not edit.
+// Perfect hash over the 151 pokedex[] names (see speciesIdBySlice).
+
+#ifndef POKEMON_SPECIES_HASH_H
+#define POKEMON_SPECIES_HASH_H
+
+#define SPECIES_HASH_SEED 1ULL
+#define SPECIES_HASH_BUCKETS 64
+#define SPECIES_HASH_SLOTS 256
+
+// Per bucket: xor applied to the slot bits of its names
+static const unsigned char speciesHashDisplacement[SPECIES_HASH_BUCKETS] = {
+      3,   0,   0,   1,   0,   5,   0,   4,   0,   0,   0,   0,   2,   1,   0,   1,
+      0,   0,   2,   0,   0,   0,   0,   1,   0,   0,   0,   0,   5,   3,   0,   1,
+      1,   0,   0,   1,   4,   2,   5,   2,   2,   0,   0,   0,   7,   0,   1,   0,
+      0,   0,   0,   4,   0,  32,   1,   0,   5,   1,   3,   1,   0,   3,  16,   4,
+};
+
+// Per slot: species ID, 0 if empty
+static const unsigned char speciesHashSlots[SPECIES_HASH_SLOTS] = {
+      0, 145,   0,  52,  32, 104,  74,  49,   0,  15,   0,  27, 125,  45,  43,   7,
+      0,  90,   0,   0,   0, 150,  39,  38,   0,  95,  79,  82, 119,   0,   0,   0,
+      0,   0, 127, 137,   0, 138,   0,   0, 112,  22, 129,  64,   0,   0, 143,   0,
+    124, 121,  50, 148, 126, 132,   6,   0, 105, 115, 110,   0,   0,   0,  59,  58,
+     78,   0,  21,   0,   0,   0,  71,   0,  85, 101,  70,   0,   0,   0,   5, 136,
+     51,   0, 149,  72,  60,   1,   0,   0,  33,   0,  57,   0,   0,  20, 118,   0,
+     63,  98, 109,   0,   9,  80,   0,   0,  89,   0,   0,   0,   0,   0,   0, 128,
+     55,  46,   0,   0,   0,   0,   0,  44,  88, 141,  96,   0,  29, 102,  87,  28,
+      0,  40,  56,   0,  91,  84,  81,   0,  30,   0,   0,   0, 140,  62,   0,  83,
+     36,   0,  19,   0,   0, 114,   0,   0, 108, 116,   0,  25,   0,  26,   0,  12,
+      0,   0,  99,   0,  73, 106,  48,   0, 100,   0, 120,   0, 133, 122, 146,  75,
+    151,  93,   0,   0,  77,   0,   0,   0,   0, 103,   0,   0,   0,   0, 117, 107,
+     37,  17,  42,   0, 139,  94,  23,   3,   0, 131, 135,   8,   0,   0,   4,   0,
+      2,   0, 134, 144,  92,   0,   0,   0,   0,   0,  14,  10, 111,  16,  66, 147,
+     47,  97,  68,  31,  61,  54,  41,  67, 113,   0,  65,   0,  11,  18,  34,   0,
+     76,  24,   0,   0, 123,  86,   0,   0,  69,  13, 130,  53,   0, 142,  35,   0,
+};
+
+#endif